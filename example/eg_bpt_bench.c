@@ -0,0 +1,235 @@
+/**
+ * @file eg_bpt_bench.c
+ * @brief Portable Abstracted Linked Lists Library (libpall)
+ *        B+ Tree versus Binary Search Tree benchmark
+ *
+ * Date: 16-10-2026
+ *
+ * Copyright 2026 Pedro A. Hortas (pah@ucodev.org)
+ *
+ * This file is part of libpall.
+ *
+ * libpall is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libpall is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libpall.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+
+#include "bst.h"
+#include "bpt.h"
+
+#define BENCH_ELEMS	1000000	/* Default element count, see main() */
+#define BENCH_RANGES	10000
+#define BENCH_RANGE_LEN	100
+
+struct elem {
+	unsigned long id;
+};
+
+static struct elem *elems = NULL;
+static struct elem **order = NULL;
+static unsigned long nelems = BENCH_ELEMS;
+
+/**
+ * compare
+ */
+int compare(const void *d1, const void *d2) {
+	const struct elem *pd1 = (struct elem *) d1, *pd2 = (struct elem *) d2;
+
+	if (pd1->id > pd2->id)
+		return 1;
+
+	if (pd1->id < pd2->id)
+		return -1;
+
+	return 0;
+}
+
+/**
+ * destroy
+ */
+void destroy(void *data) {
+	/* Elements are allocated as a single array */
+}
+
+static unsigned long lcg(void) {
+	static unsigned long state = 1;
+
+	state = (state * 1103515245UL + 12345UL) & 0x7fffffffUL;
+
+	return state;
+}
+
+static double elapsed(clock_t start) {
+	return (double) (clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+static int bench_bst(void) {
+	unsigned long i = 0;
+	clock_t start;
+	struct bst_handler *hb = NULL;
+	struct elem lo, hi;
+
+	if (!(hb = pall_bst_init(&compare, &destroy, NULL, NULL))) {
+		fprintf(stderr, "pall_bst_init() error: %s\n", strerror(errno));
+		return -1;
+	}
+
+	start = clock();
+
+	for (i = 0; i < nelems; i ++)
+		hb->insert(hb, order[i]);
+
+	printf("BST insert: %10.2f ms\n", elapsed(start));
+
+	start = clock();
+
+	for (i = 0; i < nelems; i ++)
+		hb->search(hb, order[i]);
+
+	printf("BST search: %10.2f ms\n", elapsed(start));
+
+	start = clock();
+
+	for (hb->rewind(hb, 0); hb->iterate(hb); );
+
+	printf("BST scan:   %10.2f ms\n", elapsed(start));
+
+	start = clock();
+
+	for (i = 0; i < BENCH_RANGES; i ++) {
+		lo.id = order[i % nelems]->id;
+		hi.id = lo.id + BENCH_RANGE_LEN * 64;
+
+		for (hb->range(hb, &lo, &hi); hb->iterate(hb); );
+	}
+
+	printf("BST range:  %10.2f ms\n", elapsed(start));
+
+	start = clock();
+
+	for (i = 0; i < nelems; i ++)
+		hb->del(hb, order[i]);
+
+	printf("BST delete: %10.2f ms\n", elapsed(start));
+
+	pall_bst_destroy(hb);
+
+	return 0;
+}
+
+static int bench_bpt(void) {
+	unsigned long i = 0;
+	clock_t start;
+	struct bpt_handler *hp = NULL;
+	struct bpt_stat *stat = NULL;
+	struct elem lo, hi;
+
+	if (!(hp = pall_bpt_init(&compare, &destroy, NULL, NULL))) {
+		fprintf(stderr, "pall_bpt_init() error: %s\n", strerror(errno));
+		return -1;
+	}
+
+	start = clock();
+
+	for (i = 0; i < nelems; i ++)
+		hp->insert(hp, order[i]);
+
+	printf("BPT insert: %10.2f ms\n", elapsed(start));
+
+	start = clock();
+
+	for (i = 0; i < nelems; i ++)
+		hp->search(hp, order[i]);
+
+	printf("BPT search: %10.2f ms\n", elapsed(start));
+
+	start = clock();
+
+	for (hp->rewind(hp, 0); hp->iterate(hp); );
+
+	printf("BPT scan:   %10.2f ms\n", elapsed(start));
+
+	start = clock();
+
+	for (i = 0; i < BENCH_RANGES; i ++) {
+		lo.id = order[i % nelems]->id;
+		hi.id = lo.id + BENCH_RANGE_LEN * 64;
+
+		for (hp->range(hp, &lo, &hi); hp->iterate(hp); );
+	}
+
+	printf("BPT range:  %10.2f ms\n", elapsed(start));
+
+	stat = hp->stat(hp);
+
+	printf("BPT height: %lu, nodes: %lu\n", stat->height, stat->node_count);
+
+	start = clock();
+
+	for (i = 0; i < nelems; i ++)
+		hp->del(hp, order[i]);
+
+	printf("BPT delete: %10.2f ms\n", elapsed(start));
+
+	pall_bpt_destroy(hp);
+
+	return 0;
+}
+
+int main(int argc, char *argv[]) {
+	unsigned long i = 0, j = 0;
+	struct elem *tmp = NULL;
+
+	/* The element count may be given as the first argument */
+	if ((argc > 1) && !(nelems = strtoul(argv[1], NULL, 10))) {
+		fprintf(stderr, "Usage: %s [element count]\n", argv[0]);
+		return 1;
+	}
+
+	if (!(elems = malloc(nelems * sizeof(struct elem))) || !(order = malloc(nelems * sizeof(struct elem *)))) {
+		fprintf(stderr, "malloc() failed: %s\n", strerror(errno));
+		return 1;
+	}
+
+	/* Random keys, spaced so that ranges cover about BENCH_RANGE_LEN
+	 * elements, inserted and looked up in random order.
+	 */
+	for (i = 0; i < nelems; i ++) {
+		elems[i].id = ((lcg() << 31) | lcg()) % (nelems * 64);
+		order[i] = &elems[i];
+	}
+
+	for (i = nelems - 1; i > 0; i --) {
+		j = lcg() % (i + 1);
+		tmp = order[i];
+		order[i] = order[j];
+		order[j] = tmp;
+	}
+
+	printf("%lu elements, %d ranges of about %d elements\n", nelems, BENCH_RANGES, BENCH_RANGE_LEN);
+
+	if (bench_bst() < 0 || bench_bpt() < 0)
+		return 1;
+
+	free(order);
+	free(elems);
+
+	return 0;
+}
+
@@ -75,7 +75,8 @@ int main(void) {
 	strcpy(e1->buf, "CLL Example");
 
 	/* Initialize handler
-	 * Default configuration is (CONFIG_SEARCH_LRU | CONFIG_INSERT_HEAD)
+	 * Default configuration is
+	 * (CONFIG_SEARCH_LRU | CONFIG_INSERT_HEAD | CONFIG_MM_POOL)
 	 */
 	if (!(hc = pall_cll_init(&compare, &destroy, NULL, NULL))) {
 		fprintf(stderr, "pall_cll_init() error: %s\n", strerror(errno));
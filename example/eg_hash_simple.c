@@ -0,0 +1,102 @@
+/**
+ * @file eg_hash_simple.c
+ * @brief Portable Abstracted Linked Lists Library (libpall)
+ *        Hash Functions Simple Example
+ *
+ * Date: 16-10-2026
+ *
+ * Copyright 2026 Pedro A. Hortas (pah@ucodev.org)
+ *
+ * This file is part of libpall.
+ *
+ * libpall is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libpall is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libpall.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#include "hash.h"
+#include "hmbt_cll.h"
+
+struct elem {
+	unsigned long id;
+	char name[24];
+};
+
+/**
+ * compare
+ */
+int compare(const void *d1, const void *d2) {
+	return strcmp(((struct elem *) d1)->name, ((struct elem *) d2)->name);
+}
+
+/**
+ * destroy
+ */
+void destroy(void *data) {
+	free(data);
+}
+
+/**
+ * hash
+ *   Defines a function named hash_name(), hashing the 'name' string of each
+ *   element, that can be directly passed to pall_hmbt_cll_init().
+ */
+PALL_HASH_DEFINE_STR(hash_name, struct elem, name)
+
+int main(void) {
+	int i = 0;
+	struct elem *e = NULL, key;
+	struct hmbt_cll_handler *hh = NULL;
+	const char *names[] = { "alpha", "bravo", "charlie", "delta", "echo" };
+
+	/* Initialize handler with the hash function defined above */
+	if (!(hh = pall_hmbt_cll_init(&compare, &destroy, &hash_name, NULL, NULL, 0))) {
+		fprintf(stderr, "pall_hmbt_cll_init() error: %s\n", strerror(errno));
+		return 1;
+	}
+
+	/* Insert elements */
+	for (i = 0; i < 5; i ++) {
+		if (!(e = malloc(sizeof(struct elem)))) {
+			fprintf(stderr, "malloc() failed: %s\n", strerror(errno));
+			return 1;
+		}
+
+		e->id = i;
+		strcpy(e->name, names[i]);
+
+		hh->insert(hh, e);
+	}
+
+	/* Search for an element by name */
+	strcpy(key.name, "delta");
+
+	if ((e = hh->search(hh, &key)))
+		printf("Item found:\n * id: %lu, name: %s, hash: 0x%.8x\n", e->id, e->name, pall_hash_str(e->name, 0));
+	else
+		fprintf(stderr, "Item not found.\n");
+
+	/* The hash functions can also be called directly */
+	printf("CRC32C of \"123456789\": 0x%.8x\n", pall_hash_crc32c("123456789", 9, 0));
+
+	/* Destroy handler */
+	pall_hmbt_cll_destroy(hh);
+
+	return 0;
+}
+
@@ -82,7 +82,8 @@ int main(void) {
 	strcpy(e1->buf, "HMBT-CLL Example");
 
 	/* Initialize handler
-	 * Default configuration is (CONFIG_SEARCH_LRU | CONFIG_INSERT_HEAD)
+	 * Default configuration is
+	 * (CONFIG_SEARCH_LRU | CONFIG_INSERT_HEAD | CONFIG_MM_POOL)
 	 */
 	if (!(hhc = pall_hmbt_cll_init(&compare, &destroy, &hash, NULL, NULL, 11))) {
 		fprintf(stderr, "pall_hmbt_init() error: %s\n", strerror(errno));
@@ -0,0 +1,157 @@
+/**
+ * @file eg_hmbt-cll_resize.c
+ * @brief Portable Abstracted Linked Lists Library (libpall)
+ *        Hash Mod Balanced Tree Circular Linked List Resize Example
+ *
+ * Date: 16-10-2026
+ *
+ * Copyright 2026 Pedro A. Hortas (pah@ucodev.org)
+ *
+ * This file is part of libpall.
+ *
+ * libpall is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libpall is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libpall.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#include "hmbt_cll.h"
+
+#define ARR_SIZE	8
+#define LOAD_MAX	2.0f
+#define ELEM_COUNT	1000
+
+struct elem {
+	unsigned long id;
+};
+
+/**
+ * compare
+ */
+int compare(const void *d1, const void *d2) {
+	const struct elem *pd1 = (struct elem *) d1, *pd2 = (struct elem *) d2;
+
+	if (pd1->id > pd2->id)
+		return 1;
+
+	if (pd1->id < pd2->id)
+		return -1;
+
+	return 0;
+}
+
+/**
+ * destroy
+ */
+void destroy(void *data) {
+	free(data);
+}
+
+/**
+ * hash
+ */
+uint32_t hash(void *data) {
+	return ((struct elem *) data)->id;
+}
+
+static int insert(struct hmbt_cll_handler *hhc, unsigned long id) {
+	struct elem *e = NULL;
+
+	if (!(e = malloc(sizeof(struct elem)))) {
+		fprintf(stderr, "malloc() failed: %s\n", strerror(errno));
+		return -1;
+	}
+
+	e->id = id;
+
+	if (hhc->insert(hhc, e) < 0) {
+		fprintf(stderr, "insert() failed: %s\n", strerror(errno));
+		free(e);
+		return -1;
+	}
+
+	return 0;
+}
+
+int main(void) {
+	unsigned long i = 0, n = 0;
+	struct elem *ptr = NULL;
+	struct hmbt_cll_handler *hhc = NULL;
+
+	if (!(hhc = pall_hmbt_cll_init(&compare, &destroy, &hash, NULL, NULL, ARR_SIZE))) {
+		fprintf(stderr, "pall_hmbt_cll_init() error: %s\n", strerror(errno));
+		return 1;
+	}
+
+	/* Split buckets once there are more than LOAD_MAX elements per bucket */
+	if (hhc->set_load_factor(hhc, LOAD_MAX, 0) < 0) {
+		fprintf(stderr, "set_load_factor() error: %s\n", strerror(errno));
+		return 1;
+	}
+
+	for (i = 0; i < (ARR_SIZE * LOAD_MAX); i ++) {
+		if (insert(hhc, i) < 0)
+			return 1;
+	}
+
+	/* Look up the first element with an odd id, leaving the iteration
+	 * unfinished.
+	 */
+	for (hhc->rewind(hhc, 0); (ptr = hhc->iterate(hhc)); ) {
+		if (ptr->id & 1)
+			break;
+	}
+
+	printf("Abandoned an iteration at id %lu, array size %u\n", ptr->id, hhc->arr_size);
+
+	/* The array keeps growing with the element count */
+	for (; i < ELEM_COUNT; i ++) {
+		if (insert(hhc, i) < 0)
+			return 1;
+	}
+
+	printf("Inserted %lu elements, array size %u\n", i, hhc->arr_size);
+
+	if (hhc->count(hhc) > (LOAD_MAX * hhc->arr_size)) {
+		fprintf(stderr, "Array size %u is too small for %u elements\n", hhc->arr_size, hhc->count(hhc));
+		return 1;
+	}
+
+	/* Inserting while iterating splits buckets the iteration already went
+	 * through, which ends it.
+	 */
+	for (hhc->rewind(hhc, 0), n = 0; ; n ++) {
+		errno = 0;
+
+		if (!(ptr = hhc->iterate(hhc)))
+			break;
+
+		if (insert(hhc, i ++) < 0)
+			return 1;
+	}
+
+	if (errno == ECANCELED) {
+		printf("Iteration ended by a resize after %lu elements\n", n);
+	} else {
+		printf("Iterated through %lu elements\n", n);
+	}
+
+	pall_hmbt_cll_destroy(hhc);
+
+	return 0;
+}
+
@@ -0,0 +1,184 @@
+/**
+ * @file eg_hmbt_bench.c
+ * @brief Portable Abstracted Linked Lists Library (libpall)
+ *        Hash Mod Balanced Tree index selection benchmark
+ *
+ * Date: 16-10-2026
+ *
+ * Copyright 2026 Pedro A. Hortas (pah@ucodev.org)
+ *
+ * This file is part of libpall.
+ *
+ * libpall is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libpall is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libpall.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+
+#include "hmbt_cll.h"
+#include "hmbt_bst.h"
+
+#define BENCH_ELEMS	100000
+#define BENCH_ROUNDS	4
+#define BENCH_ARR_SIZE	65521	/* Prime, rounded up to 65536 on mask mode */
+
+struct elem {
+	unsigned long id;
+};
+
+static struct elem elems[BENCH_ELEMS];
+static struct elem *order[BENCH_ELEMS];
+
+/**
+ * compare
+ */
+int compare(const void *d1, const void *d2) {
+	const struct elem *pd1 = (struct elem *) d1, *pd2 = (struct elem *) d2;
+
+	if (pd1->id > pd2->id)
+		return 1;
+
+	if (pd1->id < pd2->id)
+		return -1;
+
+	return 0;
+}
+
+/**
+ * destroy
+ */
+void destroy(void *data) {
+	/* Elements are statically allocated */
+}
+
+/**
+ * hash
+ *   A weak identity hash. Keys are multiples of 64, so their low bits are
+ *   always zero, which is harmless for a prime modulo but would collapse a
+ *   plain mask into 1/64 of the buckets.
+ */
+uint32_t hash(void *data) {
+	return ((struct elem *) data)->id;
+}
+
+static unsigned long lcg(void) {
+	static unsigned long state = 1;
+
+	state = (state * 1103515245UL + 12345UL) & 0x7fffffffUL;
+
+	return state;
+}
+
+static double elapsed(clock_t start) {
+	return (double) (clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+static int bench_hmbt_cll(ui32_t flags) {
+	int i = 0, r = 0;
+	clock_t start;
+	struct hmbt_cll_handler *hhc = NULL;
+
+	if (!(hhc = pall_hmbt_cll_init(&compare, &destroy, &hash, NULL, NULL, BENCH_ARR_SIZE))) {
+		fprintf(stderr, "pall_hmbt_cll_init() error: %s\n", strerror(errno));
+		return -1;
+	}
+
+	hhc->set_config(hhc, hhc->get_config(hhc) | flags);
+
+	start = clock();
+
+	for (r = 0; r < BENCH_ROUNDS; r ++) {
+		for (i = 0; i < BENCH_ELEMS; i ++)
+			hhc->insert(hhc, order[i]);
+
+		for (i = 0; i < BENCH_ELEMS; i ++)
+			hhc->search(hhc, order[i]);
+
+		for (i = 0; i < BENCH_ELEMS; i ++)
+			hhc->del(hhc, order[i]);
+	}
+
+	printf("HMBT-CLL %-6s (arr_size: %5u): %8.2f ms\n", (flags & CONFIG_HASH_MASK) ? "mask" : "modulo", hhc->arr_size, elapsed(start));
+
+	pall_hmbt_cll_destroy(hhc);
+
+	return 0;
+}
+
+static int bench_hmbt_bst(ui32_t flags) {
+	int i = 0, r = 0;
+	clock_t start;
+	struct hmbt_bst_handler *hhb = NULL;
+
+	if (!(hhb = pall_hmbt_bst_init(&compare, &destroy, &hash, NULL, NULL, BENCH_ARR_SIZE))) {
+		fprintf(stderr, "pall_hmbt_bst_init() error: %s\n", strerror(errno));
+		return -1;
+	}
+
+	hhb->set_config(hhb, hhb->get_config(hhb) | flags);
+
+	start = clock();
+
+	for (r = 0; r < BENCH_ROUNDS; r ++) {
+		for (i = 0; i < BENCH_ELEMS; i ++)
+			hhb->insert(hhb, order[i]);
+
+		for (i = 0; i < BENCH_ELEMS; i ++)
+			hhb->search(hhb, order[i]);
+
+		for (i = 0; i < BENCH_ELEMS; i ++)
+			hhb->del(hhb, order[i]);
+	}
+
+	printf("HMBT-BST %-6s (arr_size: %5u): %8.2f ms\n", (flags & CONFIG_HASH_MASK) ? "mask" : "modulo", hhb->arr_size, elapsed(start));
+
+	pall_hmbt_bst_destroy(hhb);
+
+	return 0;
+}
+
+int main(void) {
+	int i = 0, j = 0;
+	struct elem *tmp = NULL;
+
+	/* Random keys, accessed in random order, so that neither memory locality
+	 * nor a regular key pattern favours one of the index selection modes.
+	 */
+	for (i = 0; i < BENCH_ELEMS; i ++) {
+		elems[i].id = (lcg() << 6) & 0xffffffffUL;
+		order[i] = &elems[i];
+	}
+
+	for (i = BENCH_ELEMS - 1; i > 0; i --) {
+		j = lcg() % (i + 1);
+		tmp = order[i];
+		order[i] = order[j];
+		order[j] = tmp;
+	}
+
+	printf("%d elements, %d rounds of insert, search and delete\n", BENCH_ELEMS, BENCH_ROUNDS);
+
+	if (bench_hmbt_cll(0) < 0 || bench_hmbt_cll(CONFIG_HASH_MASK) < 0)
+		return 1;
+
+	if (bench_hmbt_bst(0) < 0 || bench_hmbt_bst(CONFIG_HASH_MASK) < 0)
+		return 1;
+
+	return 0;
+}
+
@@ -0,0 +1,98 @@
+/**
+ * @file avl.h
+ * @brief Portable Abstracted Linked Lists Library (libpall)
+ *        AVL Tree interface header
+ *
+ * Date: 16-10-2026
+ *
+ * Copyright 2026 Pedro A. Hortas (pah@ucodev.org)
+ *
+ * This file is part of libpall.
+ *
+ * libpall is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libpall is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libpall.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef LIBPALL_AVL_H
+#define LIBPALL_AVL_H
+
+#include "config.h"
+#include "pall.h"
+
+/* Structures */
+
+/**
+ * @struct avl_node
+ *
+ * @brief
+ *   Intrusive AVL tree node. It is embedded as the first member of the
+ *   structures indexed by the tree, which own its memory. Nodes are linked
+ *   and unlinked by the avl_*() functions and shall not be directly modified.
+ *
+ * @var avl_node::left
+ *   The left child, or NULL.
+ *
+ * @var avl_node::right
+ *   The right child, or NULL.
+ *
+ * @var avl_node::parent
+ *   The parent node, or NULL for the root node.
+ *
+ * @var avl_node::height
+ *   The height of the subtree rooted at this node. Leaves have height 1.
+ *
+ * @var avl_node::size
+ *   The number of nodes of the subtree rooted at this node, including itself.
+ */
+struct avl_node {
+	struct avl_node *left;
+	struct avl_node *right;
+	struct avl_node *parent;
+	int height;
+	ui32_t size;
+};
+
+/* Internal interface */
+
+/*
+ * All the lookup and insertion functions order the tree through 'cmp', which
+ * compares 'key' against the element holding 'node' and returns an integer
+ * less than, equal to, or greater than zero. 'arg' is passed through to 'cmp'
+ * untouched. Equal keys are allowed: new nodes are placed after the existing
+ * equal nodes.
+ */
+typedef int (*avl_cmp_t) (const void *key, const struct avl_node *node, void *arg);
+
+void avl_insert(struct avl_node **root, struct avl_node *node, const void *key, avl_cmp_t cmp, void *arg);
+void avl_remove(struct avl_node **root, struct avl_node *node);
+/* Returns any node matching 'key', or NULL */
+struct avl_node *avl_find(struct avl_node *root, const void *key, avl_cmp_t cmp, void *arg);
+/* Returns the first node not lower than 'key', or NULL */
+struct avl_node *avl_lower_bound(struct avl_node *root, const void *key, avl_cmp_t cmp, void *arg);
+/* Returns the first node greater than 'key', or NULL */
+struct avl_node *avl_upper_bound(struct avl_node *root, const void *key, avl_cmp_t cmp, void *arg);
+/* Returns the node at zero based position 'k' in order, or NULL */
+struct avl_node *avl_select(struct avl_node *root, ui32_t k);
+/* Returns the number of nodes lower than 'key' */
+ui32_t avl_count_lower(struct avl_node *root, const void *key, avl_cmp_t cmp, void *arg);
+struct avl_node *avl_first(struct avl_node *root);
+struct avl_node *avl_last(struct avl_node *root);
+struct avl_node *avl_next(struct avl_node *node);
+struct avl_node *avl_prev(struct avl_node *node);
+/* Unlinks all the nodes, passing each one to 'release' after its children */
+void avl_destroy(struct avl_node **root, void (*release) (struct avl_node *node, void *arg), void *arg);
+
+#endif
+
@@ -0,0 +1,127 @@
+/**
+ * @file bitmap.h
+ * @brief Portable Abstracted Linked Lists Library (libpall)
+ *        Bitmap interface header
+ *
+ * Date: 16-10-2026
+ *
+ * Copyright 2026 Pedro A. Hortas (pah@ucodev.org)
+ *
+ * This file is part of libpall.
+ *
+ * libpall is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libpall is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libpall.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef LIBPALL_BITMAP_H
+#define LIBPALL_BITMAP_H
+
+#include <stddef.h>
+
+#include "config.h"
+#include "pall.h"
+
+#define BITMAP_WORD_BITS	(sizeof(unsigned long) * 8)
+
+/* Internal interface */
+
+/* Returns the number of words required to hold 'nbits' bits */
+static inline size_t bitmap_words(ui32_t nbits) {
+	return (nbits + BITMAP_WORD_BITS - 1) / BITMAP_WORD_BITS;
+}
+
+static inline void bitmap_set(unsigned long *map, ui32_t bit) {
+	map[bit / BITMAP_WORD_BITS] |= 1UL << (bit % BITMAP_WORD_BITS);
+}
+
+static inline void bitmap_clear(unsigned long *map, ui32_t bit) {
+	map[bit / BITMAP_WORD_BITS] &= ~(1UL << (bit % BITMAP_WORD_BITS));
+}
+
+static inline int bitmap_test(const unsigned long *map, ui32_t bit) {
+	return !!(map[bit / BITMAP_WORD_BITS] & (1UL << (bit % BITMAP_WORD_BITS)));
+}
+
+/* Index of the lowest set bit of a non-zero word */
+static inline ui32_t bitmap_ctz(unsigned long word) {
+#if defined(__GNUC__)
+	return (ui32_t) __builtin_ctzl(word);
+#else
+	ui32_t n = 0;
+
+	for (n = 0; !(word & 1); n ++)
+		word >>= 1;
+
+	return n;
+#endif
+}
+
+/* Index of the highest set bit of a non-zero word */
+static inline ui32_t bitmap_msb(unsigned long word) {
+#if defined(__GNUC__)
+	return (ui32_t) (BITMAP_WORD_BITS - 1 - __builtin_clzl(word));
+#else
+	ui32_t n = 0;
+
+	while (word >>= 1)
+		n ++;
+
+	return n;
+#endif
+}
+
+/* Returns the lowest set bit greater than or equal to 'from', or 'nbits' if
+ * there is none below 'nbits'.
+ */
+static inline ui32_t bitmap_next(const unsigned long *map, ui32_t nbits, ui32_t from) {
+	size_t w = from / BITMAP_WORD_BITS, words = bitmap_words(nbits);
+	unsigned long word = 0;
+	ui32_t bit = 0;
+
+	if (from >= nbits)
+		return nbits;
+
+	for (word = map[w] & (~0UL << (from % BITMAP_WORD_BITS)); !word; word = map[w]) {
+		if (++ w == words)
+			return nbits;
+	}
+
+	bit = (ui32_t) (w * BITMAP_WORD_BITS) + bitmap_ctz(word);
+
+	return bit < nbits ? bit : nbits;
+}
+
+/* Returns the highest set bit lower than or equal to 'from', or 'nbits' if
+ * there is none.
+ */
+static inline ui32_t bitmap_prev(const unsigned long *map, ui32_t nbits, ui32_t from) {
+	size_t w = 0;
+	unsigned long word = 0;
+
+	if (from >= nbits)
+		from = nbits - 1;
+
+	w = from / BITMAP_WORD_BITS;
+
+	for (word = map[w] & (~0UL >> (BITMAP_WORD_BITS - 1 - (from % BITMAP_WORD_BITS))); !word; word = map[w]) {
+		if (!w --)
+			return nbits;
+	}
+
+	return (ui32_t) (w * BITMAP_WORD_BITS) + bitmap_msb(word);
+}
+
+#endif
+
@@ -0,0 +1,78 @@
+/**
+ * @file bloom.h
+ * @brief Portable Abstracted Linked Lists Library (libpall)
+ *        Counting Bloom Filter interface header
+ *
+ * Date: 16-10-2026
+ *
+ * Copyright 2026 Pedro A. Hortas (pah@ucodev.org)
+ *
+ * This file is part of libpall.
+ *
+ * libpall is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libpall is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libpall.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef LIBPALL_BLOOM_H
+#define LIBPALL_BLOOM_H
+
+#include "config.h"
+#include "pall.h"
+#include "mm.h"
+
+/* Constants */
+#define BLOOM_BLOCK_COUNTERS	128	/* 4-bit counters per 64 byte block */
+#define BLOOM_K_MAX		9	/* 7 bits per probe out of a 64-bit hash */
+
+/* Structures */
+
+/**
+ * @struct bloom
+ *
+ * @brief
+ *   Blocked counting Bloom filter over 32-bit element hashes. All the probes
+ *   of an element fall on the same cache line sized block, and each counter
+ *   takes 4 bits. Saturated counters are never decremented, so deletes never
+ *   introduce false negatives.
+ *
+ * @var bloom::counters
+ *   The counter blocks, or NULL if the filter is disabled.
+ *
+ * @var bloom::blocks
+ *   The number of counter blocks.
+ *
+ * @var bloom::k
+ *   The number of counters set per element.
+ */
+struct bloom {
+	unsigned char *counters;
+	ui32_t blocks;
+	ui32_t k;
+};
+
+/* Internal interface */
+
+/* Sizes the filter for 'capacity' elements with 'bits' counters each */
+int bloom_init(struct bloom *bloom, const struct pall_mm *mm, ui32_t capacity, ui32_t bits);
+void bloom_release(struct bloom *bloom, const struct pall_mm *mm);
+void bloom_clear(struct bloom *bloom);
+void bloom_add(struct bloom *bloom, ui32_t hash);
+void bloom_del(struct bloom *bloom, ui32_t hash);
+/* Returns zero if 'hash' was certainly never added */
+int bloom_test(const struct bloom *bloom, ui32_t hash);
+void bloom_prefetch(const struct bloom *bloom, ui32_t hash);
+
+#endif
+
@@ -0,0 +1,856 @@
+/**
+ * @file bpt.h
+ * @brief Portable Abstracted Linked Lists Library (libpall)
+ *        B+ Tree interface header
+ *
+ * Date: 16-10-2026
+ *
+ * Copyright 2026 Pedro A. Hortas (pah@ucodev.org)
+ *
+ * This file is part of libpall.
+ *
+ * libpall is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libpall is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libpall.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef LIBPALL_BPT_H
+#define LIBPALL_BPT_H
+
+#include "config.h"
+#include "pall.h"
+#include "mm.h"
+#include "cll.h"
+
+/* Constants */
+#define BPT_INNER_KEYS		7	/* 8 children: 128 byte inner nodes with 64-bit pointers */
+#define BPT_LEAF_ELEMS		13	/* 128 byte leaves with 64-bit pointers */
+#define BPT_NODE_ALIGN		64	/* Cache line size */
+#define BPT_DEPTH_MAX		32	/* Deeper than any tree of 2^32 elements */
+#define BPT_MM_POOL_NMEMB_MIN	16
+#define BPT_MM_POOL_NMEMB_MAX	1024
+
+
+/* Structures */
+
+/**
+ * @struct bpt_stat
+ *
+ * @brief
+ *   Statistical counters for tree operations, tree elements and tree nodes.
+ *
+ * @see pall_bpt_stat()
+ * @see pall_bpt_stat_reset()
+ *
+ * @var bpt_stat::insert
+ *   Number of successful inserts
+ *
+ * @var bpt_stat::insert_err
+ *   Number of failed inserts
+ *
+ * @var bpt_stat::del
+ *   Number of successful deletes
+ *
+ * @var bpt_stat::del_nf
+ *   Number of not found deletes
+ *
+ * @var bpt_stat::search
+ *   Number of successful searches
+ *
+ * @var bpt_stat::search_nf
+ *   Number of not found searches
+ *
+ * @var bpt_stat::serialize
+ *   Number of successful serializations
+ *
+ * @var bpt_stat::serialize_err
+ *   Number of failed serializations
+ *
+ * @var bpt_stat::unserialize
+ *   Number of successful unserializations
+ *
+ * @var bpt_stat::unserialize_err
+ *   Number of failed unserializations
+ *
+ * @var bpt_stat::stat
+ *   Number of stat calls
+ *
+ * @var bpt_stat::count
+ *   Number of count calls
+ *
+ * @var bpt_stat::collapse
+ *   Number of collapse calls
+ *
+ * @var bpt_stat::iterate
+ *   Number of full iterations
+ *
+ * @var bpt_stat::rewind
+ *   Number of rewind calls
+ *
+ * @var bpt_stat::range
+ *   Number of range calls
+ *
+ * @var bpt_stat::set_config
+ *   Number of set_config calls
+ *
+ * @var bpt_stat::get_config
+ *   Number of get_config calls
+ *
+ * @var bpt_stat::elem_count_cur
+ *   Current number of elements present on the tree
+ *
+ * @var bpt_stat::elem_count_max
+ *   Maximum elements since initialization or last stat_reset call.
+ *
+ * @var bpt_stat::node_count
+ *   Current number of inner and leaf nodes of the tree.
+ *
+ * @var bpt_stat::height
+ *   Current height of the tree. A tree holding a single leaf has height 1.
+ *
+ */
+struct bpt_stat {
+	/* Operation statistics */
+	unsigned long insert;
+	unsigned long insert_err;
+	unsigned long del;
+	unsigned long del_nf;
+	unsigned long search;
+	unsigned long search_nf;
+	unsigned long serialize;
+	unsigned long serialize_err;
+	unsigned long unserialize;
+	unsigned long unserialize_err;
+	unsigned long stat;
+	unsigned long count;
+	unsigned long collapse;
+	unsigned long iterate;
+	unsigned long rewind;
+	unsigned long range;
+	unsigned long set_config;
+	unsigned long get_config;
+
+	/* Element statistics */
+	unsigned long elem_count_cur;
+	unsigned long elem_count_max;
+
+	/* Node statistics */
+	unsigned long node_count;
+	unsigned long height;
+};
+
+/**
+ * @struct bpt_node
+ *
+ * @brief
+ *   Header shared by inner and leaf nodes. Nodes are managed by the handler
+ *   and shall not be modified.
+ *
+ * @var bpt_node::count
+ *   The number of children of an inner node, or of elements of a leaf.
+ */
+struct bpt_node {
+	ui32_t count;
+};
+
+/**
+ * @struct bpt_inner
+ *
+ * @brief
+ *   Inner node. Each key is a pointer to an element that is not greater than
+ *   any element of the following child, and not lower than any element of the
+ *   preceding one.
+ *
+ * @var bpt_inner::node
+ *   The node header.
+ *
+ * @var bpt_inner::keys
+ *   The 'count' - 1 separator keys.
+ *
+ * @var bpt_inner::children
+ *   The 'count' children.
+ */
+struct bpt_inner {
+	struct bpt_node node;
+	void *keys[BPT_INNER_KEYS];
+	struct bpt_node *children[BPT_INNER_KEYS + 1];
+};
+
+/**
+ * @struct bpt_leaf
+ *
+ * @brief
+ *   Leaf node, holding the elements in ascending order. Leaves are doubly
+ *   linked in order, so that scans never revisit inner nodes.
+ *
+ * @var bpt_leaf::node
+ *   The node header.
+ *
+ * @var bpt_leaf::prev
+ *   The previous leaf, or NULL.
+ *
+ * @var bpt_leaf::next
+ *   The next leaf, or NULL.
+ *
+ * @var bpt_leaf::data
+ *   The 'count' elements.
+ */
+struct bpt_leaf {
+	struct bpt_node node;
+	struct bpt_leaf *prev;
+	struct bpt_leaf *next;
+	void *data[BPT_LEAF_ELEMS];
+};
+
+/**
+ * @struct bpt_handler
+ *
+ * @brief
+ *   Data structure defining the B+ Tree handler.
+ *
+ * @var bpt_handler::root
+ *   The root node of the tree, or NULL if the tree is empty. It's a leaf if
+ *   the tree height is 1.
+ *
+ * @var bpt_handler::insert
+ *   Function pointer performing the same operation of pall_bpt_insert()
+ *
+ * @var bpt_handler::del
+ *   Function pointer performing the same operation of pall_bpt_delete()
+ *
+ * @var bpt_handler::search
+ *   Function pointer performing the same operation of pall_bpt_search()
+ *
+ * @var bpt_handler::lower_bound
+ *   Function pointer performing the same operation of pall_bpt_lower_bound()
+ *
+ * @var bpt_handler::upper_bound
+ *   Function pointer performing the same operation of pall_bpt_upper_bound()
+ *
+ * @var bpt_handler::serialize
+ *   Function pointer performing the same operation of pall_bpt_serialize()
+ *
+ * @var bpt_handler::unserialize
+ *   Function pointer performing the same operation of pall_bpt_unserialize()
+ *
+ * @var bpt_handler::stat
+ *   Function pointer performing the same operation of pall_bpt_stat()
+ *
+ * @var bpt_handler::stat_reset
+ *   Function pointer performing the same operation of pall_bpt_stat_reset()
+ *
+ * @var bpt_handler::count
+ *   Function pointer performing the same operation of pall_bpt_count()
+ *
+ * @var bpt_handler::collapse
+ *   Function pointer performing the same operation of pall_bpt_collapse()
+ *
+ * @var bpt_handler::iterate
+ *   Function pointer performing the same operation of pall_bpt_iterate()
+ *
+ * @var bpt_handler::rewind
+ *   Function pointer performing the same operation of pall_bpt_rewind()
+ *
+ * @var bpt_handler::range
+ *   Function pointer performing the same operation of pall_bpt_range()
+ *
+ * @var bpt_handler::set_config
+ *   Function pointer performing the same operation of pall_bpt_set_config()
+ *
+ * @var bpt_handler::get_config
+ *   Function pointer performing the same operation of pall_bpt_get_config()
+ *
+ */
+struct bpt_handler {
+	struct bpt_node *root;
+	struct bpt_leaf *_iterate_leaf;
+	ui32_t _iterate_pos;
+	void *_iterate_next;
+	int _iterate_reverse;
+	void *_iterate_hi;
+	ui32_t _count;
+	ui32_t _height;
+	ui32_t _nodes;
+	ui32_t _config_flags;
+
+	struct bpt_stat _stat;
+	struct pall_mm _mm;
+	struct mm_pool _pool;
+	int (*compare) (const void *d1, const void *d2);
+	void (*destroy) (void *data);
+	int (*ser_data) (pall_fd_t fd, void *data);
+	void *(*unser_data) (pall_fd_t fd);
+
+	int (*insert) (struct bpt_handler *handler, void *data);
+	int (*del) (struct bpt_handler *handler, void *data);
+	void *(*search) (struct bpt_handler *handler, void *data);
+	void *(*lower_bound) (struct bpt_handler *handler, void *data);
+	void *(*upper_bound) (struct bpt_handler *handler, void *data);
+	int (*serialize) (struct bpt_handler *handler, pall_fd_t fd);
+	int (*unserialize) (struct bpt_handler *handler, pall_fd_t fd);
+	struct bpt_stat *(*stat) (struct bpt_handler *handler);
+	void (*stat_reset) (struct bpt_handler *handler);
+	ui32_t (*count) (struct bpt_handler *handler);
+	void (*collapse) (struct bpt_handler *handler);
+	void *(*iterate) (struct bpt_handler *handler);
+	void (*rewind) (struct bpt_handler *handler, int to);
+	void (*range) (struct bpt_handler *handler, void *lo, void *hi);
+	ui32_t (*set_config) (struct bpt_handler *handler, ui32_t flags);
+	ui32_t (*get_config) (struct bpt_handler *handler);
+};
+
+
+/* Prototypes / Interface */
+
+/**
+ * @brief
+ *   Initializes a B+ Tree handler. B+ Trees hold the same ordered sets of
+ *   elements as Binary Search Trees, but keep several elements per node and
+ *   all the elements on leaves, so that lookups fetch a few cache lines per
+ *   level from a much shorter tree, and ordered scans walk linked leaves.
+ *
+ * @param compare
+ *   Internally used function for element comparision by pall_bpt_insert(),
+ *   pall_bpt_search() and pall_bpt_delete().
+ *   It receives two elements as parameters of type const void *.
+ *   It shall return an integer less than, equal to, or greater than zero if
+ *   d1 is found, respectively, to be less than, to match, or to be greater
+ *   than d2.
+ *
+ * @param destroy
+ *   Internally used function for memory deallocation, on pall_bpt_delete() and
+ *   pall_bpt_collapse(), of the element pointed by its parameter of type
+ *   void *.
+ *
+ * @param ser_data
+ *   Internally used function for element serialization.
+ *   This is an optional argument and NULL shall be used to disable
+ *   serialization support, causing serialization calls (pall_bpt_serialize())
+ *   to fail, setting errno to ENOSYS.
+ *
+ * @param unser_data
+ *   Internally used function for element unserialization.
+ *   This is an optional argument and NULL shall be used to disable
+ *   unserialization support, causing unserialization calls
+ *   (pall_bpt_unserialize()) to fail, setting errno to ENOSYS.
+ *
+ * @return
+ *   On success, a pointer to a valid B+ Tree handler is returned.
+ *   On error, NULL is returned, and errno is set appropriately.
+ *   \n\n
+ *   Errors: EINVAL, ENOMEM
+ *
+ * @see pall_bpt_insert()
+ * @see pall_bpt_search()
+ * @see pall_bpt_delete()
+ * @see pall_bpt_serialize()
+ * @see pall_bpt_unserialize()
+ * @see pall_bpt_destroy()
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct bpt_handler *pall_bpt_init(
+		int (*compare) (const void *d1, const void *d2),
+		void (*destroy) (void *data),
+		int (*ser_data) (pall_fd_t fd, void *data),
+		void *(*unser_data) (pall_fd_t fd));
+
+/**
+ * @brief
+ *   Initializes a B+ Tree handler that performs all of its memory allocations
+ *   through the allocator pointed by 'mm'.
+ *
+ * @param compare
+ *   Same as pall_bpt_init().
+ *
+ * @param destroy
+ *   Same as pall_bpt_init().
+ *
+ * @param ser_data
+ *   Same as pall_bpt_init().
+ *
+ * @param unser_data
+ *   Same as pall_bpt_init().
+ *
+ * @param mm
+ *   The allocator to be used by this handler. The structure is copied. If NULL,
+ *   the current default allocator is used.
+ *
+ * @return
+ *   On success, a pointer to a valid B+ Tree handler is returned.
+ *   On error, NULL is returned, and errno is set appropriately.
+ *   \n\n
+ *   Errors: EINVAL, ENOMEM
+ *
+ * @see pall_bpt_init()
+ * @see pall_mm_set_allocator()
+ * @see pall_mm
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct bpt_handler *pall_bpt_init_mm(
+		int (*compare) (const void *d1, const void *d2),
+		void (*destroy) (void *data),
+		int (*ser_data) (pall_fd_t fd, void *data),
+		void *(*unser_data) (pall_fd_t fd),
+		const struct pall_mm *mm);
+
+/**
+ * @brief
+ *   Unitializes and release all resources of a B+ Tree handler pointed by
+ *   parameter 'h'.
+ *
+ * @see pall_bpt_init()
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_bpt_destroy(struct bpt_handler *h);
+
+/**
+ * @brief
+ *   Inserts an element pointed by 'data' into the B+ Tree pointed by 'h'.
+ *   Elements matching already inserted ones are placed after them.
+ *
+ * @param h
+ *   An initialized B+ Tree handler.
+ *
+ * @param data
+ *   A pointer to the element to be inserted.
+ *
+ * @return
+ *   On success, zero is returned and statistical counter 'insert' is
+ *   incremented. On error, -1 is returned, statistical counter 'insert_err' is
+ *   incremented, errno is set appropriately, and the tree is left unchanged.
+ *   \n\n
+ *   Errors: ENOMEM
+ *
+ * @see pall_bpt_init()
+ * @see pall_bpt_delete()
+ * @see pall_bpt_search()
+ * @see bpt_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_bpt_insert(struct bpt_handler *h, void *data);
+
+/**
+ * @brief
+ *   Deletes an element that matches the contents of the element pointed by
+ *   'data' from the B+ Tree pointed by 'h'. The comparision of the elements
+ *   is performed by the compare() function passed to pall_bpt_init()
+ *   function.
+ *
+ * @param h
+ *   An initialized B+ Tree handler.
+ *
+ * @param data
+ *   A pointer to the partially filled element to be searched and deleted.
+ *
+ * @return
+ *   On success, zero is returned and statistical counter 'del' is incremented.
+ *   If the element is not found, -1 is returned and statistical counter
+ *   'del_nf' is incremented.
+ *
+ * @see pall_bpt_init()
+ * @see pall_bpt_insert()
+ * @see bpt_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_bpt_delete(struct bpt_handler *h, void *data);
+
+/**
+ * @brief
+ *   Searches an element that matches the contents of the element pointed by
+ *   'data' on the B+ Tree pointed by 'h'. The comparision of the elements is
+ *   performed by the compare() function passed to pall_bpt_init() function.
+ *
+ * @param h
+ *   An initialized B+ Tree handler.
+ *
+ * @param data
+ *   A pointer to the partially filled element to be searched.
+ *
+ * @return
+ *   On success, a pointer to the found element is returned and statistical
+ *   counter 'search' is incremented. If the element is not found, NULL is
+ *   returned and statistical counter 'search_nf' is incremented.
+ *
+ * @see pall_bpt_init()
+ * @see bpt_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_bpt_search(struct bpt_handler *h, void *data);
+
+/**
+ * @brief
+ *   Searches the lowest element of the B+ Tree pointed by 'h' that is not
+ *   lower than the element pointed by 'data'.
+ *
+ * @param h
+ *   An initialized B+ Tree handler.
+ *
+ * @param data
+ *   A pointer to the partially filled element to be compared against.
+ *
+ * @return
+ *   On success, a pointer to the found element is returned and statistical
+ *   counter 'search' is incremented. If all the elements are lower than
+ *   'data', NULL is returned and statistical counter 'search_nf' is
+ *   incremented.
+ *
+ * @see pall_bpt_upper_bound()
+ * @see pall_bpt_range()
+ * @see bpt_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_bpt_lower_bound(struct bpt_handler *h, void *data);
+
+/**
+ * @brief
+ *   Searches the lowest element of the B+ Tree pointed by 'h' that is greater
+ *   than the element pointed by 'data'.
+ *
+ * @param h
+ *   An initialized B+ Tree handler.
+ *
+ * @param data
+ *   A pointer to the partially filled element to be compared against.
+ *
+ * @return
+ *   On success, a pointer to the found element is returned and statistical
+ *   counter 'search' is incremented. If no element is greater than 'data',
+ *   NULL is returned and statistical counter 'search_nf' is incremented.
+ *
+ * @see pall_bpt_lower_bound()
+ * @see pall_bpt_range()
+ * @see bpt_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_bpt_upper_bound(struct bpt_handler *h, void *data);
+
+/**
+ * @brief
+ *   Serializes the contents of the B+ Tree pointed by 'h' into the file
+ *   descriptor 'fd', in ascending order. The format is the same of
+ *   pall_bst_serialize(), so trees serialized by either handler can be
+ *   unserialized by the other.
+ *   Each element is serialized through the ser_data() function passed to
+ *   pall_bpt_init(). If this parameter was passed as NULL, this function
+ *   will return error with errno set to ENOSYS.
+ *
+ * @param h
+ *   An initialized B+ Tree handler.
+ *
+ * @param fd
+ *   A writable file descriptor.
+ *
+ * @return
+ *   On success, zero is returned and statistical counter 'serialize' is
+ *   incremented. On error, -1 is returned, statistical 'serialize_err' is
+ *   incremented, and errno is set appropriately.
+ *   \n\n
+ *   Errors: Same as write() and ENOSYS.
+ *
+ * @see pall_bpt_init()
+ * @see pall_bpt_unserialize()
+ * @see bpt_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_bpt_serialize(struct bpt_handler *h, pall_fd_t fd);
+
+/**
+ * @brief
+ *   Unserializes the contents from the file descriptor 'fd' into the B+ Tree
+ *   pointed by 'h'.
+ *   Each element is unserialized through the unser_data() function passed to
+ *   pall_bpt_init(). If this parameter was passed as NULL, this function
+ *   will return error with errno set to ENOSYS.
+ *
+ * @param h
+ *   An initialized B+ Tree handler.
+ *
+ * @param fd
+ *   A readable file descriptor.
+ *
+ * @return
+ *   On success, zero is returned and statistical counter 'unserialize' is
+ *   incremented. On error, -1 is returned, statistical counter
+ *   'unserialize_err' is incremented and, errno is set appropriately.
+ *   \n\n
+ *   Errors: Same as read() and ENOSYS.
+ *
+ * @see pall_bpt_init()
+ * @see pall_bpt_serialize()
+ * @see bpt_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_bpt_unserialize(struct bpt_handler *h, pall_fd_t fd);
+
+/**
+ * @brief
+ *   Returns statistical information for operations, content and nodes of the
+ *   B+ Tree pointed by handler 'h'. This function shall be called for each
+ *   time updated statistical counters are required.
+ *
+ * @param h
+ *   An initialized B+ Tree handler.
+ *
+ * @return
+ *   Returns a pointer to a valid struct bpt_stat and the statistical counter
+ *   'stat' is incremented. This function always succeeds.
+ *
+ * @see pall_bpt_init()
+ * @see pall_bpt_stat_reset()
+ * @see bpt_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct bpt_stat *pall_bpt_stat(struct bpt_handler *h);
+
+/**
+ * @brief
+ *   Resets the statistical counters of the B+ Tree pointed by handler 'h'.
+ *
+ * @param h
+ *   An initialized B+ Tree handler.
+ *
+ * @see pall_bpt_init()
+ * @see pall_bpt_stat()
+ * @see bpt_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_bpt_stat_reset(struct bpt_handler *h);
+
+/**
+ * @brief
+ *   Returns the number of elements of the B+ Tree pointed by handler 'h'.
+ *
+ * @param h
+ *   An initialized B+ Tree handler.
+ *
+ * @return
+ *   Returns a positive integer of type ui32_t (32 bit unsigned) if the tree
+ *   isn't empty. If it's empty, zero is returned. Statistical counter 'count'
+ *   is always incremented when this function retruns.
+ *
+ * @see pall_bpt_init()
+ * @see bpt_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_bpt_count(struct bpt_handler *h);
+
+/**
+ * @brief
+ *   Removes all the elements from the B+ Tree pointed by handler 'h'.
+ *
+ * @param h
+ *   An initialized B+ Tree handler.
+ *
+ * @return
+ *   This function doesn't return any value. The statistical counter 'collapse'
+ *   is incremented on return.
+ *
+ * @see pall_bpt_init()
+ * @see pall_bpt_delete()
+ * @see bpt_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_bpt_collapse(struct bpt_handler *h);
+
+/**
+ * @brief
+ *   Iterates through the elements of the B+ Tree pointed by handler 'h'. Each
+ *   call to this function returns a pointer to the next element present on
+ *   the tree. Iteration may be performed in ascending or descending order,
+ *   depending on the parameters used on the pall_bpt_rewind() function.
+ *   \n\n
+ *   Each call takes constant time and allocates no memory, as the iteration
+ *   walks the linked leaves, keeping the position of the next element to be
+ *   returned. The tree may be modified while iterating: any element may be
+ *   deleted, and inserted elements are returned if they are placed past that
+ *   next element. As elements move between leaves, the first call after a
+ *   modification looks up the next element again in O(log n + d) time, where
+ *   d is the number of elements equal to it.
+ *   Rewind and iterate do not affect the behavior of any other operation.
+ *
+ * @param h
+ *   An initialized B+ Tree handler.
+ *
+ * @return
+ *   Returns a pointer to the next element present on the tree. If the end of
+ *   the tree is reached, NULL is returned and statistical counter 'iterate'
+ *   is incremented.
+ *
+ * @see pall_bpt_init()
+ * @see pall_bpt_rewind()
+ * @see bpt_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_bpt_iterate(struct bpt_handler *h);
+
+/**
+ * @brief
+ *   Rewinds the B+ Tree pointed by handler 'h'. The parameter 'to' tells to
+ *   where the rewind should be perfomed and configures the behavior of
+ *   pall_bpt_iterate().
+ *   Rewind and iterate do not affect the behavior of any other operation.
+ *
+ * @param h
+ *   An initialized B+ Tree handler.
+ *
+ * @param to
+ *   If set to 0, the tree is rewinded to its lowest element and
+ *   pall_bpt_iterate() will iterate the tree in ascending order.
+ *   If set to 1, the tree is rewinded to its highest element and
+ *   pall_bpt_iterate() will iterate the tree in descending order.
+ *
+ * @return
+ *   No value is returned and statistical counter 'rewind' is incremented for
+ *   each time this function returns.
+ *
+ * @see pall_bpt_init()
+ * @see pall_bpt_iterate()
+ * @see bpt_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_bpt_rewind(struct bpt_handler *h, int to);
+
+/**
+ * @brief
+ *   Rewinds the B+ Tree pointed by handler 'h' to the range of elements not
+ *   lower than 'lo' and lower than 'hi'. The following calls to
+ *   pall_bpt_iterate() return the elements of that range in ascending order,
+ *   and NULL once the range is exhausted. The same iteration semantics of
+ *   pall_bpt_iterate() apply, and a call to pall_bpt_rewind() ends the range.
+ *
+ * @param h
+ *   An initialized B+ Tree handler.
+ *
+ * @param lo
+ *   Same as pall_bst_range().
+ *
+ * @param hi
+ *   Same as pall_bst_range().
+ *
+ * @return
+ *   No value is returned and statistical counter 'range' is incremented for
+ *   each time this function returns.
+ *
+ * @see pall_bpt_iterate()
+ * @see pall_bpt_lower_bound()
+ * @see bpt_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_bpt_range(struct bpt_handler *h, void *lo, void *hi);
+
+/**
+ * @brief
+ *   Sets a new configuration based on 'flags' parameter to the B+ Tree
+ *   pointed by handler 'h'.
+ *
+ * @param h
+ *   An initialized B+ Tree handler.
+ *
+ * @param flags
+ *   The configuration flags that will affect the behavior of the tree.
+ *   Available flags are: CONFIG_MM_POOL (default), which carves the tree
+ *   nodes from a per-handler pool aligned to BPT_NODE_ALIGN, so that each
+ *   node spans the fewest cache lines. As for the other handlers, the pool is
+ *   only created on an empty tree.
+ *
+ * @return
+ *   Returns the previous configuration flags and statistical counter
+ *   'set_config' is incremented.
+ *
+ * @see pall_bpt_init()
+ * @see pall_bpt_get_config()
+ * @see bpt_stat
+ * @see CONFIG_MM_POOL
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_bpt_set_config(struct bpt_handler *h, ui32_t flags);
+
+/**
+ * @brief
+ *   Gets the current configuration flags from the B+ Tree pointed by handler
+ *   'h'.
+ *
+ * @param h
+ *   An initialized B+ Tree handler.
+ *
+ * @return
+ *   Returns the current configuration flags set to the tree and statistical
+ *   counter 'get_config' is incremented.
+ *
+ * @see pall_bpt_init()
+ * @see pall_bpt_set_config()
+ * @see bpt_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_bpt_get_config(struct bpt_handler *h);
+
+#endif
+
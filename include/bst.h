@@ -29,8 +29,13 @@
 
 #include "config.h"
 #include "pall.h"
-#include "fifo.h"
-#include "lifo.h"
+#include "mm.h"
+#include "avl.h"
+#include "cll.h"
+
+/* Constants */
+#define BST_MM_POOL_NMEMB_MIN	16
+#define BST_MM_POOL_NMEMB_MAX	1024
 
 
 /* Structures */
@@ -89,6 +94,15 @@
  * @var bst_stat::rewind
  *   Number of rewind calls
  *
+ * @var bst_stat::range
+ *   Number of range calls
+ *
+ * @var bst_stat::set_config
+ *   Number of set_config calls
+ *
+ * @var bst_stat::get_config
+ *   Number of get_config calls
+ *
  * @var bst_stat::elem_count_cur
  *   Current number of elements present on the tree
  *
@@ -114,6 +128,9 @@ struct bst_stat {
 	unsigned long collapse;
 	unsigned long iterate;
 	unsigned long rewind;
+	unsigned long range;
+	unsigned long set_config;
+	unsigned long get_config;
 
 	/* Element statistics */
 	unsigned long elem_count_cur;
@@ -127,7 +144,7 @@ struct bst_stat {
  *   Data structure defining the Binary Search Tree handler.
  *
  * @var bst_handler::root
- *   The BST root pointer.
+ *   The root node of the tree, or NULL if the tree is empty.
  *
  * @var bst_handler::insert
  *   Function pointer performing the same operation of pall_bst_insert()
@@ -138,6 +155,21 @@ struct bst_stat {
  * @var bst_handler::search
  *   Function pointer performing the same operation of pall_bst_search()
  *
+ * @var bst_handler::lower_bound
+ *   Function pointer performing the same operation of pall_bst_lower_bound()
+ *
+ * @var bst_handler::upper_bound
+ *   Function pointer performing the same operation of pall_bst_upper_bound()
+ *
+ * @var bst_handler::select
+ *   Function pointer performing the same operation of pall_bst_select()
+ *
+ * @var bst_handler::rank
+ *   Function pointer performing the same operation of pall_bst_rank()
+ *
+ * @var bst_handler::count_range
+ *   Function pointer performing the same operation of pall_bst_count_range()
+ *
  * @var bst_handler::serialize
  *   Function pointer performing the same operation of pall_bst_serialize()
  *
@@ -162,17 +194,30 @@ struct bst_stat {
  * @var bst_handler::rewind
  *   Function pointer performing the same operation of pall_bst_rewind()
  *
+ * @var bst_handler::range
+ *   Function pointer performing the same operation of pall_bst_range()
+ *
+ * @var bst_handler::set_config
+ *   Function pointer performing the same operation of pall_bst_set_config()
+ *
+ * @var bst_handler::get_config
+ *   Function pointer performing the same operation of pall_bst_get_config()
+ *
+ * @var bst_handler::arena_alloc
+ *   Function pointer performing the same operation of pall_bst_arena_alloc()
+ *
  */
 struct bst_handler {
-	void *root;
-	struct fifo_handler *_iterate_forward;
-	struct lifo_handler *_iterate_backward;
+	struct avl_node *root;
+	struct avl_node *_iterate_cur;
 	int _iterate_reverse;
-	pall_fd_t _ser_cur_fd;
-	int _ser_ret;
+	void *_iterate_hi;
 	ui32_t _count;
+	ui32_t _config_flags;
 
 	struct bst_stat _stat;
+	struct pall_mm _mm;
+	struct mm_pool _pool;
 	int (*compare) (const void *d1, const void *d2);
 	void (*destroy) (void *data);
 	int (*ser_data) (pall_fd_t fd, void *data);
@@ -181,6 +226,11 @@ struct bst_handler {
 	int (*insert) (struct bst_handler *handler, void *data);
 	int (*del) (struct bst_handler *handler, void *data);
 	void *(*search) (struct bst_handler *handler, void *data);
+	void *(*lower_bound) (struct bst_handler *handler, void *data);
+	void *(*upper_bound) (struct bst_handler *handler, void *data);
+	void *(*select) (struct bst_handler *handler, ui32_t k);
+	ui32_t (*rank) (struct bst_handler *handler, void *data);
+	ui32_t (*count_range) (struct bst_handler *handler, void *lo, void *hi);
 	int (*serialize) (struct bst_handler *handler, pall_fd_t fd);
 	int (*unserialize) (struct bst_handler *handler, pall_fd_t fd);
 	struct bst_stat *(*stat) (struct bst_handler *handler);
@@ -189,11 +239,31 @@ struct bst_handler {
 	void (*collapse) (struct bst_handler *handler);
 	void *(*iterate) (struct bst_handler *handler);
 	void (*rewind) (struct bst_handler *handler, int to);
+	void (*range) (struct bst_handler *handler, void *lo, void *hi);
+	ui32_t (*set_config) (struct bst_handler *handler, ui32_t flags);
+	ui32_t (*get_config) (struct bst_handler *handler);
+	void *(*arena_alloc) (struct bst_handler *handler, size_t size);
 };
 
+/**
+ * @struct bst_node
+ *
+ * @brief
+ *   Binary Search Tree node, allocated by the handler for each inserted
+ *   element. The tree links are embedded in the node, and the tree is kept
+ *   balanced as an AVL tree ordered by the handler compare() function, with
+ *   each node also counting the elements of its subtree. Its
+ *   contents are managed by the handler and shall not be modified.
+ *
+ * @var bst_node::node
+ *   The embedded tree links.
+ *
+ * @var bst_node::data
+ *   The element held by this node.
+ */
 struct bst_node {
+	struct avl_node node;
 	void *data;
-	struct bst_handler *h;
 };
 
 
@@ -251,6 +321,48 @@ struct bst_handler *pall_bst_init(
 		int (*ser_data) (pall_fd_t fd, void *data),
 		void *(*unser_data) (pall_fd_t fd));
 
+/**
+ * @brief
+ *   Initializes a Binary Search Tree handler that performs all of its memory
+ *   allocations through the allocator pointed by 'mm'.
+ *
+ * @param compare
+ *   Same as pall_bst_init().
+ *
+ * @param destroy
+ *   Same as pall_bst_init().
+ *
+ * @param ser_data
+ *   Same as pall_bst_init().
+ *
+ * @param unser_data
+ *   Same as pall_bst_init().
+ *
+ * @param mm
+ *   The allocator to be used by this handler. The structure is copied. If NULL,
+ *   the current default allocator is used.
+ *
+ * @return
+ *   On success, a pointer to a valid Binary Search Tree handler is returned.
+ *   On error, NULL is returned, and errno is set appropriately.
+ *   \n\n
+ *   Errors: EINVAL, ENOMEM
+ *
+ * @see pall_bst_init()
+ * @see pall_mm_set_allocator()
+ * @see pall_mm
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct bst_handler *pall_bst_init_mm(
+		int (*compare) (const void *d1, const void *d2),
+		void (*destroy) (void *data),
+		int (*ser_data) (pall_fd_t fd, void *data),
+		void *(*unser_data) (pall_fd_t fd),
+		const struct pall_mm *mm);
+
 /**
  * @brief
  *   Unitializes and release all resources of a Binary Search Tree handler
@@ -267,7 +379,7 @@ void pall_bst_destroy(struct bst_handler *h);
 /**
  * @brief
  *   Inserts an element pointed by 'data' into the Binary Search Tree pointed
- *   by 'h'.
+ *   by 'h'. Elements matching already inserted ones are placed after them.
  *
  * @param h
  *   An initialized Binary Search Tree handler.
@@ -348,6 +460,145 @@ DLLIMPORT
 #endif
 void *pall_bst_search(struct bst_handler *h, void *data);
 
+/**
+ * @brief
+ *   Searches the lowest element of the Binary Search Tree pointed by 'h' that
+ *   is not lower than the element pointed by 'data', in O(log n) time. The
+ *   comparision of the elements is performed by the compare() function passed
+ *   to pall_bst_init() function.
+ *
+ * @param h
+ *   An initialized Binary Search Tree handler.
+ *
+ * @param data
+ *   A pointer to the partially filled element to be compared against.
+ *
+ * @return
+ *   On success, a pointer to the found element is returned and statistical
+ *   counter 'search' is incremented. If all the elements are lower than
+ *   'data', NULL is returned and statistical counter 'search_nf' is
+ *   incremented.
+ *
+ * @see pall_bst_upper_bound()
+ * @see pall_bst_range()
+ * @see bst_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_bst_lower_bound(struct bst_handler *h, void *data);
+
+/**
+ * @brief
+ *   Searches the lowest element of the Binary Search Tree pointed by 'h' that
+ *   is greater than the element pointed by 'data', in O(log n) time. The
+ *   comparision of the elements is performed by the compare() function passed
+ *   to pall_bst_init() function.
+ *
+ * @param h
+ *   An initialized Binary Search Tree handler.
+ *
+ * @param data
+ *   A pointer to the partially filled element to be compared against.
+ *
+ * @return
+ *   On success, a pointer to the found element is returned and statistical
+ *   counter 'search' is incremented. If no element is greater than 'data',
+ *   NULL is returned and statistical counter 'search_nf' is incremented.
+ *
+ * @see pall_bst_lower_bound()
+ * @see pall_bst_range()
+ * @see bst_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_bst_upper_bound(struct bst_handler *h, void *data);
+
+/**
+ * @brief
+ *   Returns the element at zero based position 'k' of the Binary Search Tree
+ *   pointed by 'h', in ascending order, in O(log n) time. For instance, the
+ *   median is at position count / 2.
+ *
+ * @param h
+ *   An initialized Binary Search Tree handler.
+ *
+ * @param k
+ *   The position of the element to be returned.
+ *
+ * @return
+ *   On success, a pointer to the element is returned and statistical counter
+ *   'search' is incremented. If 'k' is not lower than the element count, NULL
+ *   is returned and statistical counter 'search_nf' is incremented.
+ *
+ * @see pall_bst_rank()
+ * @see bst_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_bst_select(struct bst_handler *h, ui32_t k);
+
+/**
+ * @brief
+ *   Returns the number of elements of the Binary Search Tree pointed by 'h'
+ *   that are lower than the element pointed by 'data', in O(log n) time. If
+ *   'data' matches an element, this is the position of the first match as
+ *   accepted by pall_bst_select().
+ *
+ * @param h
+ *   An initialized Binary Search Tree handler.
+ *
+ * @param data
+ *   A pointer to the partially filled element to be compared against.
+ *
+ * @return
+ *   Returns the number of lower elements and statistical counter 'count' is
+ *   incremented.
+ *
+ * @see pall_bst_select()
+ * @see pall_bst_count_range()
+ * @see bst_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_bst_rank(struct bst_handler *h, void *data);
+
+/**
+ * @brief
+ *   Returns the number of elements of the Binary Search Tree pointed by 'h'
+ *   that are not lower than 'lo' and lower than 'hi', in O(log n) time. These
+ *   are the elements that pall_bst_range() would iterate.
+ *
+ * @param h
+ *   An initialized Binary Search Tree handler.
+ *
+ * @param lo
+ *   Same as pall_bst_range().
+ *
+ * @param hi
+ *   Same as pall_bst_range().
+ *
+ * @return
+ *   Returns the number of elements in the range and statistical counter
+ *   'count' is incremented.
+ *
+ * @see pall_bst_range()
+ * @see pall_bst_rank()
+ * @see bst_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_bst_count_range(struct bst_handler *h, void *lo, void *hi);
+
 /**
  * @brief
  *   Serializes the contents of the Binary Search Tree pointed by 'h', to
@@ -506,18 +757,23 @@ void pall_bst_collapse(struct bst_handler *h);
  * @brief
  *   Iterates through the elements of the Binary Search Tree pointed by
  *   handler 'h'. Each call to this function returns a pointer to the next
- *   element present on the tree. Iteration may be performed from array index
- *   zero to arr_size, head to tail for each indexed list, or from arr_size to
- *   zero, tail to head for each indexed list, depending on the parameters used
- *   on the pall_bst_rewind() function.
+ *   element present on the tree. Iteration may be performed in ascending or
+ *   descending order, depending on the parameters used on the
+ *   pall_bst_rewind() function.
+ *   \n\n
+ *   Each call takes constant amortized time and allocates no memory, as the
+ *   iteration follows the tree links, keeping only the position of the next
+ *   element to be returned. The tree may be modified while iterating: any
+ *   element may be deleted, and inserted elements are returned if they are
+ *   placed past that next element.
  *   Rewind and iterate do not affect the behavior of any other operation.
  *
  * @param h
  *   An initialized Binary Search Tree handler.
  *
  * @return
- *   Returns a pointer to the next element present on the list. If the end of
- *   the list is reached, NULL is returned and statistical counter 'iterate'
+ *   Returns a pointer to the next element present on the tree. If the end of
+ *   the tree is reached, NULL is returned and statistical counter 'iterate'
  *   is incremented.
  *
  * @see pall_bst_init()
@@ -541,12 +797,10 @@ void *pall_bst_iterate(struct bst_handler *h);
  *   An initialized Binary Search Tree handler.
  *
  * @param to
- *   If set to 0, the tree is rewinded to array index zero, and each list is
- *   rewinded to head. pall_bst_iterate() will iterate the tree from array
- *   index zero to arr_size and each indexed list from head to tail.
- *   If set to 1, the tree is rewinded to arr_size index, and each list is
- *   rewinded to tail. pall_bst_iterate() will iterate the tree from array
- *   index arr_size to zero and each index list from tail to head.
+ *   If set to 0, the tree is rewinded to its lowest element and
+ *   pall_bst_iterate() will iterate the tree in ascending order.
+ *   If set to 1, the tree is rewinded to its highest element and
+ *   pall_bst_iterate() will iterate the tree in descending order.
  *
  * @return
  *   No value is returned and statistical counter 'rewind' is incremented for
@@ -562,5 +816,124 @@ DLLIMPORT
 #endif
 void pall_bst_rewind(struct bst_handler *h, int to);
 
+/**
+ * @brief
+ *   Rewinds the Binary Search Tree pointed by handler 'h' to the range of
+ *   elements not lower than 'lo' and lower than 'hi'. The following calls to
+ *   pall_bst_iterate() return the elements of that range in ascending order,
+ *   and NULL once the range is exhausted, so that k elements are visited in
+ *   O(log n + k) time. The same iteration semantics of pall_bst_iterate()
+ *   apply, and a call to pall_bst_rewind() ends the range.
+ *
+ * @param h
+ *   An initialized Binary Search Tree handler.
+ *
+ * @param lo
+ *   A pointer to the partially filled element bounding the range from below,
+ *   inclusive. If NULL, the range starts at the lowest element.
+ *
+ * @param hi
+ *   A pointer to the partially filled element bounding the range from above,
+ *   exclusive. If NULL, the range ends at the highest element. Otherwise, it
+ *   is compared against each iterated element, and shall remain valid until
+ *   the range is exhausted or rewound.
+ *
+ * @return
+ *   No value is returned and statistical counter 'range' is incremented for
+ *   each time this function returns.
+ *
+ * @see pall_bst_iterate()
+ * @see pall_bst_lower_bound()
+ * @see bst_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_bst_range(struct bst_handler *h, void *lo, void *hi);
+
+/**
+ * @brief
+ *   Sets a new configuration based on 'flags' parameter to the Binary Search
+ *   Tree pointed by handler 'h'.
+ *
+ * @param h
+ *   An initialized Binary Search Tree handler.
+ *
+ * @param flags
+ *   The configuration flags that will affect the behavior of the tree.
+ *   Available flags are: CONFIG_MM_POOL (default) and CONFIG_MM_ARENA, with the
+ *   same semantics described for Circular Linked Lists, applied to the tree
+ *   nodes.
+ *
+ * @return
+ *   Returns the previous configuration flags and statistical counter
+ *   'set_config' is incremented.
+ *
+ * @see pall_bst_init()
+ * @see pall_bst_get_config()
+ * @see bst_stat
+ * @see CONFIG_MM_POOL
+ * @see CONFIG_MM_ARENA
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_bst_set_config(struct bst_handler *h, ui32_t flags);
+
+/**
+ * @brief
+ *   Gets the current configuration flags from the Binary Search Tree pointed
+ *   by handler 'h'.
+ *
+ * @param h
+ *   An initialized Binary Search Tree handler.
+ *
+ * @return
+ *   Returns the current configuration flags set to the tree and statistical
+ *   counter 'get_config' is incremented.
+ *
+ * @see pall_bst_init()
+ * @see pall_bst_set_config()
+ * @see bst_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_bst_get_config(struct bst_handler *h);
+
+/**
+ * @brief
+ *   Allocates 'size' bytes from the pool of the Binary Search Tree pointed by
+ *   handler 'h'. The allocated memory cannot be released individually and is
+ *   released, along with the tree nodes, by pall_bst_collapse() and
+ *   pall_bst_destroy(). This is intended for elements of handlers configured
+ *   with CONFIG_MM_ARENA.
+ *
+ * @param h
+ *   An initialized Binary Search Tree handler.
+ *
+ * @param size
+ *   The number of bytes to be allocated.
+ *
+ * @return
+ *   On success, a pointer to the allocated memory, suitably aligned for any
+ *   type, is returned. On error, NULL is returned and errno is set
+ *   appropriately.
+ *   \n\n
+ *   Errors: ENOMEM, EBUSY (the tree isn't empty and its nodes were allocated
+ *   before a pool was created).
+ *
+ * @see pall_bst_collapse()
+ * @see CONFIG_MM_ARENA
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_bst_arena_alloc(struct bst_handler *h, size_t size);
+
 #endif
 
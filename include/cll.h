@@ -29,6 +29,11 @@
 
 #include "config.h"
 #include "pall.h"
+#include "mm.h"
+
+/* Constants */
+#define CLL_MM_POOL_NMEMB_MIN	16
+#define CLL_MM_POOL_NMEMB_MAX	1024
 
 /* Configuration Options */
 
@@ -112,8 +117,87 @@
  *   This is the default configuration.
  */
 #define CONFIG_INSERT_HEAD	0x100
+/**
+ * @def CONFIG_MM_POOL
+ *
+ * @brief
+ *   Configures the handler to allocate list elements from a private pool.
+ *   Elements are carved from chunks of CLL_MM_POOL_NMEMB_MIN up to
+ *   CLL_MM_POOL_NMEMB_MAX elements and recycled through an internal free list,
+ *   so steady-state inserts and pops do not reach the system allocator.
+ *   The pool is created on the first insert into an empty list and, once
+ *   created, remains in use until the list is collapsed, regardless of later
+ *   configuration changes. This is the default configuration.
+ */
+#define CONFIG_MM_POOL		0x200
+/**
+ * @def CONFIG_MM_ARENA
+ *
+ * @brief
+ *   Configures the handler as an arena. Implies CONFIG_MM_POOL. Elements are
+ *   expected to be allocated from the handler pool through
+ *   pall_cll_arena_alloc(), so pall_cll_collapse() and pall_cll_destroy()
+ *   release all the list and element memory at once, without walking the
+ *   list and without invoking the destroy() function.
+ *   Note that pall_cll_delete() still invokes destroy(), which shall not
+ *   release elements allocated from the arena.
+ */
+#define CONFIG_MM_ARENA		0x400
+/**
+ * @def CONFIG_HASH_MASK
+ *
+ * @brief
+ *   Applies to Hash Mod Balanced Tree handlers only. Configures the handler
+ *   to keep a power of two array size, rounding it up if required, and to
+ *   select array indexes by masking the element hash instead of computing
+ *   its modulo. The user hash is passed through an avalanche finalizer
+ *   (MurmurHash3 fmix32) before being masked, so that hash functions with
+ *   weak low bits do not cluster.
+ *   Changes to this flag are only applied while the handler is empty and are
+ *   otherwise ignored.
+ */
+#define CONFIG_HASH_MASK	0x800
+/**
+ * @def CONFIG_STAT_INCREMENTAL
+ *
+ * @brief
+ *   Applies to Hash Mod Balanced Tree handlers only. Configures the handler
+ *   stat() call to only refresh the aggregate counters, which are maintained
+ *   on every operation, so that it completes in constant time. This includes
+ *   node_elem_count_min and node_elem_count_max, which are kept through a
+ *   histogram of the node element counts. The per node distribution
+ *   (node_elem_count) keeps the values of the last stat() call performed
+ *   without this flag.
+ */
+#define CONFIG_STAT_INCREMENTAL	0x1000
+
+/* Macros */
+
+/**
+ * @def CLL_LINK_OFFSET
+ *
+ * @brief
+ *   Returns the offset of the struct cll_elem 'member' embedded in the
+ *   structure 'type', suitable for pall_cll_init_intrusive().
+ */
+#define CLL_LINK_OFFSET(type, member)	offsetof(type, member)
 
 /* Structures */
+
+/**
+ * @struct cll_elem
+ *
+ * @brief
+ *   Circular Linked List element. Allocated by the handler for each inserted
+ *   element, unless the handler was initialized with pall_cll_init_intrusive(),
+ *   in which case this structure shall be embedded in the user element.
+ *   Its contents are managed by the handler and shall not be modified.
+ *   Pointers to it are also used as node handles, which are returned by
+ *   pall_cll_insert_handle() and remain valid until the element is removed.
+ *
+ * @see pall_cll_init_intrusive()
+ * @see pall_cll_insert_handle()
+ */
 struct cll_elem {
 	void *data;
 	struct cll_elem *next;
@@ -244,12 +328,27 @@ struct cll_stat {
  * @var cll_handler::insert
  *   Function pointer performing the same operation of pall_cll_insert()
  *
+ * @var cll_handler::insert_batch
+ *   Function pointer performing the same operation of pall_cll_insert_batch()
+ *
+ * @var cll_handler::insert_handle
+ *   Function pointer performing the same operation of pall_cll_insert_handle()
+ *
  * @var cll_handler::del
  *   Function pointer performing the same operation of pall_cll_delete()
  *
+ * @var cll_handler::del_key
+ *   Function pointer performing the same operation of pall_cll_delete_key()
+ *
+ * @var cll_handler::del_handle
+ *   Function pointer performing the same operation of pall_cll_delete_handle()
+ *
  * @var cll_handler::search
  *   Function pointer performing the same operation of pall_cll_search()
  *
+ * @var cll_handler::search_key
+ *   Function pointer performing the same operation of pall_cll_search_key()
+ *
  * @var cll_handler::serialize
  *   Function pointer performing the same operation of pall_cll_serialize()
  *
@@ -268,6 +367,16 @@ struct cll_stat {
  * @var cll_handler::pope
  *   Function pointer performing the same operation of pall_cll_pope()
  *
+ * @var cll_handler::pope_key
+ *   Function pointer performing the same operation of pall_cll_pope_key()
+ *
+ * @var cll_handler::pope_handle
+ *   Function pointer performing the same operation of pall_cll_pope_handle()
+ *
+ * @var cll_handler::move_to_head_handle
+ *   Function pointer performing the same operation of
+ *   pall_cll_move_to_head_handle()
+ *
  * @var cll_handler::poph
  *   Function pointer performing the same operation of pall_cll_poph()
  *
@@ -286,6 +395,12 @@ struct cll_stat {
  * @var cll_handler::get_config
  *   Function pointer performing the same operation of pall_cll_get_config()
  *
+ * @var cll_handler::arena_alloc
+ *   Function pointer performing the same operation of pall_cll_arena_alloc()
+ *
+ * @var cll_handler::set_key
+ *   Function pointer performing the same operation of pall_cll_set_key()
+ *
  */
 struct cll_handler {
 	struct cll_elem *cll;
@@ -295,29 +410,45 @@ struct cll_handler {
 	int _iterate_reverse;
 
 	struct cll_stat _stat;
+	struct pall_mm _mm;
+	struct mm_pool _pool;
 	ui32_t _config_flags;
 	ui32_t _count;
+	int _intrusive;
+	size_t _link_offset;
 
 	int (*compare) (const void *d1, const void *d2);
 	void (*destroy) (void *data);
 	int (*ser_data) (pall_fd_t fd, void *data);
 	void *(*unser_data) (pall_fd_t fd);
+	void *(*key) (void *data);
+	int (*key_compare) (const void *k1, const void *k2);
 
 	int (*insert) (struct cll_handler *handler, void *data);
+	int (*insert_batch) (struct cll_handler *handler, void **data, ui32_t count);
+	int (*insert_handle) (struct cll_handler *handler, void *data, struct cll_elem **handle);
 	int (*del) (struct cll_handler *handler, void *data);
+	int (*del_key) (struct cll_handler *handler, void *key);
+	void (*del_handle) (struct cll_handler *handler, struct cll_elem *handle);
 	void *(*search) (struct cll_handler *handler, void *data);
+	void *(*search_key) (struct cll_handler *handler, void *key);
 	int (*serialize) (struct cll_handler *handler, pall_fd_t fd);
 	int (*unserialize) (struct cll_handler *handler, pall_fd_t fd);
 	struct cll_stat *(*stat) (struct cll_handler *handler);
 	void (*stat_reset) (struct cll_handler *handler);
 	ui32_t (*count) (struct cll_handler *handler);
 	void *(*pope) (struct cll_handler *handler, void *data);
+	void *(*pope_key) (struct cll_handler *handler, void *key);
+	void *(*pope_handle) (struct cll_handler *handler, struct cll_elem *handle);
+	void (*move_to_head_handle) (struct cll_handler *handler, struct cll_elem *handle);
 	void *(*poph) (struct cll_handler *handler);
 	void (*collapse) (struct cll_handler *handler);
 	void *(*iterate) (struct cll_handler *handler);
 	void (*rewind) (struct cll_handler *handler, int to);
 	ui32_t (*set_config) (struct cll_handler *handler, ui32_t flags);
 	ui32_t (*get_config) (struct cll_handler *handler);
+	void *(*arena_alloc) (struct cll_handler *handler, size_t size);
+	int (*set_key) (struct cll_handler *handler, void *(*key) (void *data), int (*key_compare) (const void *k1, const void *k2));
 };
 
 
@@ -375,6 +506,103 @@ struct cll_handler *pall_cll_init(
 		int (*ser_data) (pall_fd_t fd, void *data),
 		void *(*unser_data) (pall_fd_t fd));
 
+/**
+ * @brief
+ *   Initializes a Circular Linked List handler that performs all of its memory
+ *   allocations through the allocator pointed by 'mm'.
+ *
+ * @param compare
+ *   Same as pall_cll_init().
+ *
+ * @param destroy
+ *   Same as pall_cll_init().
+ *
+ * @param ser_data
+ *   Same as pall_cll_init().
+ *
+ * @param unser_data
+ *   Same as pall_cll_init().
+ *
+ * @param mm
+ *   The allocator to be used by this handler. The structure is copied. If NULL,
+ *   the current default allocator is used.
+ *
+ * @return
+ *   On success, a pointer to a valid Circular Linked List handler is returned.
+ *   On error, NULL is returned, and errno is set appropriately.
+ *   \n\n
+ *   Errors: EINVAL, ENOMEM
+ *
+ * @see pall_cll_init()
+ * @see pall_mm_set_allocator()
+ * @see pall_mm
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct cll_handler *pall_cll_init_mm(
+		int (*compare) (const void *d1, const void *d2),
+		void (*destroy) (void *data),
+		int (*ser_data) (pall_fd_t fd, void *data),
+		void *(*unser_data) (pall_fd_t fd),
+		const struct pall_mm *mm);
+
+/**
+ * @brief
+ *   Initializes an intrusive Circular Linked List handler. Elements inserted
+ *   into an intrusive list shall embed a struct cll_elem at offset
+ *   'link_offset', which is used as the list element, so that inserts, deletes
+ *   and pops never allocate or release memory, and searches touch the element
+ *   and its links at once.
+ *   An element can only be linked to a single intrusive list through the same
+ *   embedded struct cll_elem, and shall remain valid while it's linked.
+ *   Apart from initialization, intrusive handlers are used exactly as the
+ *   ones initialized through pall_cll_init().
+ *
+ * @param compare
+ *   Same as pall_cll_init().
+ *
+ * @param destroy
+ *   Same as pall_cll_init().
+ *
+ * @param ser_data
+ *   Same as pall_cll_init().
+ *
+ * @param unser_data
+ *   Same as pall_cll_init(). Unserialized elements shall also embed the
+ *   struct cll_elem at offset 'link_offset'.
+ *
+ * @param link_offset
+ *   Offset of the embedded struct cll_elem inside the elements, as returned
+ *   by CLL_LINK_OFFSET().
+ *
+ * @param mm
+ *   The allocator to be used by this handler. If NULL, the current default
+ *   allocator is used.
+ *
+ * @return
+ *   On success, a pointer to a valid Circular Linked List handler is returned.
+ *   On error, NULL is returned, and errno is set appropriately.
+ *   \n\n
+ *   Errors: EINVAL, ENOMEM
+ *
+ * @see pall_cll_init()
+ * @see CLL_LINK_OFFSET
+ * @see cll_elem
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct cll_handler *pall_cll_init_intrusive(
+		int (*compare) (const void *d1, const void *d2),
+		void (*destroy) (void *data),
+		int (*ser_data) (pall_fd_t fd, void *data),
+		void *(*unser_data) (pall_fd_t fd),
+		size_t link_offset,
+		const struct pall_mm *mm);
+
 /**
  * @brief
  *   Unitializes and release all resources of a Circular Linked List handler
@@ -417,6 +645,75 @@ DLLIMPORT
 #endif
 int pall_cll_insert(struct cll_handler *h, void *data);
 
+/**
+ * @brief
+ *   Inserts 'count' elements pointed by the array 'data' into the Circular
+ *   Linked List pointed by 'h', leaving the list exactly as 'count' calls to
+ *   pall_cll_insert() would, in array order.
+ *   \n\n
+ *   The nodes are linked into a chain which is spliced into the list at once,
+ *   and the counters are updated once. Pooled lists carve all the nodes from
+ *   a single contiguous block. Lists configured with CONFIG_INSERT_SORTED
+ *   insert the elements one by one.
+ *
+ * @param h
+ *   An initialized Circular Linked List handler.
+ *
+ * @param data
+ *   An array of 'count' pointers to the elements to be inserted.
+ *
+ * @param count
+ *   The number of elements to be inserted.
+ *
+ * @return
+ *   On success, zero is returned and statistical counter 'insert' is
+ *   incremented by 'count'. On error, -1 is returned, statistical counter
+ *   'insert_err' is incremented, and errno is set appropriately. Except for
+ *   sorted lists, where the elements preceding the failed one remain
+ *   inserted, no element is inserted on error.
+ *   \n\n
+ *   Errors: ENOMEM
+ *
+ * @see pall_cll_insert()
+ * @see cll_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_cll_insert_batch(struct cll_handler *h, void **data, ui32_t count);
+
+/**
+ * @brief
+ *   Same as pall_cll_insert(), but also returns a handle to the node holding
+ *   the inserted element on 'handle'. The handle allows the element to be
+ *   removed or moved by pall_cll_delete_handle(), pall_cll_pope_handle() and
+ *   pall_cll_move_to_head_handle() in constant time, without searching the
+ *   list. It remains valid until the element is removed from the list.
+ *
+ * @param h
+ *   An initialized Circular Linked List handler.
+ *
+ * @param data
+ *   A pointer to the element to be inserted.
+ *
+ * @param handle
+ *   A pointer to the location where the node handle is stored on success.
+ *
+ * @return
+ *   Same as pall_cll_insert().
+ *
+ * @see pall_cll_insert()
+ * @see pall_cll_delete_handle()
+ * @see pall_cll_pope_handle()
+ * @see pall_cll_move_to_head_handle()
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_cll_insert_handle(struct cll_handler *h, void *data, struct cll_elem **handle);
+
 /**
  * @brief
  *   Deletes an element that matches the contents of the element pointed by
@@ -445,6 +742,56 @@ DLLIMPORT
 #endif
 int pall_cll_delete(struct cll_handler *h, void *data);
 
+/**
+ * @brief
+ *   Same as pall_cll_delete(), but the element is matched by its key. The
+ *   comparision is performed between 'key' and the key of each element by
+ *   the functions set through pall_cll_set_key().
+ *
+ * @param h
+ *   An initialized Circular Linked List handler.
+ *
+ * @param key
+ *   A pointer to the key of the element to be searched and deleted.
+ *
+ * @return
+ *   Same as pall_cll_delete().
+ *
+ * @see pall_cll_set_key()
+ * @see pall_cll_delete()
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_cll_delete_key(struct cll_handler *h, void *key);
+
+/**
+ * @brief
+ *   Deletes the element held by the node 'handle' from the Circular Linked
+ *   List pointed by 'h' in constant time. The element is released through the
+ *   destroy() function passed to pall_cll_init().
+ *
+ * @param h
+ *   An initialized Circular Linked List handler.
+ *
+ * @param handle
+ *   A node handle of this list, returned by pall_cll_insert_handle(), whose
+ *   element wasn't removed yet.
+ *
+ * @return
+ *   This function always succeeds and statistical counter 'del' is
+ *   incremented.
+ *
+ * @see pall_cll_insert_handle()
+ * @see cll_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_cll_delete_handle(struct cll_handler *h, struct cll_elem *handle);
+
 /**
  * @brief
  *   Searches an element that matches the contents of the element pointed by
@@ -472,6 +819,31 @@ DLLIMPORT
 #endif
 void *pall_cll_search(struct cll_handler *h, void *data);
 
+/**
+ * @brief
+ *   Same as pall_cll_search(), but the element is matched by its key, so no
+ *   partially filled element needs to be built for the lookup. The
+ *   comparision is performed between 'key' and the key of each element by
+ *   the functions set through pall_cll_set_key().
+ *
+ * @param h
+ *   An initialized Circular Linked List handler.
+ *
+ * @param key
+ *   A pointer to the key of the element to be searched.
+ *
+ * @return
+ *   Same as pall_cll_search().
+ *
+ * @see pall_cll_set_key()
+ * @see pall_cll_search()
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_cll_search_key(struct cll_handler *h, void *key);
+
 /**
  * @brief
  *   Serializes the contents of the Circular Linked List pointed by 'h', to
@@ -631,6 +1003,77 @@ DLLIMPORT
 #endif
 void *pall_cll_pope(struct cll_handler *h, void *data);
 
+/**
+ * @brief
+ *   Same as pall_cll_pope(), but the element is matched by its key. The
+ *   comparision is performed between 'key' and the key of each element by
+ *   the functions set through pall_cll_set_key().
+ *
+ * @param h
+ *   An initialized Circular Linked List handler.
+ *
+ * @param key
+ *   A pointer to the key of the element to be searched and popped.
+ *
+ * @return
+ *   Same as pall_cll_pope().
+ *
+ * @see pall_cll_set_key()
+ * @see pall_cll_pope()
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_cll_pope_key(struct cll_handler *h, void *key);
+
+/**
+ * @brief
+ *   Pops the element held by the node 'handle' from the Circular Linked List
+ *   pointed by 'h' in constant time.
+ *
+ * @param h
+ *   An initialized Circular Linked List handler.
+ *
+ * @param handle
+ *   A node handle of this list, returned by pall_cll_insert_handle(), whose
+ *   element wasn't removed yet.
+ *
+ * @return
+ *   A pointer to the popped element is returned and the statistical counter
+ *   'pope' is incremented. This function always succeeds.
+ *
+ * @see pall_cll_insert_handle()
+ * @see cll_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_cll_pope_handle(struct cll_handler *h, struct cll_elem *handle);
+
+/**
+ * @brief
+ *   Moves the element held by the node 'handle' to the head of the Circular
+ *   Linked List pointed by 'h' in constant time, as a search on a list
+ *   configured with CONFIG_SEARCH_LRU does.
+ *
+ * @param h
+ *   An initialized Circular Linked List handler.
+ *
+ * @param handle
+ *   A node handle of this list, returned by pall_cll_insert_handle(), whose
+ *   element wasn't removed yet.
+ *
+ * @see pall_cll_insert_handle()
+ * @see CONFIG_SEARCH_LRU
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_cll_move_to_head_handle(struct cll_handler *h, struct cll_elem *handle);
+
 /**
  * @brief
  *   Pops an element from the head of the Circular Linked List pointed by
@@ -745,7 +1188,7 @@ void pall_cll_rewind(struct cll_handler *h, int to);
  *   Available flags are: CONFIG_SEARCH_FORWARD, CONFIG_SEARCH_BACKWARD,
  *   CONFIG_SEARCH_AUTO, CONFIG_SEARCH_LRU (default), CONFIG_INSERT_SORTED,
  *   CONFIG_INSERT_NEXT, CONFIG_INSERT_PREV, CONFIG_INSERT_TAIL,
- *   CONFIG_INSERT_HEAD (default).
+ *   CONFIG_INSERT_HEAD (default), CONFIG_MM_POOL (default), CONFIG_MM_ARENA.
  *
  * @return
  *   Returns the previously configuration flags before the call to this
@@ -763,6 +1206,8 @@ void pall_cll_rewind(struct cll_handler *h, int to);
  * @see CONFIG_INSERT_PREV
  * @see CONFIG_INSERT_TAIL
  * @see CONFIG_INSERT_HEAD
+ * @see CONFIG_MM_POOL
+ * @see CONFIG_MM_ARENA
  *
  */
 #ifdef COMPILE_WIN32
@@ -794,6 +1239,8 @@ ui32_t pall_cll_set_config(struct cll_handler *h, ui32_t flags);
  * @see CONFIG_INSERT_PREV
  * @see CONFIG_INSERT_TAIL
  * @see CONFIG_INSERT_HEAD
+ * @see CONFIG_MM_POOL
+ * @see CONFIG_MM_ARENA
  *
  */ 
 #ifdef COMPILE_WIN32
@@ -801,5 +1248,75 @@ DLLIMPORT
 #endif
 ui32_t pall_cll_get_config(struct cll_handler *h);
 
+/**
+ * @brief
+ *   Allocates 'size' bytes from the pool of the Circular Linked List pointed by
+ *   handler 'h'. The allocated memory cannot be released individually and is
+ *   released, along with the list elements, by pall_cll_collapse() and
+ *   pall_cll_destroy(). This is intended for elements of handlers configured
+ *   with CONFIG_MM_ARENA.
+ *
+ * @param h
+ *   An initialized Circular Linked List handler.
+ *
+ * @param size
+ *   The number of bytes to be allocated.
+ *
+ * @return
+ *   On success, a pointer to the allocated memory, suitably aligned for any
+ *   type, is returned. On error, NULL is returned and errno is set
+ *   appropriately.
+ *   \n\n
+ *   Errors: ENOMEM, EBUSY (the list isn't empty and its elements were
+ *   allocated before a pool was created).
+ *
+ * @see pall_cll_collapse()
+ * @see CONFIG_MM_ARENA
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_cll_arena_alloc(struct cll_handler *h, size_t size);
+
+/**
+ * @brief
+ *   Sets the functions used by pall_cll_search_key(), pall_cll_delete_key()
+ *   and pall_cll_pope_key() to match elements by key. Until this function is
+ *   called, each element is its own key and keys are compared by the
+ *   compare() function passed to pall_cll_init().
+ *
+ * @param h
+ *   An initialized Circular Linked List handler.
+ *
+ * @param key
+ *   Returns a pointer to the key of the element pointed by 'data'. It is
+ *   usually the address of a member of the element, so no memory is allocated.
+ *   If NULL, along with 'key_compare', the default functions are restored.
+ *
+ * @param key_compare
+ *   Compares the key 'k1' against the key 'k2' and returns zero if they match.
+ *   Otherwise, it returns an integer less than or greater than zero, as
+ *   compare() does for the elements holding those keys.
+ *
+ * @return
+ *   On success, zero is returned. On error, -1 is returned and errno is set
+ *   appropriately.
+ *   \n\n
+ *   Errors: EINVAL (only one of 'key' and 'key_compare' is NULL).
+ *
+ * @see pall_cll_search_key()
+ * @see pall_cll_delete_key()
+ * @see pall_cll_pope_key()
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_cll_set_key(
+		struct cll_handler *h,
+		void *(*key) (void *data),
+		int (*key_compare) (const void *k1, const void *k2));
+
 #endif
 
@@ -0,0 +1,702 @@
+/**
+ * @file fht.h
+ * @brief Portable Abstracted Linked Lists Library (libpall)
+ *        Flat Hash Table interface header
+ *
+ * Date: 16-10-2026
+ *
+ * Copyright 2026 Pedro A. Hortas (pah@ucodev.org)
+ *
+ * This file is part of libpall.
+ *
+ * libpall is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libpall is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libpall.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef LIBPALL_FHT_H
+#define LIBPALL_FHT_H
+
+#include "config.h"
+#include "pall.h"
+#include "mm.h"
+
+/* Constants */
+#define FHT_DEFAULT_ARR_SIZE		128
+#define FHT_MIN_ARR_SIZE		8
+#define FHT_LOAD_FACTOR_NUM		3	/* Grows at 3/4 occupancy */
+#define FHT_LOAD_FACTOR_DEN		4
+
+/* Structures */
+
+/**
+ * @struct fht_slot
+ *
+ * @brief
+ *   A Flat Hash Table slot. Slots are stored inline in the table array and
+ *   shall not be directly modified.
+ *
+ * @var fht_slot::data
+ *   The element stored in this slot, or NULL if the slot is empty.
+ *
+ * @var fht_slot::hash
+ *   The cached (finalized) hash of the element, so that probing compares
+ *   hashes before invoking compare() and the table can be grown without
+ *   invoking hash() again.
+ */
+struct fht_slot {
+	void *data;
+	ui32_t hash;
+};
+
+/**
+ * @struct fht_stat
+ *
+ * @brief
+ *   Statistical counters for table operations and table elements.
+ *
+ * @see pall_fht_stat()
+ * @see pall_fht_stat_reset()
+ *
+ * @var fht_stat::insert
+ *   Number of successful inserts
+ *
+ * @var fht_stat::insert_err
+ *   Number of failed inserts
+ *
+ * @var fht_stat::del
+ *   Number of successful deletes
+ *
+ * @var fht_stat::del_nf
+ *   Number of not found deletes
+ *
+ * @var fht_stat::search
+ *   Number of successful searches
+ *
+ * @var fht_stat::search_nf
+ *   Number of not found searches
+ *
+ * @var fht_stat::serialize
+ *   Number of successful serializations
+ *
+ * @var fht_stat::serialize_err
+ *   Number of failed serializations
+ *
+ * @var fht_stat::unserialize
+ *   Number of successful unserializations
+ *
+ * @var fht_stat::unserialize_err
+ *   Number of failed unserializations
+ *
+ * @var fht_stat::stat
+ *   Number of stat calls
+ *
+ * @var fht_stat::count
+ *   Number of count calls
+ *
+ * @var fht_stat::pope
+ *   Number of successful element pops
+ *
+ * @var fht_stat::pope_nf
+ *   Number of not found elem pops
+ *
+ * @var fht_stat::collapse
+ *   Number of collapse calls
+ *
+ * @var fht_stat::iterate
+ *   Number of full iterations
+ *
+ * @var fht_stat::rewind
+ *   Number of rewind calls
+ *
+ * @var fht_stat::grow
+ *   Number of times the table array was doubled
+ *
+ * @var fht_stat::elem_count_cur
+ *   Current number of elements present on the table
+ *
+ * @var fht_stat::elem_count_max
+ *   Maximum elements since initialization or last stat_reset call.
+ *
+ * @var fht_stat::probe_len_avg
+ *   The average distance, in slots, between the elements and their home slot.
+ *
+ * @var fht_stat::probe_len_max
+ *   The largest distance, in slots, between an element and its home slot.
+ */
+struct fht_stat {
+	/* Operation statistics */
+	unsigned long insert;
+	unsigned long insert_err;
+	unsigned long del;
+	unsigned long del_nf;
+	unsigned long search;
+	unsigned long search_nf;
+	unsigned long serialize;
+	unsigned long serialize_err;
+	unsigned long unserialize;
+	unsigned long unserialize_err;
+	unsigned long stat;
+	unsigned long count;
+	unsigned long pope;
+	unsigned long pope_nf;
+	unsigned long collapse;
+	unsigned long iterate;
+	unsigned long rewind;
+	unsigned long grow;
+
+	/* Element statistics */
+	unsigned long elem_count_cur;
+	unsigned long elem_count_max;
+
+	/* Probe statistics */
+	float probe_len_avg;
+	unsigned long probe_len_max;
+};
+
+/**
+ * @struct fht_handler
+ *
+ * @brief
+ *   Data structure defining the Flat Hash Table handler.
+ *
+ * @var fht_handler::array
+ *   The table array of size 'arr_size'. Each array element is a slot holding
+ *   an element pointer and its cached hash. Collisions are resolved by linear
+ *   probing, so elements are never allocated individually. This array shall
+ *   not be directly modified.
+ *
+ * @var fht_handler::arr_size
+ *   The size of the table array, always a power of two. The array is doubled
+ *   whenever its occupancy exceeds FHT_LOAD_FACTOR_NUM / FHT_LOAD_FACTOR_DEN.
+ *   This value shall not be directly modified.
+ *
+ * @var fht_handler::insert
+ *   Function pointer performing the same operation of pall_fht_insert()
+ *
+ * @var fht_handler::del
+ *   Function pointer performing the same operation of pall_fht_delete()
+ *
+ * @var fht_handler::search
+ *   Function pointer performing the same operation of pall_fht_search()
+ *
+ * @var fht_handler::serialize
+ *   Function pointer performing the same operation of pall_fht_serialize()
+ *
+ * @var fht_handler::unserialize
+ *   Function pointer performing the same operation of pall_fht_unserialize()
+ *
+ * @var fht_handler::stat
+ *   Function pointer performing the same operation of pall_fht_stat()
+ *
+ * @var fht_handler::stat_reset
+ *   Function pointer performing the same operation of pall_fht_stat_reset()
+ *
+ * @var fht_handler::count
+ *   Function pointer performing the same operation of pall_fht_count()
+ *
+ * @var fht_handler::pope
+ *   Function pointer performing the same operation of pall_fht_pope()
+ *
+ * @var fht_handler::collapse
+ *   Function pointer performing the same operation of pall_fht_collapse()
+ *
+ * @var fht_handler::iterate
+ *   Function pointer performing the same operation of pall_fht_iterate()
+ *
+ * @var fht_handler::rewind
+ *   Function pointer performing the same operation of pall_fht_rewind()
+ */
+struct fht_handler {
+	struct fht_slot *array;
+	unsigned int arr_size;
+	ui32_t _count;
+	ui32_t _tombstones;
+	ui32_t _iterate_arr_pos;
+	int _iterate_reverse;
+	int _iterating;
+
+	struct fht_stat _stat;
+	struct pall_mm _mm;
+	int (*compare) (const void *d1, const void *d2);
+	ui32_t (*hash) (void *data);
+	void (*destroy) (void *data);
+	int (*ser_data) (pall_fd_t fd, void *data);
+	void *(*unser_data) (pall_fd_t fd);
+
+	int (*insert) (struct fht_handler *handler, void *data);
+	int (*del) (struct fht_handler *handler, void *data);
+	void *(*search) (struct fht_handler *handler, void *data);
+	int (*serialize) (struct fht_handler *handler, pall_fd_t fd);
+	int (*unserialize) (struct fht_handler *handler, pall_fd_t fd);
+	struct fht_stat *(*stat) (struct fht_handler *handler);
+	void (*stat_reset) (struct fht_handler *handler);
+	ui32_t (*count) (struct fht_handler *handler);
+	void *(*pope) (struct fht_handler *handler, void *data);
+	void (*collapse) (struct fht_handler *handler);
+	void *(*iterate) (struct fht_handler *handler);
+	void (*rewind) (struct fht_handler *handler, int to);
+};
+
+
+/* Prototypes / Interface */
+
+/**
+ * @brief
+ *   Initializes a Flat Hash Table handler.
+ *
+ * @param compare
+ *   Internally used function for element comparision by pall_fht_insert(),
+ *   pall_fht_search() and pall_fht_delete().
+ *   It receives two elements as parameters of type const void *.
+ *   It shall return zero if d1 matches d2, and non-zero otherwise. It is only
+ *   invoked for elements whose hashes match.
+ *
+ * @param destroy
+ *   Internally used function for memory deallocation, on pall_fht_delete() and
+ *   pall_fht_collapse(), of the element pointed by its parameter of type
+ *   void *.
+ *
+ * @param hash
+ *   Internally used function for element hashing. This function shall receive
+ *   a pointer to the element to be hashed and returns a 32-bit integer. The
+ *   returned value is passed through an avalanche finalizer and cached in the
+ *   table, so hash() is invoked once per inserted element and once per lookup.
+ *
+ * @param ser_data
+ *   Internally used function for element serialization.
+ *   This is an optional argument and NULL shall be used to disable
+ *   serialization support, causing serialization calls
+ *   (pall_fht_serialize()) to fail, setting errno to ENOSYS.
+ *
+ * @param unser_data
+ *   Internally used function for element unserialization.
+ *   This is an optional argument and NULL shall be used to disable
+ *   unserialization support, causing unserialization calls
+ *   (pall_fht_unserialize()) to fail, setting errno to ENOSYS.
+ *
+ * @param array_size
+ *   The initial size of the table array, rounded up to a power of two not
+ *   lower than FHT_MIN_ARR_SIZE. If this parameter is set to zero, the default
+ *   value defined by FHT_DEFAULT_ARR_SIZE is used.
+ *
+ * @return
+ *   On success, a pointer to a valid Flat Hash Table handler is returned.
+ *   On error, NULL is returned, and errno is set appropriately.
+ *   \n\n
+ *   Errors: EINVAL, ENOMEM, ERANGE
+ *
+ * @see pall_fht_insert()
+ * @see pall_fht_search()
+ * @see pall_fht_delete()
+ * @see pall_fht_serialize()
+ * @see pall_fht_unserialize()
+ * @see pall_fht_destroy()
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct fht_handler *pall_fht_init(
+		int (*compare) (const void *d1, const void *d2),
+		void (*destroy) (void *data),
+		ui32_t (*hash) (void *data),
+		int (*ser_data) (pall_fd_t fd, void *data),
+		void *(*unser_data) (pall_fd_t fd),
+		unsigned int array_size);
+
+/**
+ * @brief
+ *   Initializes a Flat Hash Table handler that performs all of its memory
+ *   allocations through the allocator pointed by 'mm'.
+ *
+ * @param compare
+ *   Same as pall_fht_init().
+ *
+ * @param destroy
+ *   Same as pall_fht_init().
+ *
+ * @param hash
+ *   Same as pall_fht_init().
+ *
+ * @param ser_data
+ *   Same as pall_fht_init().
+ *
+ * @param unser_data
+ *   Same as pall_fht_init().
+ *
+ * @param array_size
+ *   Same as pall_fht_init().
+ *
+ * @param mm
+ *   The allocator to be used by this handler. The structure is copied. If NULL,
+ *   the current default allocator is used.
+ *
+ * @return
+ *   On success, a pointer to a valid Flat Hash Table handler is returned.
+ *   On error, NULL is returned, and errno is set appropriately.
+ *   \n\n
+ *   Errors: EINVAL, ENOMEM, ERANGE
+ *
+ * @see pall_fht_init()
+ * @see pall_mm_set_allocator()
+ * @see pall_mm
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct fht_handler *pall_fht_init_mm(
+		int (*compare) (const void *d1, const void *d2),
+		void (*destroy) (void *data),
+		ui32_t (*hash) (void *data),
+		int (*ser_data) (pall_fd_t fd, void *data),
+		void *(*unser_data) (pall_fd_t fd),
+		unsigned int array_size,
+		const struct pall_mm *mm);
+
+/**
+ * @brief
+ *   Unitializes and release all resources of a Flat Hash Table handler
+ *   pointed by parameter 'h'.
+ *
+ * @see pall_fht_init()
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_fht_destroy(struct fht_handler *h);
+
+/**
+ * @brief
+ *   Inserts an element pointed by 'data' into the Flat Hash Table pointed by
+ *   'h'. Duplicate elements are not checked for.
+ *
+ * @param h
+ *   An initialized Flat Hash Table handler.
+ *
+ * @param data
+ *   A pointer to the element to be inserted. Shall not be NULL.
+ *
+ * @return
+ *   On success, zero is returned and statistical counter 'insert' is
+ *   incremented. On error, -1 is returned, statistical counter 'insert_err' is
+ *   incremented, and errno is set appropriately.
+ *   \n\n
+ *   Errors: EINVAL, ENOMEM, ERANGE
+ *
+ * @see pall_fht_init()
+ * @see pall_fht_delete()
+ * @see pall_fht_search()
+ * @see fht_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_fht_insert(struct fht_handler *h, void *data);
+
+/**
+ * @brief
+ *   Deletes an element that matches the contents of the element pointed by
+ *   'data' from the Flat Hash Table pointed by 'h'. The comparision of the
+ *   elements is performed by the compare() function passed to pall_fht_init()
+ *   function.
+ *
+ * @param h
+ *   An initialized Flat Hash Table handler.
+ *
+ * @param data
+ *   A pointer to the partially filled element to be searched and deleted.
+ *
+ * @return
+ *   On success, zero is returned and statistical counter 'del' is incremented.
+ *   If the element is not found, -1 is returned and statistical counter
+ *   'del_nf' is incremented.
+ *
+ * @see pall_fht_init()
+ * @see pall_fht_insert()
+ * @see fht_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_fht_delete(struct fht_handler *h, void *data);
+
+/**
+ * @brief
+ *   Searches an element that matches the contents of the element pointed by
+ *   'data' on the Flat Hash Table pointed by 'h'. The comparision of the
+ *   elements is performed by the compare() function passed to pall_fht_init()
+ *   function.
+ *
+ * @param h
+ *   An initialized Flat Hash Table handler.
+ *
+ * @param data
+ *   A pointer to the partially filled element to be searched.
+ *
+ * @return
+ *   On success, a pointer to the found element is returned and statistical
+ *   counter 'search' is incremented. If the element is not found, NULL is
+ *   returned and statistical counter 'search_nf' is incremented.
+ *
+ * @see pall_fht_init()
+ * @see fht_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_fht_search(struct fht_handler *h, void *data);
+
+/**
+ * @brief
+ *   Serializes the contents of the Flat Hash Table pointed by 'h', to the file
+ *   descriptor 'fd'.
+ *   The metadata of the table (the element count) is serialized in network
+ *   byte order, followed by the elements.
+ *   Each element is serialized through the ser_data() function passed to
+ *   pall_fht_init(). If this parameter was passed as NULL, this function
+ *   will return error with errno set to ENOSYS.
+ *   The pall_fd_t type is a compatible type to the file descriptor type of the
+ *   system.
+ *
+ * @param h
+ *   An initialized Flat Hash Table handler.
+ *
+ * @param fd
+ *   A writable file descriptor.
+ *
+ * @return
+ *   On success, zero is returned and statistical counter 'serialize' is
+ *   incremented. On error, -1 is returned, statistical 'serialize_err' is
+ *   incremented, and errno is set appropriately.
+ *   \n\n
+ *   Errors: Same as write() and ENOSYS.
+ *
+ * @see pall_fht_init()
+ * @see pall_fht_unserialize()
+ * @see fht_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_fht_serialize(struct fht_handler *h, pall_fd_t fd);
+
+/**
+ * @brief
+ *   Unserializes the contents from the file descriptor 'fd' into the Flat
+ *   Hash Table pointed by 'h'.
+ *   The unserialized data is converted from network byte order to host byte
+ *   order.
+ *   Each element is serialized through the unser_data() function passed to
+ *   pall_fht_init(). If this parameter was passed as NULL, this function
+ *   will return error with errno set to ENOSYS.
+ *   The pall_fd_t type is a compatible type to the file descriptor type of the
+ *   system.
+ *
+ * @param h
+ *   An initialized Flat Hash Table handler.
+ *
+ * @param fd
+ *   A readable file descriptor.
+ *
+ * @return
+ *   On success, zero is returned and statistical counter 'unserialize' is
+ *   incremented. On error, -1 is returned, statistical counter
+ *   'unserialize_err' is incremented and, errno is set appropriately.
+ *   \n\n
+ *   Errors: Same as read() and ENOSYS.
+ *
+ * @see pall_fht_init()
+ * @see pall_fht_serialize()
+ * @see fht_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_fht_unserialize(struct fht_handler *h, pall_fd_t fd);
+
+/**
+ * @brief
+ *   Returns statistical information for operations and content of the Flat
+ *   Hash Table pointed by handler 'h'. This function shall be called for
+ *   each time updated statistical counters are required.
+ *
+ * @param h
+ *   An initialized Flat Hash Table handler.
+ *
+ * @return
+ *   Returns a pointer to a valid struct fht_stat and the statistical
+ *   counter 'stat' is incremented. This function always succeeds.
+ *
+ * @see pall_fht_init()
+ * @see pall_fht_stat_reset()
+ * @see fht_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct fht_stat *pall_fht_stat(struct fht_handler *h);
+
+/**
+ * @brief
+ *   Resets the statistical counters of the Flat Hash Table pointed by handler
+ *   'h'.
+ *
+ * @param h
+ *   An initialized Flat Hash Table handler.
+ *
+ * @see pall_fht_init()
+ * @see pall_fht_stat()
+ * @see fht_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_fht_stat_reset(struct fht_handler *h);
+
+/**
+ * @brief
+ *   Returns the number of elements of the Flat Hash Table pointed by handler
+ *   'h'.
+ *
+ * @param h
+ *   An initialized Flat Hash Table handler.
+ *
+ * @return
+ *   Returns a positive integer of type ui32_t (32 bit unsigned) if the table
+ *   isn't empty. If it's empty, zero is returned. Statistical counter 'count'
+ *   is always incremented when this function retruns.
+ *
+ * @see pall_fht_init()
+ * @see fht_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_fht_count(struct fht_handler *h);
+
+/**
+ * @brief
+ *   Pops an element that matches the contents of the element pointed by 'data'
+ *   from the Flat Hash Table pointed by handler 'h'. The comparision of the
+ *   elements is performed by the compare() function passed to pall_fht_init()
+ *   function.
+ *
+ * @param h
+ *   An initialized Flat Hash Table handler.
+ *
+ * @param data
+ *   A pointer to the partially filled element to be searched and popped.
+ *
+ * @return
+ *   On success, a pointer to the popped element is returned and the
+ *   statistical counter 'pope' is incremented. If the element is not found,
+ *   NULL is returned and the statistical counter 'pope_nf' is incremented.
+ *
+ * @see pall_fht_init()
+ * @see fht_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_fht_pope(struct fht_handler *h, void *data);
+
+/**
+ * @brief
+ *   Removes all the elements from the Flat Hash Table pointed by handler 'h'.
+ *
+ * @param h
+ *   An initialized Flat Hash Table handler.
+ *
+ * @return
+ *   This function doesn't return any value. The statistical counter 'collapse'
+ *   is incremented on return.
+ *
+ * @see pall_fht_init()
+ * @see pall_fht_delete()
+ * @see fht_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_fht_collapse(struct fht_handler *h);
+
+/**
+ * @brief
+ *   Iterates the Flat Hash Table pointed by handler 'h', in array order.
+ *   Elements may be deleted or popped while iterating: their slots are only
+ *   reclaimed once the iteration completes or pall_fht_rewind() is called, so
+ *   the remaining elements are still returned exactly once. Elements inserted
+ *   while iterating may or may not be returned, and if the insertion grows the
+ *   table, the iteration order is lost.
+ *
+ * @param h
+ *   An initialized Flat Hash Table handler.
+ *
+ * @return
+ *   Returns a pointer to the next element. If there are no more elements to
+ *   be iterated, NULL is returned and statistical counter 'iterate' is
+ *   incremented.
+ *
+ * @see pall_fht_rewind()
+ * @see fht_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_fht_iterate(struct fht_handler *h);
+
+/**
+ * @brief
+ *   Rewinds the Flat Hash Table pointed by handler 'h'. The parameter 'to'
+ *   tells to where the rewind should be performed.
+ *
+ * @param h
+ *   An initialized Flat Hash Table handler.
+ *
+ * @param to
+ *   If set to 0, the table is rewinded to array index zero and
+ *   pall_fht_iterate() will iterate the table from array index zero to
+ *   arr_size - 1.
+ *   \n\n
+ *   If set to 1, the table is rewinded to array index arr_size - 1 and
+ *   pall_fht_iterate() will iterate the table from array index arr_size - 1
+ *   to zero.
+ *
+ * @return
+ *   No value is returned and statistical counter 'rewind' is incremented.
+ *
+ * @see pall_fht_iterate()
+ * @see fht_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_fht_rewind(struct fht_handler *h, int to);
+
+#endif
+
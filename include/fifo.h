@@ -29,6 +29,7 @@
 
 #include "config.h"
 #include "pall.h"
+#include "mm.h"
 #include "cll.h"
 
 
@@ -119,6 +120,9 @@ struct fifo_stat {
  * @var fifo_handler::push
  *   Function pointer performing the same operation of pall_fifo_push()
  *
+ * @var fifo_handler::push_batch
+ *   Function pointer performing the same operation of pall_fifo_push_batch()
+ *
  * @var fifo_handler::pop
  *   Function pointer performing the same operation of pall_fifo_pop()
  *
@@ -150,12 +154,14 @@ struct fifo_stat {
 struct fifo_handler {
 	struct cll_handler *fifo;
 	struct fifo_stat _stat;
+	struct pall_mm _mm;
 
 	void (*destroy) (void *data);
 	int (*ser_data) (pall_fd_t fd, void *data);
 	void *(*unser_data) (pall_fd_t fd);
 
 	int (*push) (struct fifo_handler *handler, void *data);
+	int (*push_batch) (struct fifo_handler *handler, void **data, ui32_t count);
 	void *(*pop) (struct fifo_handler *handler);
 	int (*serialize) (struct fifo_handler *handler, pall_fd_t fd);
 	int (*unserialize) (struct fifo_handler *handler, pall_fd_t fd);
@@ -212,6 +218,45 @@ struct fifo_handler *pall_fifo_init(
 		int (*ser_data) (pall_fd_t fd, void *data),
 		void *(*unser_data) (pall_fd_t fd));
 
+/**
+ * @brief
+ *   Initializes a First In First Out queue handler that performs all of
+ *   its memory allocations through the allocator pointed by 'mm'.
+ *
+ * @param destroy
+ *   Same as pall_fifo_init().
+ *
+ * @param ser_data
+ *   Same as pall_fifo_init().
+ *
+ * @param unser_data
+ *   Same as pall_fifo_init().
+ *
+ * @param mm
+ *   The allocator to be used by this handler. The structure is copied. If NULL,
+ *   the current default allocator is used.
+ *
+ * @return
+ *   On success, a pointer to a valid First In First Out queue handler is
+ *   returned.
+ *   On error, NULL is returned, and errno is set appropriately.
+ *   \n\n
+ *   Errors: EINVAL, ENOMEM
+ *
+ * @see pall_fifo_init()
+ * @see pall_mm_set_allocator()
+ * @see pall_mm
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct fifo_handler *pall_fifo_init_mm(
+		void (*destroy) (void *data),
+		int (*ser_data) (pall_fd_t fd, void *data),
+		void *(*unser_data) (pall_fd_t fd),
+		const struct pall_mm *mm);
+
 /**
  * @brief
  *   Unitializes and release all resources of a First In First Out queue handler
@@ -253,6 +298,39 @@ DLLIMPORT
 #endif
 int pall_fifo_push(struct fifo_handler *h, void *data);
 
+/**
+ * @brief
+ *   Pushes 'count' elements pointed by the array 'data' into the First In First Out queue
+ *   handler pointed by 'h', leaving the queue exactly as 'count' calls to
+ *   pall_fifo_push() would, in array order. The nodes are allocated from a
+ *   single block and linked into the queue at once.
+ *
+ * @param h
+ *   An initialized First In First Out queue handler.
+ *
+ * @param data
+ *   An array of 'count' pointers to the elements to be pushed.
+ *
+ * @param count
+ *   The number of elements to be pushed.
+ *
+ * @return
+ *   On success, zero is returned and statistical counter 'push' is
+ *   incremented by 'count'. On error, -1 is returned, statistical counter
+ *   'push_err' is incremented, no element is pushed, and errno is set
+ *   appropriately.
+ *   \n\n
+ *   Errors: ENOMEM
+ *
+ * @see pall_fifo_push()
+ * @see fifo_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_fifo_push_batch(struct fifo_handler *h, void **data, ui32_t count);
+
 /**
  * @brief
  *   Pops an element from the First In First Out queue pointed by 'h'.
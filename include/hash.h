@@ -0,0 +1,256 @@
+/**
+ * @file hash.h
+ * @brief Portable Abstracted Linked Lists Library (libpall)
+ *        Hashing interface header
+ *
+ * Date: 16-10-2026
+ *
+ * Copyright 2026 Pedro A. Hortas (pah@ucodev.org)
+ *
+ * This file is part of libpall.
+ *
+ * libpall is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libpall is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libpall.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef LIBPALL_HASH_H
+#define LIBPALL_HASH_H
+
+#include <stddef.h>
+
+#include "config.h"
+#include "pall.h"
+
+/* Adapters */
+
+/**
+ * @brief
+ *   Defines a static function 'name', usable as the hash() argument of the
+ *   pall_*_init() functions, hashing 'length' bytes located 'offset' bytes
+ *   past the start of each element with pall_hash_bytes().
+ *
+ * @see PALL_HASH_DEFINE_MEMBER
+ */
+#define PALL_HASH_DEFINE_BYTES(name, offset, length) \
+	static ui32_t name(void *data) { \
+		return pall_hash_bytes((const char *) data + (offset), (length), 0); \
+	}
+
+/**
+ * @brief
+ *   Defines a static hash function 'name' hashing all the bytes of 'member'
+ *   of structure 'type' with pall_hash_bytes(). Structure members containing
+ *   padding shall be zeroed before being populated.
+ */
+#define PALL_HASH_DEFINE_MEMBER(name, type, member) \
+	PALL_HASH_DEFINE_BYTES(name, offsetof(type, member), sizeof(((type *) 0)->member))
+
+/**
+ * @brief
+ *   Defines a static hash function 'name' hashing the integer 'member' (up to
+ *   32 bits wide) of structure 'type' with pall_hash_u32().
+ */
+#define PALL_HASH_DEFINE_U32(name, type, member) \
+	static ui32_t name(void *data) { \
+		return pall_hash_u32((ui32_t) ((type *) data)->member); \
+	}
+
+/**
+ * @brief
+ *   Defines a static hash function 'name' hashing the integer 'member' (up to
+ *   64 bits wide) of structure 'type' with pall_hash_u64().
+ */
+#define PALL_HASH_DEFINE_U64(name, type, member) \
+	static ui32_t name(void *data) { \
+		return pall_hash_u64((ui64_t) ((type *) data)->member); \
+	}
+
+/**
+ * @brief
+ *   Defines a static hash function 'name' hashing the NUL terminated string
+ *   'member' of structure 'type', which may either be a character array or a
+ *   pointer, with pall_hash_str().
+ */
+#define PALL_HASH_DEFINE_STR(name, type, member) \
+	static ui32_t name(void *data) { \
+		return pall_hash_str(((type *) data)->member, 0); \
+	}
+
+/**
+ * @brief
+ *   Same as PALL_HASH_DEFINE_BYTES(), but hashing with pall_hash_crc32c().
+ */
+#define PALL_HASH_DEFINE_CRC32C(name, offset, length) \
+	static ui32_t name(void *data) { \
+		return pall_hash_crc32c((const char *) data + (offset), (length), 0); \
+	}
+
+
+/* Prototypes / Interface */
+
+/**
+ * @brief
+ *   Hashes a 32-bit integer. All the input bits affect all the output bits,
+ *   so sequential or aligned keys are evenly distributed.
+ *
+ * @param key
+ *   The integer to be hashed.
+ *
+ * @return
+ *   The 32-bit hash of 'key'.
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_hash_u32(ui32_t key);
+
+/**
+ * @brief
+ *   Hashes a 64-bit integer. All the input bits affect all the output bits.
+ *
+ * @param key
+ *   The integer to be hashed.
+ *
+ * @return
+ *   The 32-bit hash of 'key'.
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_hash_u64(ui64_t key);
+
+/**
+ * @brief
+ *   Hashes a sequence of bytes. The function follows the wyhash design: the
+ *   input is consumed 8 bytes at a time in three independent multiply-mix
+ *   lanes, so long keys are hashed at memory speed, and short keys (up to 16
+ *   bytes) take a single branch and two multiplications.
+ *   \n\n
+ *   The result doesn't depend on the host endianness or on the alignment of
+ *   'key'.
+ *
+ * @param key
+ *   The bytes to be hashed.
+ *
+ * @param len
+ *   The number of bytes to be hashed.
+ *
+ * @param seed
+ *   An arbitrary value selecting a different hash function. Zero may be used
+ *   when there is no need to randomize the hashes.
+ *
+ * @return
+ *   The 32-bit hash of 'key'.
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_hash_bytes(const void *key, size_t len, ui32_t seed);
+
+/**
+ * @brief
+ *   Hashes a NUL terminated string, excluding the terminator. Same as calling
+ *   pall_hash_bytes(str, strlen(str), seed).
+ *
+ * @param str
+ *   The string to be hashed.
+ *
+ * @param seed
+ *   See pall_hash_bytes().
+ *
+ * @return
+ *   The 32-bit hash of 'str'.
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_hash_str(const char *str, ui32_t seed);
+
+/**
+ * @brief
+ *   Computes the CRC32C (Castagnoli) checksum of a sequence of bytes. On x86
+ *   processors supporting SSE4.2, detected at runtime, the crc32 instruction
+ *   is used. Other hosts use a table driven implementation.
+ *   \n\n
+ *   CRC32C has weaker mixing than pall_hash_bytes() and is mainly useful when
+ *   the checksum itself is required. Its low bits are well distributed, but
+ *   CONFIG_HASH_MASK remixes it anyway.
+ *
+ * @param key
+ *   The bytes to be checksummed.
+ *
+ * @param len
+ *   The number of bytes to be checksummed.
+ *
+ * @param seed
+ *   A previously returned checksum, to continue a checksum over several
+ *   calls, or zero.
+ *
+ * @return
+ *   The CRC32C of 'key'.
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_hash_crc32c(const void *key, size_t len, ui32_t seed);
+
+
+/* Internal interface */
+
+/*
+ * MurmurHash3 32-bit finalizer. Every input bit affects every output bit, so
+ * weak user hashes (e.g. identity hashes of sequential keys) can be reduced
+ * with a mask without clustering on the low bits.
+ */
+static inline ui32_t hash_fmix32(ui32_t h) {
+	h ^= h >> 16;
+	h *= 0x85ebca6b;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35;
+	h ^= h >> 16;
+
+	return h;
+}
+
+/* MurmurHash3 64-bit finalizer */
+static inline ui64_t hash_fmix64(ui64_t h) {
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+
+	return h;
+}
+
+/* Returns the lowest power of two greater than or equal to 'n', or zero if
+ * it isn't representable.
+ */
+static inline ui32_t hash_pow2_ceil(ui32_t n) {
+	ui32_t p = 1;
+
+	while (p && (p < n))
+		p <<= 1;
+
+	return p;
+}
+
+#endif
+
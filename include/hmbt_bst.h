@@ -29,10 +29,13 @@
 
 #include "config.h"
 #include "pall.h"
+#include "mm.h"
 #include "bst.h"
+#include "lenhist.h"
 
 /* Constants */
 #define HMBT_BST_DEFAULT_ARR_SIZE	127
+#define HMBT_BST_BATCH_SIZE		16
 
 /* Structures */
 
@@ -90,6 +93,15 @@
  * @var hmbt_bst_stat::rewind
  *   Number of rewind calls
  *
+ * @var hmbt_bst_stat::range
+ *   Number of range calls
+ *
+ * @var hmbt_bst_stat::set_config
+ *   Number of set_config calls
+ *
+ * @var hmbt_bst_stat::get_config
+ *   Number of get_config calls
+ *
  * @var hmbt_bst_stat::elem_count_cur
  *   Current number of elements present on the tree
  *
@@ -127,6 +139,9 @@ struct hmbt_bst_stat {
 	unsigned long collapse;
 	unsigned long iterate;
 	unsigned long rewind;
+	unsigned long range;
+	unsigned long set_config;
+	unsigned long get_config;
 
 	/* Element statistics */
 	unsigned long elem_count_cur;
@@ -161,6 +176,10 @@ struct hmbt_bst_stat {
  * @var hmbt_bst_handler::search
  *   Function pointer performing the same operation of pall_hmbt_bst_search()
  *
+ * @var hmbt_bst_handler::search_batch
+ *   Function pointer performing the same operation of
+ *   pall_hmbt_bst_search_batch()
+ *
  * @var hmbt_bst_handler::serialize
  *   Function pointer performing the same operation of pall_hmbt_bst_serialize()
  *
@@ -197,6 +216,9 @@ struct hmbt_bst_stat {
  * @var hmbt_bst_handler::rewind
  *   Function pointer performing the same operation of pall_hmbt_bst_rewind()
  *
+ * @var hmbt_bst_handler::range
+ *   Function pointer performing the same operation of pall_hmbt_bst_range()
+ *
  * @var hmbt_bst_handler::set_config
  *   Function pointer performing the same operation of
  *   pall_hmbt_bst_set_config()
@@ -209,10 +231,17 @@ struct hmbt_bst_stat {
 struct hmbt_bst_handler {
 	struct bst_handler **array;
 	unsigned int arr_size;
+	unsigned long *_occupied;
+	ui32_t _count;
+	ui32_t _config_flags;
 	ui32_t _iterate_arr_pos;
 	int _iterate_reverse;
+	int _iterate_started;
+	int _iterate_range;
+	struct lenhist _lenhist;
 
 	struct hmbt_bst_stat _stat;
+	struct pall_mm _mm;
 	int (*compare) (const void *d1, const void *d2);
 	ui32_t (*hash) (void *data);
 	void (*destroy) (void *data);
@@ -222,6 +251,7 @@ struct hmbt_bst_handler {
 	int (*insert) (struct hmbt_bst_handler *handler, void *data);
 	int (*del) (struct hmbt_bst_handler *handler, void *data);
 	void *(*search) (struct hmbt_bst_handler *handler, void *data);
+	ui32_t (*search_batch) (struct hmbt_bst_handler *handler, void **keys, void **results, ui32_t n);
 	int (*serialize) (struct hmbt_bst_handler *handler, pall_fd_t fd);
 	int (*unserialize) (struct hmbt_bst_handler *handler, pall_fd_t fd);
 	struct hmbt_bst_stat *(*stat) (struct hmbt_bst_handler *handler);
@@ -230,6 +260,9 @@ struct hmbt_bst_handler {
 	void (*collapse) (struct hmbt_bst_handler *handler);
 	void *(*iterate) (struct hmbt_bst_handler *handler);
 	void (*rewind) (struct hmbt_bst_handler *handler, int to);
+	void (*range) (struct hmbt_bst_handler *handler, void *lo, void *hi);
+	ui32_t (*set_config) (struct hmbt_bst_handler *handler, ui32_t flags);
+	ui32_t (*get_config) (struct hmbt_bst_handler *handler);
 };
 
 
@@ -305,6 +338,57 @@ struct hmbt_bst_handler *pall_hmbt_bst_init(
 		void *(*unser_data) (pall_fd_t fd),
 		unsigned int array_size);
 
+/**
+ * @brief
+ *   Initializes a Hash Mod Balanced Tree BST handler that performs all of
+ *   its memory allocations through the allocator pointed by 'mm'.
+ *
+ * @param compare
+ *   Same as pall_hmbt_bst_init().
+ *
+ * @param destroy
+ *   Same as pall_hmbt_bst_init().
+ *
+ * @param hash
+ *   Same as pall_hmbt_bst_init().
+ *
+ * @param ser_data
+ *   Same as pall_hmbt_bst_init().
+ *
+ * @param unser_data
+ *   Same as pall_hmbt_bst_init().
+ *
+ * @param array_size
+ *   Same as pall_hmbt_bst_init().
+ *
+ * @param mm
+ *   The allocator to be used by this handler. The structure is copied. If NULL,
+ *   the current default allocator is used.
+ *
+ * @return
+ *   On success, a pointer to a valid Hash Mod Balanced Tree BST handler is
+ *   returned.
+ *   On error, NULL is returned, and errno is set appropriately.
+ *   \n\n
+ *   Errors: EINVAL, ENOMEM
+ *
+ * @see pall_hmbt_bst_init()
+ * @see pall_mm_set_allocator()
+ * @see pall_mm
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct hmbt_bst_handler *pall_hmbt_bst_init_mm(
+		int (*compare) (const void *d1, const void *d2),
+		void (*destroy) (void *data),
+		ui32_t (*hash) (void *data),
+		int (*ser_data) (pall_fd_t fd, void *data),
+		void *(*unser_data) (pall_fd_t fd),
+		unsigned int array_size,
+		const struct pall_mm *mm);
+
 /**
  * @brief
  *   Unitializes and release all resources of a Hash Mod Balanced Tree BST handler
@@ -402,6 +486,43 @@ DLLIMPORT
 #endif
 void *pall_hmbt_bst_search(struct hmbt_bst_handler *h, void *data);
 
+/**
+ * @brief
+ *   Searches 'n' elements at once on the Hash Mod Balanced Tree BST pointed
+ *   by 'h', with the same results of calling pall_hmbt_bst_search() for each
+ *   of them.
+ *   \n\n
+ *   Keys are processed in groups of HMBT_BST_BATCH_SIZE: all the keys of a
+ *   group are hashed and their array positions prefetched, followed by their
+ *   BST handlers and then the BST root nodes, before the lookups are
+ *   resolved. Keys mapping to empty BSTs are resolved without touching them.
+ *
+ * @param h
+ *   An initialized Hash Mod Balanced Tree BST handler.
+ *
+ * @param keys
+ *   An array of 'n' pointers to the partially filled elements to be searched.
+ *
+ * @param results
+ *   An array of 'n' pointers, where the found elements are stored. Elements
+ *   not found are stored as NULL.
+ *
+ * @param n
+ *   The number of elements to be searched.
+ *
+ * @return
+ *   The number of elements found. Statistical counters 'search' and
+ *   'search_nf' are updated for each element.
+ *
+ * @see pall_hmbt_bst_search()
+ * @see hmbt_bst_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_hmbt_bst_search_batch(struct hmbt_bst_handler *h, void **keys, void **results, ui32_t n);
+
 /**
  * @brief
  *   Serializes the contents of the Hash Mod Balanced Tree BST pointed by 'h',
@@ -483,10 +604,15 @@ int pall_hmbt_bst_unserialize(struct hmbt_bst_handler *h, pall_fd_t fd);
  * @return
  *   Returns a pointer to a valid struct hmbt_bst_stat and the statistical
  *   counter 'stat' is incremented. This function always succeeds.
+ *   \n\n
+ *   Operation counters are kept by the HMBT-BST handler itself, so indexed
+ *   BSTs are only visited to gather the per node distribution. This pass is
+ *   skipped if the handler is configured with CONFIG_STAT_INCREMENTAL.
  *
  * @see pall_hmbt_bst_init()
  * @see pall_hmbt_bst_stat_reset()
  * @see hmbt_bst_stat
+ * @see CONFIG_STAT_INCREMENTAL
  *
  */
 #ifdef COMPILE_WIN32
@@ -564,6 +690,8 @@ void pall_hmbt_bst_collapse(struct hmbt_bst_handler *h);
  *   zero to arr_size, depth-first, left-to-right for each indexed BST, or from
  *   arr_size to zero, depth-first, right-to-left for each indexed BST,
  *   depending on the parameters used on the pall_hmbt_bst_rewind() function.
+ *   Empty BSTs are skipped, and each BST is only rewound once the iteration
+ *   reaches it.
  *   Rewind and iterate do not affect the behavior of any other operation.
  *
  * @param h
@@ -596,11 +724,11 @@ void *pall_hmbt_bst_iterate(struct hmbt_bst_handler *h);
  *
  * @param to
  *   If set to 0, the tree is rewinded to array index zero, and each BST is
- *   rewinded to root. pall_hmbt_bst_iterate() will iterate the tree from array
+ *   rewinded to root when the iteration reaches it. pall_hmbt_bst_iterate() will iterate the tree from array
  *   index zero to arr_size and each indexed BST from depth-first,
  *   left-to-right.
  *   If set to 1, the tree is rewinded to arr_size index, and each BST is
- *   rewinded to root. pall_hmbt_bst_iterate() will iterate the tree from array
+ *   rewinded to root when the iteration reaches it. pall_hmbt_bst_iterate() will iterate the tree from array
  *   index arr_size to zero and each indexed BST from depth-first,
  *   right-to-left.
  *
@@ -618,5 +746,99 @@ DLLIMPORT
 #endif
 void pall_hmbt_bst_rewind(struct hmbt_bst_handler *h, int to);
 
+/**
+ * @brief
+ *   Rewinds the Hash Mod Balanced Tree BST pointed by handler 'h' to the range
+ *   of elements not lower than 'lo' and lower than 'hi' held by the BST
+ *   indexed by the hash of 'lo'. The following calls to
+ *   pall_hmbt_bst_iterate() return the elements of that range in ascending
+ *   order, and NULL once the range is exhausted, so that k elements are
+ *   visited in O(log n + k) time, where n is the element count of the indexed
+ *   BST. Other BSTs are not visited.
+ *   \n\n
+ *   As elements are spread by their hash, a range only covers all the matching
+ *   elements of the HMBT-BST when the hash() function depends solely on a key
+ *   prefix that is shared by 'lo', 'hi' and all the elements between them, and
+ *   by which compare() orders first (e.g., hashing sessions by user and
+ *   comparing them by user and then by expiry time).
+ *
+ * @param h
+ *   An initialized Hash Mod Balanced Tree BST handler.
+ *
+ * @param lo
+ *   A pointer to the partially filled element bounding the range from below,
+ *   inclusive. It selects the indexed BST to be scanned and shall not be NULL.
+ *
+ * @param hi
+ *   Same as pall_bst_range().
+ *
+ * @return
+ *   No value is returned and statistical counter 'range' is incremented for
+ *   each time this function returns.
+ *
+ * @see pall_bst_range()
+ * @see pall_hmbt_bst_iterate()
+ * @see hmbt_bst_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_hmbt_bst_range(struct hmbt_bst_handler *h, void *lo, void *hi);
+
+/**
+ * @brief
+ *   Sets a new configuration based on 'flags' parameter to the Hash Mod
+ *   Balanced Tree pointed by handler 'h'.
+ *
+ * @param h
+ *   An initialized Hash Mod Balanced Tree handler.
+ *
+ * @param flags
+ *   The configuration flags that will affect the behavior of the tree.
+ *   Available flags are: CONFIG_MM_POOL (default), CONFIG_MM_ARENA,
+ *   CONFIG_HASH_MASK and CONFIG_STAT_INCREMENTAL. Memory management flags are
+ *   applied to each indexed BST (see pall_bst_set_config()).
+ *
+ * @return
+ *   Returns the previous configuration flags and statistical counter
+ *   'set_config' is incremented.
+ *
+ * @see pall_hmbt_bst_init()
+ * @see pall_hmbt_bst_get_config()
+ * @see hmbt_bst_stat
+ * @see CONFIG_MM_POOL
+ * @see CONFIG_MM_ARENA
+ * @see CONFIG_HASH_MASK
+ * @see CONFIG_STAT_INCREMENTAL
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_hmbt_bst_set_config(struct hmbt_bst_handler *h, ui32_t flags);
+
+/**
+ * @brief
+ *   Gets the current configuration flags from the Hash Mod Balanced Tree
+ *   pointed by handler 'h'.
+ *
+ * @param h
+ *   An initialized Hash Mod Balanced Tree handler.
+ *
+ * @return
+ *   Returns the current configuration flags set to the tree and statistical
+ *   counter 'get_config' is incremented.
+ *
+ * @see pall_hmbt_bst_init()
+ * @see pall_hmbt_bst_set_config()
+ * @see hmbt_bst_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_hmbt_bst_get_config(struct hmbt_bst_handler *h);
+
 #endif
 
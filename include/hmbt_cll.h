@@ -29,13 +29,74 @@
 
 #include "config.h"
 #include "pall.h"
+#include "mm.h"
 #include "cll.h"
+#include "avl.h"
+#include "bloom.h"
+#include "lenhist.h"
 
 /* Constants */
 #define HMBT_CLL_DEFAULT_ARR_SIZE	127
+#define HMBT_CLL_MM_POOL_NMEMB_MIN	64
+#define HMBT_CLL_MM_POOL_NMEMB_MAX	4096
+#define HMBT_CLL_RESIZE_STEPS		4
+#define HMBT_CLL_TREEIFY_MAX		8
+#define HMBT_CLL_TREEIFY_MIN		4
+#define HMBT_CLL_BLOOM_BITS		10
+#define HMBT_CLL_BATCH_SIZE		16
 
 /* Structures */
 
+/**
+ * @struct hmbt_cll_elem
+ *
+ * @brief
+ *   Circular list node of a HMBT-CLL bucket. Nodes are owned and managed by
+ *   the HMBT-CLL handler and shall not be directly modified.
+ *
+ * @var hmbt_cll_elem::data
+ *   The element stored in this node.
+ *
+ * @var hmbt_cll_elem::next
+ *   The next node of the bucket list.
+ *
+ * @var hmbt_cll_elem::prev
+ *   The previous node of the bucket list.
+ *
+ * @var hmbt_cll_elem::hash
+ *   The hash of the element, computed once on insertion. Searches only invoke
+ *   compare() for nodes with a matching hash, and resizes never invoke hash().
+ */
+struct hmbt_cll_elem {
+	void *data;
+	struct hmbt_cll_elem *next;
+	struct hmbt_cll_elem *prev;
+	ui32_t hash;
+};
+
+/**
+ * @struct hmbt_cll_bucket
+ *
+ * @brief
+ *   A HMBT-CLL array slot. The bucket list is stored inline in the array, so
+ *   empty buckets cost no more than two pointers and a counter.
+ *
+ * @var hmbt_cll_bucket::head
+ *   The head of the bucket list, or NULL if the bucket is empty.
+ *
+ * @var hmbt_cll_bucket::tree
+ *   The root of the search tree indexing the bucket list, or NULL if the
+ *   bucket isn't treeified (see pall_hmbt_cll_set_treeify()).
+ *
+ * @var hmbt_cll_bucket::count
+ *   The number of elements present on the bucket.
+ */
+struct hmbt_cll_bucket {
+	struct hmbt_cll_elem *head;
+	struct avl_node *tree;
+	ui32_t count;
+};
+
 /**
  * @struct hmbt_cll_stat
  *
@@ -114,6 +175,30 @@
  * @var hmbt_cll_stat::get_config
  *   Number of get_config calls
  *
+ * @var hmbt_cll_stat::split
+ *   Number of buckets split due to the maximum load factor being exceeded
+ *
+ * @var hmbt_cll_stat::merge
+ *   Number of buckets merged due to the load factor falling below the minimum
+ *
+ * @var hmbt_cll_stat::treeify
+ *   Number of bucket lists indexed by a search tree
+ *
+ * @var hmbt_cll_stat::untreeify
+ *   Number of bucket search trees released
+ *
+ * @var hmbt_cll_stat::bloom_neg
+ *   Number of lookups (searches, deletes and pops) answered by the Bloom
+ *   filter, without visiting the bucket
+ *
+ * @var hmbt_cll_stat::bloom_fp
+ *   Number of lookups allowed by the Bloom filter that didn't find the
+ *   element (false positives)
+ *
+ * @var hmbt_cll_stat::bloom_fp_rate
+ *   The observed false positive rate of the Bloom filter, computed as
+ *   bloom_fp / (bloom_fp + bloom_neg)
+ *
  * @var hmbt_cll_stat::elem_count_cur
  *   Current number of elements present on the tree
  *
@@ -159,6 +244,15 @@ struct hmbt_cll_stat {
 	unsigned long rewind;
 	unsigned long set_config;
 	unsigned long get_config;
+	unsigned long split;
+	unsigned long merge;
+	unsigned long treeify;
+	unsigned long untreeify;
+
+	/* Filter statistics */
+	unsigned long bloom_neg;
+	unsigned long bloom_fp;
+	float bloom_fp_rate;
 
 	/* Element statistics */
 	unsigned long elem_count_cur;
@@ -178,21 +272,41 @@ struct hmbt_cll_stat {
  *   Data structure defining the Hash Mod Balanced Tree handler.
  *
  * @var hmbt_cll_handler::array
- *   The HMBT-CLL array of size 'arr_size'. Each array element points to a
- *   Circular Linked List handler. This array shall not be directly modified.
+ *   The HMBT-CLL array of size 'arr_size'. Each array element is a bucket
+ *   holding the head of a circular list and its element count. The list
+ *   behavior, statistics and memory pool are kept once at handler level.
+ *   This array shall not be directly modified.
  *
  * @var hmbt_cll_handler::arr_size
- *   The size of the HMBT-CLL array. This value shall not be directly modified.
+ *   The size of the HMBT-CLL array. This value changes when the array is
+ *   resized (see pall_hmbt_cll_set_load_factor()) and shall not be directly
+ *   modified.
  *
  * @var hmbt_cll_handler::insert
  *   Function pointer performing the same operation of pall_hmbt_cll_insert()
  *
+ * @var hmbt_cll_handler::insert_batch
+ *   Function pointer performing the same operation of
+ *   pall_hmbt_cll_insert_batch()
+ *
  * @var hmbt_cll_handler::del
  *   Function pointer performing the same operation of pall_hmbt_cll_delete()
  *
+ * @var hmbt_cll_handler::del_key
+ *   Function pointer performing the same operation of
+ *   pall_hmbt_cll_delete_key()
+ *
  * @var hmbt_cll_handler::search
  *   Function pointer performing the same operation of pall_hmbt_cll_search()
  *
+ * @var hmbt_cll_handler::search_key
+ *   Function pointer performing the same operation of
+ *   pall_hmbt_cll_search_key()
+ *
+ * @var hmbt_cll_handler::search_batch
+ *   Function pointer performing the same operation of
+ *   pall_hmbt_cll_search_batch()
+ *
  * @var hmbt_cll_handler::serialize
  *   Function pointer performing the same operation of pall_hmbt_cll_serialize()
  *
@@ -213,6 +327,9 @@ struct hmbt_cll_stat {
  * @var hmbt_cll_handler::pope
  *   Function pointer performing the same operation of pall_hmbt_cll_pope()
  *
+ * @var hmbt_cll_handler::pope_key
+ *   Function pointer performing the same operation of pall_hmbt_cll_pope_key()
+ *
  * @var hmbt_cll_handler::poph_elem
  *   Function pointer performing the same operation of pall_hmbt_cll_poph_elem()
  *
@@ -237,29 +354,72 @@ struct hmbt_cll_stat {
  *   Function pointer performing the same operation of
  *   pall_hmbt_cll_get_config()
  *
+ * @var hmbt_cll_handler::set_load_factor
+ *   Function pointer performing the same operation of
+ *   pall_hmbt_cll_set_load_factor()
+ *
+ * @var hmbt_cll_handler::set_treeify
+ *   Function pointer performing the same operation of
+ *   pall_hmbt_cll_set_treeify()
+ *
+ * @var hmbt_cll_handler::set_bloom
+ *   Function pointer performing the same operation of
+ *   pall_hmbt_cll_set_bloom()
+ *
+ * @var hmbt_cll_handler::set_key
+ *   Function pointer performing the same operation of pall_hmbt_cll_set_key()
+ *
  */
 struct hmbt_cll_handler {
-	struct cll_handler **array;
+	struct hmbt_cll_bucket *array;
 	unsigned int arr_size;
+	unsigned long *_occupied;
+	ui32_t _count;
+	ui32_t _config_flags;
+	ui32_t _arr_size_min;
+	ui32_t _arr_cap;
+	ui32_t _level_size;
+	ui32_t _split;
+	float _load_max;
+	float _load_min;
+	ui32_t _treeify_max;
+	ui32_t _treeify_min;
+	struct bloom _bloom;
+	struct lenhist _lenhist;
 	ui32_t _iterate_arr_pos;
 	int _iterate_reverse;
+	int _iterate_started;
+	int _iterating;
+	int _iterate_cancelled;
+	struct hmbt_cll_elem *_iterate_cur;
+	struct hmbt_cll_elem *_iterate_end;
 
 	struct hmbt_cll_stat _stat;
+	struct pall_mm _mm;
+	struct mm_pool _pool;
 	int (*compare) (const void *d1, const void *d2);
 	ui32_t (*hash) (void *data);
 	void (*destroy) (void *data);
 	int (*ser_data) (pall_fd_t fd, void *data);
 	void *(*unser_data) (pall_fd_t fd);
+	void *(*key) (void *data);
+	int (*key_compare) (const void *k1, const void *k2);
+	ui32_t (*key_hash) (void *key);
 
 	int (*insert) (struct hmbt_cll_handler *handler, void *data);
+	int (*insert_batch) (struct hmbt_cll_handler *handler, void **data, ui32_t count);
 	int (*del) (struct hmbt_cll_handler *handler, void *data);
+	int (*del_key) (struct hmbt_cll_handler *handler, void *key);
 	void *(*search) (struct hmbt_cll_handler *handler, void *data);
+	void *(*search_key) (struct hmbt_cll_handler *handler, void *key);
+	ui32_t (*search_batch) (struct hmbt_cll_handler *handler, void **keys, void **results, ui32_t n);
 	int (*serialize) (struct hmbt_cll_handler *handler, pall_fd_t fd);
 	int (*unserialize) (struct hmbt_cll_handler *handler, pall_fd_t fd);
 	struct hmbt_cll_stat *(*stat) (struct hmbt_cll_handler *handler);
 	void (*stat_reset) (struct hmbt_cll_handler *handler);
 	ui32_t (*count) (struct hmbt_cll_handler *handler);
 	void *(*pope) (struct hmbt_cll_handler *handler, void *data);
+	void *(*pope_key) (struct hmbt_cll_handler *handler, void *key);
 	void *(*poph_elem) (struct hmbt_cll_handler *handler, void *data);
 	void *(*poph_index) (struct hmbt_cll_handler *handler, ui32_t index);
 	void (*collapse) (struct hmbt_cll_handler *handler);
@@ -267,6 +427,10 @@ struct hmbt_cll_handler {
 	void (*rewind) (struct hmbt_cll_handler *handler, int to);
 	ui32_t (*set_config) (struct hmbt_cll_handler *handler, ui32_t flags);
 	ui32_t (*get_config) (struct hmbt_cll_handler *handler);
+	int (*set_load_factor) (struct hmbt_cll_handler *handler, float max, float min);
+	int (*set_treeify) (struct hmbt_cll_handler *handler, ui32_t max, ui32_t min);
+	int (*set_bloom) (struct hmbt_cll_handler *handler, ui32_t capacity, ui32_t bits);
+	int (*set_key) (struct hmbt_cll_handler *handler, void *(*key) (void *data), int (*key_compare) (const void *k1, const void *k2), ui32_t (*key_hash) (void *key));
 };
 
 
@@ -313,8 +477,8 @@ struct hmbt_cll_handler {
  *   (pall_hmbt_cll_unserialize()) to fail, setting errno to ENOSYS.
  *
  * @param array_size
- *   The size of the array of the HMBT-CLL. Each array element is a pointer to a
- *   Circular Linked List handler. If this parameter is set to zero, the
+ *   The size of the array of the HMBT-CLL. Each array element is a bucket
+ *   holding a circular list. If this parameter is set to zero, the
  *   default value defined by HMBT_CLL_DEFAULT_ARR_SIZE is used.
  *
  * @return 
@@ -343,6 +507,57 @@ struct hmbt_cll_handler *pall_hmbt_cll_init(
 		void *(*unser_data) (pall_fd_t fd),
 		unsigned int array_size);
 
+/**
+ * @brief
+ *   Initializes a Hash Mod Balanced Tree handler that performs all of
+ *   its memory allocations through the allocator pointed by 'mm'.
+ *
+ * @param compare
+ *   Same as pall_hmbt_cll_init().
+ *
+ * @param destroy
+ *   Same as pall_hmbt_cll_init().
+ *
+ * @param hash
+ *   Same as pall_hmbt_cll_init().
+ *
+ * @param ser_data
+ *   Same as pall_hmbt_cll_init().
+ *
+ * @param unser_data
+ *   Same as pall_hmbt_cll_init().
+ *
+ * @param array_size
+ *   Same as pall_hmbt_cll_init().
+ *
+ * @param mm
+ *   The allocator to be used by this handler. The structure is copied. If NULL,
+ *   the current default allocator is used.
+ *
+ * @return
+ *   On success, a pointer to a valid Hash Mod Balanced Tree handler is
+ *   returned.
+ *   On error, NULL is returned, and errno is set appropriately.
+ *   \n\n
+ *   Errors: EINVAL, ENOMEM
+ *
+ * @see pall_hmbt_cll_init()
+ * @see pall_mm_set_allocator()
+ * @see pall_mm
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct hmbt_cll_handler *pall_hmbt_cll_init_mm(
+		int (*compare) (const void *d1, const void *d2),
+		void (*destroy) (void *data),
+		ui32_t (*hash) (void *data),
+		int (*ser_data) (pall_fd_t fd, void *data),
+		void *(*unser_data) (pall_fd_t fd),
+		unsigned int array_size,
+		const struct pall_mm *mm);
+
 /**
  * @brief
  *   Unitializes and release all resources of a Hash Mod Balanced Tree handler
@@ -385,6 +600,42 @@ DLLIMPORT
 #endif
 int pall_hmbt_cll_insert(struct hmbt_cll_handler *h, void *data);
 
+/**
+ * @brief
+ *   Inserts 'count' elements pointed by the array 'data' into the Hash Mod
+ *   Balanced Tree pointed by 'h', in array order.
+ *   \n\n
+ *   All the nodes are allocated up front, from a single contiguous block when
+ *   CONFIG_MM_POOL is set. The table is then grown to its final size before
+ *   any element is linked, so that the new elements are linked straight into
+ *   their final buckets, and the counters are updated once.
+ *
+ * @param h
+ *   An initialized Hash Mod Balanced Tree handler.
+ *
+ * @param data
+ *   An array of 'count' pointers to the elements to be inserted.
+ *
+ * @param count
+ *   The number of elements to be inserted.
+ *
+ * @return
+ *   On success, zero is returned and statistical counter 'insert' is
+ *   incremented by 'count'. On error, -1 is returned, statistical counter
+ *   'insert_err' is incremented, no element is inserted, and errno is set
+ *   appropriately.
+ *   \n\n
+ *   Errors: ENOMEM
+ *
+ * @see pall_hmbt_cll_insert()
+ * @see hmbt_cll_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_hmbt_cll_insert_batch(struct hmbt_cll_handler *h, void **data, ui32_t count);
+
 /**
  * @brief
  *   Deletes an element that matches the contents of the element pointed by
@@ -413,6 +664,30 @@ DLLIMPORT
 #endif
 int pall_hmbt_cll_delete(struct hmbt_cll_handler *h, void *data);
 
+/**
+ * @brief
+ *   Same as pall_hmbt_cll_delete(), but the element is matched by its key.
+ *   The key is hashed and compared against the key of each element by the
+ *   functions set through pall_hmbt_cll_set_key().
+ *
+ * @param h
+ *   An initialized Hash Mod Balanced Tree handler.
+ *
+ * @param key
+ *   A pointer to the key of the element to be searched and deleted.
+ *
+ * @return
+ *   Same as pall_hmbt_cll_delete().
+ *
+ * @see pall_hmbt_cll_set_key()
+ * @see pall_hmbt_cll_delete()
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_hmbt_cll_delete_key(struct hmbt_cll_handler *h, void *key);
+
 /**
  * @brief
  *   Searches an element that matches the contents of the element pointed by
@@ -440,6 +715,69 @@ DLLIMPORT
 #endif
 void *pall_hmbt_cll_search(struct hmbt_cll_handler *h, void *data);
 
+/**
+ * @brief
+ *   Same as pall_hmbt_cll_search(), but the element is matched by its key, so
+ *   no partially filled element needs to be built for the lookup. The key is
+ *   hashed and compared against the key of each element by the functions set
+ *   through pall_hmbt_cll_set_key().
+ *
+ * @param h
+ *   An initialized Hash Mod Balanced Tree handler.
+ *
+ * @param key
+ *   A pointer to the key of the element to be searched.
+ *
+ * @return
+ *   Same as pall_hmbt_cll_search().
+ *
+ * @see pall_hmbt_cll_set_key()
+ * @see pall_hmbt_cll_search()
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_hmbt_cll_search_key(struct hmbt_cll_handler *h, void *key);
+
+/**
+ * @brief
+ *   Searches 'n' elements at once on the Hash Mod Balanced Tree pointed by
+ *   'h', with the same results of calling pall_hmbt_cll_search() for each of
+ *   them.
+ *   \n\n
+ *   Keys are processed in groups of HMBT_CLL_BATCH_SIZE: all the keys of a
+ *   group are hashed and their buckets prefetched, then the first node of
+ *   each bucket is prefetched, and only then the lookups are resolved. The
+ *   cache misses of the group overlap instead of being paid one after the
+ *   other.
+ *
+ * @param h
+ *   An initialized Hash Mod Balanced Tree handler.
+ *
+ * @param keys
+ *   An array of 'n' pointers to the partially filled elements to be searched.
+ *
+ * @param results
+ *   An array of 'n' pointers, where the found elements are stored. Elements
+ *   not found are stored as NULL.
+ *
+ * @param n
+ *   The number of elements to be searched.
+ *
+ * @return
+ *   The number of elements found. Statistical counters 'search' and
+ *   'search_nf' are updated for each element.
+ *
+ * @see pall_hmbt_cll_search()
+ * @see hmbt_cll_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_hmbt_cll_search_batch(struct hmbt_cll_handler *h, void **keys, void **results, ui32_t n);
+
 /**
  * @brief
  *   Serializes the contents of the Hash Mod Balanced Tree pointed by 'h', to
@@ -521,10 +859,14 @@ int pall_hmbt_cll_unserialize(struct hmbt_cll_handler *h, pall_fd_t fd);
  * @return
  *   Returns a pointer to a valid struct hmbt_cll_stat and the statistical
  *   counter 'stat' is incremented. This function always succeeds.
+ *   \n\n
+ *   The per node distribution requires a pass over the array, which is
+ *   skipped if the handler is configured with CONFIG_STAT_INCREMENTAL.
  *
  * @see pall_hmbt_cll_init()
  * @see pall_hmbt_cll_stat_reset()
  * @see hmbt_cll_stat
+ * @see CONFIG_STAT_INCREMENTAL
  *
  */
 #ifdef COMPILE_WIN32
@@ -599,6 +941,30 @@ DLLIMPORT
 #endif
 void *pall_hmbt_cll_pope(struct hmbt_cll_handler *h, void *data);
 
+/**
+ * @brief
+ *   Same as pall_hmbt_cll_pope(), but the element is matched by its key. The
+ *   key is hashed and compared against the key of each element by the
+ *   functions set through pall_hmbt_cll_set_key().
+ *
+ * @param h
+ *   An initialized Hash Mod Balanced Tree handler.
+ *
+ * @param key
+ *   A pointer to the key of the element to be searched and popped.
+ *
+ * @return
+ *   Same as pall_hmbt_cll_pope().
+ *
+ * @see pall_hmbt_cll_set_key()
+ * @see pall_hmbt_cll_pope()
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_hmbt_cll_pope_key(struct hmbt_cll_handler *h, void *key);
+
 /**
  * @brief
  *   Pops the head of the list containing an element that matches the contents
@@ -682,7 +1048,13 @@ void pall_hmbt_cll_collapse(struct hmbt_cll_handler *h);
  *   zero to arr_size, head to tail for each indexed list, or from arr_size to
  *   zero, tail to head for each indexed list, depending on the parameters used
  *   on the pall_hmbt_cll_rewind() function.
- *   Rewind and iterate do not affect the behavior of any other operation.
+ *   \n\n
+ *   Elements may be deleted while iterating. Iterations never defer resizing
+ *   (see pall_hmbt_cll_set_load_factor()), so an abandoned iteration has no
+ *   effect on other operations. Splits and merges of buckets above the array
+ *   index being iterated keep the iteration going, but an insert or delete
+ *   that splits or merges a bucket at or below that index ends it, as its
+ *   elements would otherwise be returned twice or skipped.
  *
  * @param h
  *   An initialized Hash Mod Balanced Tree handler.
@@ -690,7 +1062,9 @@ void pall_hmbt_cll_collapse(struct hmbt_cll_handler *h);
  * @return
  *   Returns a pointer to the next element present on the HMBT-CLL. If the end
  *   of the HMBT-CLL is reached, NULL is returned and statistical counter
- *   'iterate' is incremented.
+ *   'iterate' is incremented. If the iteration was ended by a resize, NULL is
+ *   returned, errno is set to ECANCELED and statistical counter 'iterate' is
+ *   incremented. A new iteration requires a call to pall_hmbt_cll_rewind().
  *
  * @see pall_hmbt_cll_init()
  * @see pall_hmbt_cll_rewind()
@@ -706,8 +1080,10 @@ void *pall_hmbt_cll_iterate(struct hmbt_cll_handler *h);
  * @brief
  *   Rewinds the Hash Mod Balanced Tree pointed by handler 'h'. The parameter
  *   'to' tells to where the rewind should be perfomed and configures the
- *   the behavior of pall_hmbt_cll_iterate().
- *   Rewind and iterate do not affect the behavior of any other operation.
+ *   the behavior of pall_hmbt_cll_iterate(). The first array index to be
+ *   iterated is taken by the first pall_hmbt_cll_iterate() call, so resizes
+ *   performed in between are accounted for.
+ *   Rewind does not affect the behavior of any other operation.
  *
  * @param h
  *   An initialized Hash Mod Balanced Tree handler.
@@ -747,7 +1123,14 @@ void pall_hmbt_cll_rewind(struct hmbt_cll_handler *h, int to);
  *   Available flags are: CONFIG_SEARCH_FORWARD, CONFIG_SEARCH_BACKWARD,
  *   CONFIG_SEARCH_AUTO, CONFIG_SEARCH_LRU (default), CONFIG_INSERT_SORTED,
  *   CONFIG_INSERT_NEXT, CONFIG_INSERT_PREV, CONFIG_INSERT_TAIL,
- *   CONFIG_INSERT_HEAD (default).
+ *   CONFIG_INSERT_HEAD (default), CONFIG_MM_POOL (default), CONFIG_HASH_MASK,
+ *   CONFIG_STAT_INCREMENTAL.
+ *   \n\n
+ *   Since buckets do not keep a current position, the positional flags are
+ *   relative to the bucket head: CONFIG_INSERT_NEXT inserts after the head,
+ *   CONFIG_INSERT_PREV behaves as CONFIG_INSERT_TAIL and CONFIG_SEARCH_AUTO
+ *   behaves as CONFIG_SEARCH_FORWARD. Changes to CONFIG_MM_POOL only take
+ *   effect once the HMBT-CLL is empty.
  *
  * @return
  *   Returns the previously configuration flags before the call to this
@@ -765,6 +1148,8 @@ void pall_hmbt_cll_rewind(struct hmbt_cll_handler *h, int to);
  * @see CONFIG_INSERT_PREV
  * @see CONFIG_INSERT_TAIL
  * @see CONFIG_INSERT_HEAD
+ * @see CONFIG_HASH_MASK
+ * @see CONFIG_STAT_INCREMENTAL
  *
  */
 #ifdef COMPILE_WIN32
@@ -782,7 +1167,7 @@ ui32_t pall_hmbt_cll_set_config(struct hmbt_cll_handler *h, ui32_t flags);
  *
  * @return
  *   Returns the current configuration flags set to the list and statistical
- *   counter 'set_config' is incremented.
+ *   counter 'get_config' is incremented.
  *
  * @see pall_hmbt_cll_init()
  * @see pall_hmbt_cll_set_config()
@@ -803,5 +1188,195 @@ DLLIMPORT
 #endif
 ui32_t pall_hmbt_cll_get_config(struct hmbt_cll_handler *h);
 
+/**
+ * @brief
+ *   Enables automatic resizing of the Hash Mod Balanced Tree pointed by
+ *   handler 'h', based on its load factor (the number of elements per array
+ *   position).
+ *   \n\n
+ *   Resizing is incremental (linear hashing): whenever the load factor exceeds
+ *   'max', the next bucket in sequence is split in two and the array grows by
+ *   one position, and whenever it falls below 'min', the last bucket is merged
+ *   back. At most HMBT_CLL_RESIZE_STEPS buckets are split or merged per
+ *   operation, so no single operation rehashes the whole array. Resizing is
+ *   never deferred: a split or merge of a bucket at or below the array index
+ *   of an iteration in progress ends that iteration instead (see
+ *   pall_hmbt_cll_iterate()). The array never shrinks below the size
+ *   requested at initialization. Note that array indexes used by
+ *   pall_hmbt_cll_poph_index() change as the array is resized.
+ *   \n\n
+ *   The element index, previously hash(element) % arr_size, becomes:
+ *     index = hash(element) % L; if (index < S) index = hash(element) % (2 * L)
+ *   where L is the array size at the beginning of the current doubling round
+ *   and S is the number of buckets already split on that round.
+ *
+ * @param h
+ *   An initialized Hash Mod Balanced Tree handler.
+ *
+ * @param max
+ *   The maximum load factor. If set to zero (default), the array never grows.
+ *
+ * @param min
+ *   The minimum load factor. If set to zero (default), the array never
+ *   shrinks. When both are set, 'min' shall be lower than half of 'max', so
+ *   that a split or merge doesn't immediately trigger the opposite operation.
+ *
+ * @return
+ *   On success, zero is returned. On error, -1 is returned and errno is set
+ *   appropriately.
+ *   \n\n
+ *   Errors: EINVAL
+ *
+ * @see pall_hmbt_cll_init()
+ * @see hmbt_cll_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_hmbt_cll_set_load_factor(struct hmbt_cll_handler *h, float max, float min);
+
+/**
+ * @brief
+ *   Sets the bucket lengths at which the buckets of the Hash Mod Balanced Tree
+ *   pointed by handler 'h' are indexed by a balanced search tree.
+ *   \n\n
+ *   A bucket whose element count exceeds 'max' has its list indexed by an AVL
+ *   tree ordered by element hash and compare(), so that lookups on long chains
+ *   caused by skewed or adversarial hashes take logarithmic time. The tree is
+ *   released once the bucket element count falls below 'min'. The bucket list
+ *   is kept along with the tree, so insertion order, iteration and
+ *   serialization are not affected. On treeified buckets, the element found
+ *   among several matching elements is unspecified, regardless of the search
+ *   direction flags. Buckets are never treeified if no compare() function was
+ *   supplied at initialization.
+ *   \n\n
+ *   By default, 'max' is HMBT_CLL_TREEIFY_MAX and 'min' is
+ *   HMBT_CLL_TREEIFY_MIN. The new lengths are immediately applied to all the
+ *   buckets.
+ *
+ * @param h
+ *   An initialized Hash Mod Balanced Tree handler.
+ *
+ * @param max
+ *   The bucket element count above which the bucket is treeified. If set to
+ *   zero, buckets are never treeified.
+ *
+ * @param min
+ *   The bucket element count below which the bucket tree is released. Shall
+ *   be lower than 'max', unless 'max' is zero.
+ *
+ * @return
+ *   On success, zero is returned. On error, -1 is returned and errno is set
+ *   appropriately. Buckets that couldn't be treeified due to an allocation
+ *   failure are kept as plain lists and retried on their next insertion.
+ *   \n\n
+ *   Errors: EINVAL
+ *
+ * @see pall_hmbt_cll_init()
+ * @see hmbt_cll_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_hmbt_cll_set_treeify(struct hmbt_cll_handler *h, ui32_t max, ui32_t min);
+
+/**
+ * @brief
+ *   Attaches a counting Bloom filter to the Hash Mod Balanced Tree pointed by
+ *   handler 'h', or detaches it.
+ *   \n\n
+ *   The filter is consulted by pall_hmbt_cll_search(), pall_hmbt_cll_delete()
+ *   and pall_hmbt_cll_pope() before visiting the bucket, so that most lookups
+ *   of absent elements don't walk the bucket list nor invoke compare(). It is
+ *   maintained on every insert and removal and cleared on collapse. Elements
+ *   already present on the HMBT-CLL are added when the filter is attached.
+ *   \n\n
+ *   The filter takes capacity * bits / 2 bytes. With the default of
+ *   HMBT_CLL_BLOOM_BITS counters per element, about 1.5% of the absent
+ *   elements are let through while the element count is within 'capacity'.
+ *   The false positive rate grows past it, and is reported by
+ *   pall_hmbt_cll_stat() so that the filter can be resized by calling this
+ *   function again.
+ *
+ * @param h
+ *   An initialized Hash Mod Balanced Tree handler.
+ *
+ * @param capacity
+ *   The expected number of elements. If set to zero (default), the filter is
+ *   detached.
+ *
+ * @param bits
+ *   The number of filter counters per element. If set to zero,
+ *   HMBT_CLL_BLOOM_BITS is used.
+ *
+ * @return
+ *   On success, zero is returned. On error, -1 is returned, errno is set
+ *   appropriately and the previous filter, if any, is kept.
+ *   \n\n
+ *   Errors: ERANGE, ENOMEM
+ *
+ * @see pall_hmbt_cll_init()
+ * @see hmbt_cll_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_hmbt_cll_set_bloom(struct hmbt_cll_handler *h, ui32_t capacity, ui32_t bits);
+
+/**
+ * @brief
+ *   Sets the functions used by pall_hmbt_cll_search_key(),
+ *   pall_hmbt_cll_delete_key() and pall_hmbt_cll_pope_key() to match elements
+ *   by key. Until this function is called, each element is its own key, and
+ *   keys are compared and hashed by the compare() and hash() functions passed
+ *   to pall_hmbt_cll_init().
+ *   \n\n
+ *   Keys must be consistent with the elements holding them: key_hash() of the
+ *   key of an element shall return the same value as hash() of that element,
+ *   and key_compare() shall order keys as compare() orders their elements.
+ *   For instance, if hash() is defined with PALL_HASH_DEFINE_MEMBER() and
+ *   key() returns the address of that member, key_hash() can be defined with
+ *   PALL_HASH_DEFINE_BYTES() at offset zero and with the member size.
+ *
+ * @param h
+ *   An initialized Hash Mod Balanced Tree handler.
+ *
+ * @param key
+ *   Returns a pointer to the key of the element pointed by 'data'. It is
+ *   usually the address of a member of the element, so no memory is allocated.
+ *   If NULL, along with 'key_compare' and 'key_hash', the default functions
+ *   are restored.
+ *
+ * @param key_compare
+ *   Compares the key 'k1' against the key 'k2' and returns an integer less
+ *   than, equal to, or greater than zero.
+ *
+ * @param key_hash
+ *   Returns the hash of the key pointed by 'key'.
+ *
+ * @return
+ *   On success, zero is returned. On error, -1 is returned and errno is set
+ *   appropriately.
+ *   \n\n
+ *   Errors: EINVAL (only some of 'key', 'key_compare' and 'key_hash' are
+ *   NULL).
+ *
+ * @see pall_hmbt_cll_search_key()
+ * @see pall_hmbt_cll_delete_key()
+ * @see pall_hmbt_cll_pope_key()
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_hmbt_cll_set_key(
+		struct hmbt_cll_handler *h,
+		void *(*key) (void *data),
+		int (*key_compare) (const void *k1, const void *k2),
+		ui32_t (*key_hash) (void *key));
+
 #endif
 
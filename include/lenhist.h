@@ -0,0 +1,169 @@
+/**
+ * @file lenhist.h
+ * @brief Portable Abstracted Linked Lists Library (libpall)
+ *        Bucket length histogram interface header
+ *
+ * Date: 16-10-2026
+ *
+ * Copyright 2026 Pedro A. Hortas (pah@ucodev.org)
+ *
+ * This file is part of libpall.
+ *
+ * libpall is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libpall is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libpall.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef LIBPALL_LENHIST_H
+#define LIBPALL_LENHIST_H
+
+#include <string.h>
+
+#include "config.h"
+#include "pall.h"
+#include "mm.h"
+
+/* Constants */
+#define LENHIST_SIZE_MIN	16
+
+/* Structures */
+
+/**
+ * @struct lenhist
+ *
+ * @brief
+ *   Histogram of the element counts of the buckets of a hash table, keeping
+ *   the shortest and longest bucket lengths on every update. A bucket length
+ *   change by k is accounted in O(k) time.
+ *
+ * @var lenhist::count
+ *   The number of buckets holding each element count.
+ *
+ * @var lenhist::size
+ *   The number of entries of 'count'.
+ *
+ * @var lenhist::min
+ *   The element count of the shortest bucket.
+ *
+ * @var lenhist::max
+ *   The element count of the longest bucket.
+ *
+ * @var lenhist::stale
+ *   Set if the histogram failed to grow, in which case it is no longer
+ *   updated until it is rebuilt through lenhist_clear() and lenhist_add().
+ */
+struct lenhist {
+	unsigned long *count;
+	ui32_t size;
+	ui32_t min;
+	ui32_t max;
+	int stale;
+};
+
+/* Internal interface */
+
+/* Accounts 'nbuckets' empty buckets, or none, so that the histogram can be
+ * rebuilt bucket by bucket.
+ */
+static inline void lenhist_clear(struct lenhist *hist, ui32_t nbuckets) {
+	memset(hist->count, 0, hist->size * sizeof(unsigned long));
+
+	hist->count[0] = nbuckets;
+	hist->min = nbuckets ? 0 : ~0U;
+	hist->max = 0;
+	hist->stale = 0;
+}
+
+static inline int lenhist_init(struct lenhist *hist, const struct pall_mm *mm, ui32_t nbuckets) {
+	if (!(hist->count = (unsigned long *) mm_alloc_with(mm, LENHIST_SIZE_MIN * sizeof(unsigned long))))
+		return -1;
+
+	hist->size = LENHIST_SIZE_MIN;
+
+	lenhist_clear(hist, nbuckets);
+
+	return 0;
+}
+
+static inline void lenhist_release(struct lenhist *hist, const struct pall_mm *mm) {
+	mm_free_with(mm, hist->count);
+
+	memset(hist, 0, sizeof(struct lenhist));
+}
+
+/* Makes room for buckets of 'len' elements, or marks the histogram stale */
+static inline int lenhist_reserve(struct lenhist *hist, const struct pall_mm *mm, ui32_t len) {
+	unsigned long *count = NULL;
+	ui32_t size = hist->size;
+
+	if (len < size)
+		return 0;
+
+	while (size && (size <= len))
+		size <<= 1;
+
+	if (!size || !(count = (unsigned long *) mm_resize_with(mm, hist->count, hist->size * sizeof(unsigned long), size * sizeof(unsigned long)))) {
+		hist->stale = 1;
+		return -1;
+	}
+
+	memset(&count[hist->size], 0, (size - hist->size) * sizeof(unsigned long));
+
+	hist->count = count;
+	hist->size = size;
+
+	return 0;
+}
+
+/* Accounts a new bucket holding 'len' elements */
+static inline void lenhist_add(struct lenhist *hist, const struct pall_mm *mm, ui32_t len) {
+	if (hist->stale || (lenhist_reserve(hist, mm, len) < 0))
+		return;
+
+	hist->count[len] ++;
+
+	if (len < hist->min)
+		hist->min = len;
+
+	if (len > hist->max)
+		hist->max = len;
+}
+
+/* Removes a bucket holding 'len' elements. At least one bucket must remain. */
+static inline void lenhist_del(struct lenhist *hist, ui32_t len) {
+	if (hist->stale || -- hist->count[len])
+		return;
+
+	if (len == hist->min) {
+		while (!hist->count[hist->min])
+			hist->min ++;
+	}
+
+	if (len == hist->max) {
+		while (!hist->count[hist->max])
+			hist->max --;
+	}
+}
+
+/* Accounts a bucket whose element count changed from 'from' to 'to' */
+static inline void lenhist_move(struct lenhist *hist, const struct pall_mm *mm, ui32_t from, ui32_t to) {
+	if (from == to)
+		return;
+
+	lenhist_add(hist, mm, to);
+	lenhist_del(hist, from);
+}
+
+#endif
+
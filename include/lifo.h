@@ -29,6 +29,7 @@
 
 #include "config.h"
 #include "pall.h"
+#include "mm.h"
 #include "cll.h"
 
 /* Structures */
@@ -118,6 +119,9 @@ struct lifo_stat {
  * @var lifo_handler::push
  *   Function pointer performing the same operation of pall_lifo_push()
  *
+ * @var lifo_handler::push_batch
+ *   Function pointer performing the same operation of pall_lifo_push_batch()
+ *
  * @var lifo_handler::pop
  *   Function pointer performing the same operation of pall_lifo_pop()
  *
@@ -149,12 +153,14 @@ struct lifo_stat {
 struct lifo_handler {
 	struct cll_handler *lifo;
 	struct lifo_stat _stat;
+	struct pall_mm _mm;
 
 	void (*destroy) (void *data);
 	int (*ser_data) (pall_fd_t fd, void *data);
 	void *(*unser_data) (pall_fd_t fd);
 
 	int (*push) (struct lifo_handler *handler, void *data);
+	int (*push_batch) (struct lifo_handler *handler, void **data, ui32_t count);
 	void *(*pop) (struct lifo_handler *handler);
 	int (*serialize) (struct lifo_handler *handler, pall_fd_t fd);
 	int (*unserialize) (struct lifo_handler *handler, pall_fd_t fd);
@@ -211,6 +217,45 @@ struct lifo_handler *pall_lifo_init(
 		int (*ser_data) (pall_fd_t fd, void *data),
 		void *(*unser_data) (pall_fd_t fd));
 
+/**
+ * @brief
+ *   Initializes a Last In First Out stack handler that performs all of
+ *   its memory allocations through the allocator pointed by 'mm'.
+ *
+ * @param destroy
+ *   Same as pall_lifo_init().
+ *
+ * @param ser_data
+ *   Same as pall_lifo_init().
+ *
+ * @param unser_data
+ *   Same as pall_lifo_init().
+ *
+ * @param mm
+ *   The allocator to be used by this handler. The structure is copied. If NULL,
+ *   the current default allocator is used.
+ *
+ * @return
+ *   On success, a pointer to a valid Last In First Out stack handler is
+ *   returned.
+ *   On error, NULL is returned, and errno is set appropriately.
+ *   \n\n
+ *   Errors: EINVAL, ENOMEM
+ *
+ * @see pall_lifo_init()
+ * @see pall_mm_set_allocator()
+ * @see pall_mm
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct lifo_handler *pall_lifo_init_mm(
+		void (*destroy) (void *data),
+		int (*ser_data) (pall_fd_t fd, void *data),
+		void *(*unser_data) (pall_fd_t fd),
+		const struct pall_mm *mm);
+
 /**
  * @brief
  *   Unitializes and release all resources of a Last In First Out stack handler
@@ -252,6 +297,39 @@ DLLIMPORT
 #endif
 int pall_lifo_push(struct lifo_handler *h, void *data);
 
+/**
+ * @brief
+ *   Pushes 'count' elements pointed by the array 'data' into the Last In First Out stack
+ *   handler pointed by 'h', leaving the stack exactly as 'count' calls to
+ *   pall_lifo_push() would, in array order. The nodes are allocated from a
+ *   single block and linked into the stack at once.
+ *
+ * @param h
+ *   An initialized Last In First Out stack handler.
+ *
+ * @param data
+ *   An array of 'count' pointers to the elements to be pushed.
+ *
+ * @param count
+ *   The number of elements to be pushed.
+ *
+ * @return
+ *   On success, zero is returned and statistical counter 'push' is
+ *   incremented by 'count'. On error, -1 is returned, statistical counter
+ *   'push_err' is incremented, no element is pushed, and errno is set
+ *   appropriately.
+ *   \n\n
+ *   Errors: ENOMEM
+ *
+ * @see pall_lifo_push()
+ * @see lifo_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_lifo_push_batch(struct lifo_handler *h, void **data, ui32_t count);
+
 /**
  * @brief
  *   Pops an element from the Last In First Out stack pointed by 'h'.
@@ -28,13 +28,154 @@
 #ifndef LIBPALL_MM_H
 #define LIBPALL_MM_H
 
+#include <stddef.h>
+
+#include "config.h"
+
 #ifdef USE_LIBFSMA
  #include <fsma/fsma.h>
 #endif
 
+/* Structures */
+
+/**
+ * @struct pall_mm
+ *
+ * @brief
+ *   Memory allocator used by libpall handlers. Each callback receives the
+ *   opaque pointer 'ctx' as its first argument, allowing arenas, per-thread
+ *   pools or any other allocator to be plugged in at runtime.
+ *
+ * @see pall_mm_set_allocator()
+ * @see pall_mm_get_allocator()
+ *
+ * @var pall_mm::alloc
+ *   Allocates 'size' bytes. Same semantics of malloc(). Mandatory.
+ *
+ * @var pall_mm::free
+ *   Releases memory previously returned by alloc(), realloc() or calloc().
+ *   Same semantics of free(). Mandatory.
+ *
+ * @var pall_mm::realloc
+ *   Same semantics of realloc(). Optional. If NULL, reallocations fail with
+ *   errno set to ENOSYS.
+ *
+ * @var pall_mm::calloc
+ *   Same semantics of calloc(). Optional. If NULL, alloc() is used and the
+ *   allocated memory is zeroed.
+ *
+ * @var pall_mm::ctx
+ *   Opaque pointer passed to all the callbacks.
+ */
+struct pall_mm {
+	void *(*alloc) (void *ctx, size_t size);
+	void (*free) (void *ctx, void *ptr);
+	void *(*realloc) (void *ctx, void *ptr, size_t size);
+	void *(*calloc) (void *ctx, size_t nmemb, size_t size);
+	void *ctx;
+};
+
+/*
+ * Fixed size object pool. Objects are carved from chunks obtained through
+ * the allocator 'mm' and recycled through an internal free list. Chunks are
+ * only returned to the allocator by mm_pool_release().
+ * Objects of arbitrary size, which cannot be individually released, can also
+ * be carved from the same chunks through mm_pool_alloc_size(), making the
+ * pool usable as an arena.
+ * Chunks may be aligned to a power of two boundary through mm_pool_align(),
+ * keeping fixed size objects that are a multiple of that boundary aligned as
+ * well (e.g., to cache lines).
+ */
+struct mm_pool {
+	const struct pall_mm *mm;
+	size_t size;
+	size_t nmemb;
+	size_t nmemb_max;
+	size_t align;
+	void *free_list;
+	void *chunks;
+	char *cur;
+	char *end;
+};
+
+
+/* Prototypes / Interface */
+
+/**
+ * @brief
+ *   Sets the default allocator used by all the handlers initialized after
+ *   this call without an explicit allocator (through the pall_*_init()
+ *   functions). Handlers keep using the allocator that was in effect when
+ *   they were initialized, so changing the default allocator never affects
+ *   existing handlers.
+ *   This function is not thread-safe and shall be called before other threads
+ *   initialize handlers. Per-thread allocators shall be passed explicitly
+ *   through the pall_*_init_mm() functions.
+ *
+ * @param mm
+ *   A pointer to the allocator to be used. The structure is copied. If NULL,
+ *   the built-in allocator (libc or libfsma) is restored.
+ *
+ * @return
+ *   On success, zero is returned. On error, -1 is returned and errno is set
+ *   appropriately.
+ *   \n\n
+ *   Errors: EINVAL
+ *
+ * @see pall_mm_get_allocator()
+ * @see pall_mm
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_mm_set_allocator(const struct pall_mm *mm);
+
+/**
+ * @brief
+ *   Returns the current default allocator.
+ *
+ * @return
+ *   A pointer to the current default allocator. This function always
+ *   succeeds.
+ *
+ * @see pall_mm_set_allocator()
+ * @see pall_mm
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+const struct pall_mm *pall_mm_get_allocator(void);
+
+/* Internal interface */
 void *mm_alloc(size_t size);
 void mm_free(void *ptr);
 void *mm_realloc(void *ptr, size_t size);
 void *mm_calloc(size_t nmemb, size_t size);
 
+void mm_copy(struct pall_mm *dst, const struct pall_mm *src);
+void *mm_alloc_with(const struct pall_mm *mm, size_t size);
+void mm_free_with(const struct pall_mm *mm, void *ptr);
+void *mm_realloc_with(const struct pall_mm *mm, void *ptr, size_t size);
+void *mm_resize_with(const struct pall_mm *mm, void *ptr, size_t old_size, size_t size);
+void *mm_calloc_with(const struct pall_mm *mm, size_t nmemb, size_t size);
+
+void mm_pool_init(struct mm_pool *pool, const struct pall_mm *mm, size_t size, size_t nmemb, size_t nmemb_max);
+void mm_pool_align(struct mm_pool *pool, size_t align);
+void *mm_pool_alloc(struct mm_pool *pool);
+void *mm_pool_alloc_block(struct mm_pool *pool, size_t nmemb);
+void *mm_pool_alloc_size(struct mm_pool *pool, size_t size);
+void mm_pool_free(struct mm_pool *pool, void *ptr);
+void mm_pool_release(struct mm_pool *pool);
+
+/* Hints the processor to start loading 'addr' into the cache. Prefetching an
+ * invalid address, including NULL, is harmless.
+ */
+#if defined(__GNUC__)
+ #define mm_prefetch(addr) __builtin_prefetch(addr)
+#else
+ #define mm_prefetch(addr) ((void) (addr))
+#endif
+
 #endif
@@ -47,12 +47,21 @@
  *
  */
 
+/**
+ * @typedef ui64_t
+ *
+ * @brief
+ *   64-bit unsigned integer, for the same reasons as ui32_t.
+ *
+ */
+
  #ifdef COMPILE_WIN32
   #include <winsock2.h>
   #include <windows.h>
 
   typedef HANDLE pall_fd_t;
   typedef unsigned __int32 ui32_t;
+  typedef unsigned __int64 ui64_t;
 
   static inline SSIZE_T pall_write(HANDLE h, LPCVOID data, DWORD count) {
 	DWORD wcount = 0;
@@ -79,6 +88,7 @@
 
   typedef int pall_fd_t;
   typedef uint32_t ui32_t;
+  typedef uint64_t ui64_t;
 
   #define pall_write(fd, data, count) write(fd, data, count)
   #define pall_read(fd, data, count) read(fd, data, count)
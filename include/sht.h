@@ -0,0 +1,706 @@
+/**
+ * @file sht.h
+ * @brief Portable Abstracted Linked Lists Library (libpall)
+ *        Swiss Hash Table interface header
+ *
+ * Date: 16-10-2026
+ *
+ * Copyright 2026 Pedro A. Hortas (pah@ucodev.org)
+ *
+ * This file is part of libpall.
+ *
+ * libpall is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libpall is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libpall.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef LIBPALL_SHT_H
+#define LIBPALL_SHT_H
+
+#include "config.h"
+#include "pall.h"
+#include "mm.h"
+
+/* Constants */
+#define SHT_DEFAULT_ARR_SIZE		128
+#define SHT_GROUP_SIZE			16	/* Slots probed at once */
+#define SHT_MIN_ARR_SIZE		SHT_GROUP_SIZE
+#define SHT_LOAD_FACTOR_NUM		7	/* Rehashes at 7/8 occupancy */
+#define SHT_LOAD_FACTOR_DEN		8
+
+/* Control bytes */
+#define SHT_CTRL_EMPTY			0x80
+#define SHT_CTRL_DELETED		0xfe	/* Full slots hold a 7-bit tag */
+
+/* Structures */
+
+/**
+ * @struct sht_stat
+ *
+ * @brief
+ *   Statistical counters for table operations and table elements.
+ *
+ * @see pall_sht_stat()
+ * @see pall_sht_stat_reset()
+ *
+ * @var sht_stat::insert
+ *   Number of successful inserts
+ *
+ * @var sht_stat::insert_err
+ *   Number of failed inserts
+ *
+ * @var sht_stat::del
+ *   Number of successful deletes
+ *
+ * @var sht_stat::del_nf
+ *   Number of not found deletes
+ *
+ * @var sht_stat::search
+ *   Number of successful searches
+ *
+ * @var sht_stat::search_nf
+ *   Number of not found searches
+ *
+ * @var sht_stat::serialize
+ *   Number of successful serializations
+ *
+ * @var sht_stat::serialize_err
+ *   Number of failed serializations
+ *
+ * @var sht_stat::unserialize
+ *   Number of successful unserializations
+ *
+ * @var sht_stat::unserialize_err
+ *   Number of failed unserializations
+ *
+ * @var sht_stat::stat
+ *   Number of stat calls
+ *
+ * @var sht_stat::count
+ *   Number of count calls
+ *
+ * @var sht_stat::pope
+ *   Number of successful element pops
+ *
+ * @var sht_stat::pope_nf
+ *   Number of not found elem pops
+ *
+ * @var sht_stat::collapse
+ *   Number of collapse calls
+ *
+ * @var sht_stat::iterate
+ *   Number of full iterations
+ *
+ * @var sht_stat::rewind
+ *   Number of rewind calls
+ *
+ * @var sht_stat::grow
+ *   Number of times the table array was doubled
+ *
+ * @var sht_stat::rehash
+ *   Number of times the table array was rebuilt, either to grow or to reclaim
+ *   the slots of deleted elements.
+ *
+ * @var sht_stat::elem_count_cur
+ *   Current number of elements present on the table
+ *
+ * @var sht_stat::elem_count_max
+ *   Maximum elements since initialization or last stat_reset call.
+ *
+ * @var sht_stat::elem_deleted
+ *   Current number of slots marked as deleted, which are only reclaimed when
+ *   the table array is rebuilt.
+ *
+ * @var sht_stat::probe_len_avg
+ *   The average number of additional groups probed to reach an element.
+ *
+ * @var sht_stat::probe_len_max
+ *   The largest number of additional groups probed to reach an element.
+ */
+struct sht_stat {
+	/* Operation statistics */
+	unsigned long insert;
+	unsigned long insert_err;
+	unsigned long del;
+	unsigned long del_nf;
+	unsigned long search;
+	unsigned long search_nf;
+	unsigned long serialize;
+	unsigned long serialize_err;
+	unsigned long unserialize;
+	unsigned long unserialize_err;
+	unsigned long stat;
+	unsigned long count;
+	unsigned long pope;
+	unsigned long pope_nf;
+	unsigned long collapse;
+	unsigned long iterate;
+	unsigned long rewind;
+	unsigned long grow;
+	unsigned long rehash;
+
+	/* Element statistics */
+	unsigned long elem_count_cur;
+	unsigned long elem_count_max;
+	unsigned long elem_deleted;
+
+	/* Probe statistics */
+	float probe_len_avg;
+	unsigned long probe_len_max;
+};
+
+/**
+ * @struct sht_handler
+ *
+ * @brief
+ *   Data structure defining the Swiss Hash Table handler.
+ *
+ * @var sht_handler::array
+ *   The table array of size 'arr_size', holding the element pointers. This
+ *   array shall not be directly modified.
+ *
+ * @var sht_handler::ctrl
+ *   The control bytes of size 'arr_size', one per slot of the table array.
+ *   Each byte is either SHT_CTRL_EMPTY, SHT_CTRL_DELETED or, for used slots,
+ *   a 7-bit tag taken from the element hash. Slots are probed in groups of
+ *   SHT_GROUP_SIZE by matching the tag against a whole group of control bytes
+ *   at once, so compare() is seldom invoked for non-matching elements. This
+ *   array shall not be directly modified.
+ *
+ * @var sht_handler::arr_size
+ *   The size of the table array, always a power of two not lower than
+ *   SHT_GROUP_SIZE. The array is rebuilt whenever its used and deleted slots
+ *   exceed SHT_LOAD_FACTOR_NUM / SHT_LOAD_FACTOR_DEN, and it is doubled if
+ *   deleted slots alone wouldn't make enough room. This value shall not be
+ *   directly modified.
+ *
+ * @var sht_handler::insert
+ *   Function pointer performing the same operation of pall_sht_insert()
+ *
+ * @var sht_handler::del
+ *   Function pointer performing the same operation of pall_sht_delete()
+ *
+ * @var sht_handler::search
+ *   Function pointer performing the same operation of pall_sht_search()
+ *
+ * @var sht_handler::serialize
+ *   Function pointer performing the same operation of pall_sht_serialize()
+ *
+ * @var sht_handler::unserialize
+ *   Function pointer performing the same operation of pall_sht_unserialize()
+ *
+ * @var sht_handler::stat
+ *   Function pointer performing the same operation of pall_sht_stat()
+ *
+ * @var sht_handler::stat_reset
+ *   Function pointer performing the same operation of pall_sht_stat_reset()
+ *
+ * @var sht_handler::count
+ *   Function pointer performing the same operation of pall_sht_count()
+ *
+ * @var sht_handler::pope
+ *   Function pointer performing the same operation of pall_sht_pope()
+ *
+ * @var sht_handler::collapse
+ *   Function pointer performing the same operation of pall_sht_collapse()
+ *
+ * @var sht_handler::iterate
+ *   Function pointer performing the same operation of pall_sht_iterate()
+ *
+ * @var sht_handler::rewind
+ *   Function pointer performing the same operation of pall_sht_rewind()
+ */
+struct sht_handler {
+	void **array;
+	unsigned char *ctrl;
+	unsigned int arr_size;
+	ui32_t _count;
+	ui32_t _deleted;
+	ui32_t _iterate_arr_pos;
+	int _iterate_reverse;
+
+	struct sht_stat _stat;
+	struct pall_mm _mm;
+	int (*compare) (const void *d1, const void *d2);
+	ui32_t (*hash) (void *data);
+	void (*destroy) (void *data);
+	int (*ser_data) (pall_fd_t fd, void *data);
+	void *(*unser_data) (pall_fd_t fd);
+
+	int (*insert) (struct sht_handler *handler, void *data);
+	int (*del) (struct sht_handler *handler, void *data);
+	void *(*search) (struct sht_handler *handler, void *data);
+	int (*serialize) (struct sht_handler *handler, pall_fd_t fd);
+	int (*unserialize) (struct sht_handler *handler, pall_fd_t fd);
+	struct sht_stat *(*stat) (struct sht_handler *handler);
+	void (*stat_reset) (struct sht_handler *handler);
+	ui32_t (*count) (struct sht_handler *handler);
+	void *(*pope) (struct sht_handler *handler, void *data);
+	void (*collapse) (struct sht_handler *handler);
+	void *(*iterate) (struct sht_handler *handler);
+	void (*rewind) (struct sht_handler *handler, int to);
+};
+
+
+/* Prototypes / Interface */
+
+/**
+ * @brief
+ *   Initializes a Swiss Hash Table handler.
+ *
+ * @param compare
+ *   Internally used function for element comparision by pall_sht_insert(),
+ *   pall_sht_search() and pall_sht_delete().
+ *   It receives two elements as parameters of type const void *.
+ *   It shall return zero if d1 matches d2, and non-zero otherwise. It is only
+ *   invoked for elements whose hashes match.
+ *
+ * @param destroy
+ *   Internally used function for memory deallocation, on pall_sht_delete() and
+ *   pall_sht_collapse(), of the element pointed by its parameter of type
+ *   void *.
+ *
+ * @param hash
+ *   Internally used function for element hashing. This function shall receive
+ *   a pointer to the element to be hashed and returns a 32-bit integer. The
+ *   returned value is passed through an avalanche finalizer: its upper 25 bits
+ *   select the first group of slots to be probed, while the lower 7 bits are
+ *   stored in the control byte of the element slot. Elements are hashed again
+ *   when the table array is rebuilt.
+ *
+ * @param ser_data
+ *   Internally used function for element serialization.
+ *   This is an optional argument and NULL shall be used to disable
+ *   serialization support, causing serialization calls
+ *   (pall_sht_serialize()) to fail, setting errno to ENOSYS.
+ *
+ * @param unser_data
+ *   Internally used function for element unserialization.
+ *   This is an optional argument and NULL shall be used to disable
+ *   unserialization support, causing unserialization calls
+ *   (pall_sht_unserialize()) to fail, setting errno to ENOSYS.
+ *
+ * @param array_size
+ *   The initial size of the table array, rounded up to a power of two not
+ *   lower than SHT_MIN_ARR_SIZE. If this parameter is set to zero, the default
+ *   value defined by SHT_DEFAULT_ARR_SIZE is used.
+ *
+ * @return
+ *   On success, a pointer to a valid Swiss Hash Table handler is returned.
+ *   On error, NULL is returned, and errno is set appropriately.
+ *   \n\n
+ *   Errors: EINVAL, ENOMEM, ERANGE
+ *
+ * @see pall_sht_insert()
+ * @see pall_sht_search()
+ * @see pall_sht_delete()
+ * @see pall_sht_serialize()
+ * @see pall_sht_unserialize()
+ * @see pall_sht_destroy()
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct sht_handler *pall_sht_init(
+		int (*compare) (const void *d1, const void *d2),
+		void (*destroy) (void *data),
+		ui32_t (*hash) (void *data),
+		int (*ser_data) (pall_fd_t fd, void *data),
+		void *(*unser_data) (pall_fd_t fd),
+		unsigned int array_size);
+
+/**
+ * @brief
+ *   Initializes a Swiss Hash Table handler that performs all of its memory
+ *   allocations through the allocator pointed by 'mm'.
+ *
+ * @param compare
+ *   Same as pall_sht_init().
+ *
+ * @param destroy
+ *   Same as pall_sht_init().
+ *
+ * @param hash
+ *   Same as pall_sht_init().
+ *
+ * @param ser_data
+ *   Same as pall_sht_init().
+ *
+ * @param unser_data
+ *   Same as pall_sht_init().
+ *
+ * @param array_size
+ *   Same as pall_sht_init().
+ *
+ * @param mm
+ *   The allocator to be used by this handler. The structure is copied. If NULL,
+ *   the current default allocator is used.
+ *
+ * @return
+ *   On success, a pointer to a valid Swiss Hash Table handler is returned.
+ *   On error, NULL is returned, and errno is set appropriately.
+ *   \n\n
+ *   Errors: EINVAL, ENOMEM, ERANGE
+ *
+ * @see pall_sht_init()
+ * @see pall_mm_set_allocator()
+ * @see pall_mm
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct sht_handler *pall_sht_init_mm(
+		int (*compare) (const void *d1, const void *d2),
+		void (*destroy) (void *data),
+		ui32_t (*hash) (void *data),
+		int (*ser_data) (pall_fd_t fd, void *data),
+		void *(*unser_data) (pall_fd_t fd),
+		unsigned int array_size,
+		const struct pall_mm *mm);
+
+/**
+ * @brief
+ *   Unitializes and release all resources of a Swiss Hash Table handler
+ *   pointed by parameter 'h'.
+ *
+ * @see pall_sht_init()
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_sht_destroy(struct sht_handler *h);
+
+/**
+ * @brief
+ *   Inserts an element pointed by 'data' into the Swiss Hash Table pointed by
+ *   'h'. Duplicate elements are not checked for.
+ *
+ * @param h
+ *   An initialized Swiss Hash Table handler.
+ *
+ * @param data
+ *   A pointer to the element to be inserted. Shall not be NULL.
+ *
+ * @return
+ *   On success, zero is returned and statistical counter 'insert' is
+ *   incremented. On error, -1 is returned, statistical counter 'insert_err' is
+ *   incremented, and errno is set appropriately.
+ *   \n\n
+ *   Errors: EINVAL, ENOMEM, ERANGE
+ *
+ * @see pall_sht_init()
+ * @see pall_sht_delete()
+ * @see pall_sht_search()
+ * @see sht_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_sht_insert(struct sht_handler *h, void *data);
+
+/**
+ * @brief
+ *   Deletes an element that matches the contents of the element pointed by
+ *   'data' from the Swiss Hash Table pointed by 'h'. The comparision of the
+ *   elements is performed by the compare() function passed to pall_sht_init()
+ *   function.
+ *
+ * @param h
+ *   An initialized Swiss Hash Table handler.
+ *
+ * @param data
+ *   A pointer to the partially filled element to be searched and deleted.
+ *
+ * @return
+ *   On success, zero is returned and statistical counter 'del' is incremented.
+ *   If the element is not found, -1 is returned and statistical counter
+ *   'del_nf' is incremented.
+ *
+ * @see pall_sht_init()
+ * @see pall_sht_insert()
+ * @see sht_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_sht_delete(struct sht_handler *h, void *data);
+
+/**
+ * @brief
+ *   Searches an element that matches the contents of the element pointed by
+ *   'data' on the Swiss Hash Table pointed by 'h'. The comparision of the
+ *   elements is performed by the compare() function passed to pall_sht_init()
+ *   function.
+ *
+ * @param h
+ *   An initialized Swiss Hash Table handler.
+ *
+ * @param data
+ *   A pointer to the partially filled element to be searched.
+ *
+ * @return
+ *   On success, a pointer to the found element is returned and statistical
+ *   counter 'search' is incremented. If the element is not found, NULL is
+ *   returned and statistical counter 'search_nf' is incremented.
+ *
+ * @see pall_sht_init()
+ * @see sht_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_sht_search(struct sht_handler *h, void *data);
+
+/**
+ * @brief
+ *   Serializes the contents of the Swiss Hash Table pointed by 'h', to the file
+ *   descriptor 'fd'.
+ *   The metadata of the table (the element count) is serialized in network
+ *   byte order, followed by the elements.
+ *   Each element is serialized through the ser_data() function passed to
+ *   pall_sht_init(). If this parameter was passed as NULL, this function
+ *   will return error with errno set to ENOSYS.
+ *   The pall_fd_t type is a compatible type to the file descriptor type of the
+ *   system.
+ *
+ * @param h
+ *   An initialized Swiss Hash Table handler.
+ *
+ * @param fd
+ *   A writable file descriptor.
+ *
+ * @return
+ *   On success, zero is returned and statistical counter 'serialize' is
+ *   incremented. On error, -1 is returned, statistical 'serialize_err' is
+ *   incremented, and errno is set appropriately.
+ *   \n\n
+ *   Errors: Same as write() and ENOSYS.
+ *
+ * @see pall_sht_init()
+ * @see pall_sht_unserialize()
+ * @see sht_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_sht_serialize(struct sht_handler *h, pall_fd_t fd);
+
+/**
+ * @brief
+ *   Unserializes the contents from the file descriptor 'fd' into the Flat
+ *   Hash Table pointed by 'h'.
+ *   The unserialized data is converted from network byte order to host byte
+ *   order.
+ *   Each element is serialized through the unser_data() function passed to
+ *   pall_sht_init(). If this parameter was passed as NULL, this function
+ *   will return error with errno set to ENOSYS.
+ *   The pall_fd_t type is a compatible type to the file descriptor type of the
+ *   system.
+ *
+ * @param h
+ *   An initialized Swiss Hash Table handler.
+ *
+ * @param fd
+ *   A readable file descriptor.
+ *
+ * @return
+ *   On success, zero is returned and statistical counter 'unserialize' is
+ *   incremented. On error, -1 is returned, statistical counter
+ *   'unserialize_err' is incremented and, errno is set appropriately.
+ *   \n\n
+ *   Errors: Same as read() and ENOSYS.
+ *
+ * @see pall_sht_init()
+ * @see pall_sht_serialize()
+ * @see sht_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_sht_unserialize(struct sht_handler *h, pall_fd_t fd);
+
+/**
+ * @brief
+ *   Returns statistical information for operations and content of the Flat
+ *   Hash Table pointed by handler 'h'. This function shall be called for
+ *   each time updated statistical counters are required.
+ *
+ * @param h
+ *   An initialized Swiss Hash Table handler.
+ *
+ * @return
+ *   Returns a pointer to a valid struct sht_stat and the statistical
+ *   counter 'stat' is incremented. This function always succeeds.
+ *
+ * @see pall_sht_init()
+ * @see pall_sht_stat_reset()
+ * @see sht_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct sht_stat *pall_sht_stat(struct sht_handler *h);
+
+/**
+ * @brief
+ *   Resets the statistical counters of the Swiss Hash Table pointed by handler
+ *   'h'.
+ *
+ * @param h
+ *   An initialized Swiss Hash Table handler.
+ *
+ * @see pall_sht_init()
+ * @see pall_sht_stat()
+ * @see sht_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_sht_stat_reset(struct sht_handler *h);
+
+/**
+ * @brief
+ *   Returns the number of elements of the Swiss Hash Table pointed by handler
+ *   'h'.
+ *
+ * @param h
+ *   An initialized Swiss Hash Table handler.
+ *
+ * @return
+ *   Returns a positive integer of type ui32_t (32 bit unsigned) if the table
+ *   isn't empty. If it's empty, zero is returned. Statistical counter 'count'
+ *   is always incremented when this function retruns.
+ *
+ * @see pall_sht_init()
+ * @see sht_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_sht_count(struct sht_handler *h);
+
+/**
+ * @brief
+ *   Pops an element that matches the contents of the element pointed by 'data'
+ *   from the Swiss Hash Table pointed by handler 'h'. The comparision of the
+ *   elements is performed by the compare() function passed to pall_sht_init()
+ *   function.
+ *
+ * @param h
+ *   An initialized Swiss Hash Table handler.
+ *
+ * @param data
+ *   A pointer to the partially filled element to be searched and popped.
+ *
+ * @return
+ *   On success, a pointer to the popped element is returned and the
+ *   statistical counter 'pope' is incremented. If the element is not found,
+ *   NULL is returned and the statistical counter 'pope_nf' is incremented.
+ *
+ * @see pall_sht_init()
+ * @see sht_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_sht_pope(struct sht_handler *h, void *data);
+
+/**
+ * @brief
+ *   Removes all the elements from the Swiss Hash Table pointed by handler 'h'.
+ *
+ * @param h
+ *   An initialized Swiss Hash Table handler.
+ *
+ * @return
+ *   This function doesn't return any value. The statistical counter 'collapse'
+ *   is incremented on return.
+ *
+ * @see pall_sht_init()
+ * @see pall_sht_delete()
+ * @see sht_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_sht_collapse(struct sht_handler *h);
+
+/**
+ * @brief
+ *   Iterates the Swiss Hash Table pointed by handler 'h', in array order.
+ *   Elements may be deleted or popped while iterating, since no element is ever
+ *   moved on deletion, so the remaining elements are still returned exactly
+ *   once. Elements inserted while iterating may or may not be returned, and if
+ *   the insertion rebuilds the table, the iteration order is lost.
+ *
+ * @param h
+ *   An initialized Swiss Hash Table handler.
+ *
+ * @return
+ *   Returns a pointer to the next element. If there are no more elements to
+ *   be iterated, NULL is returned and statistical counter 'iterate' is
+ *   incremented.
+ *
+ * @see pall_sht_rewind()
+ * @see sht_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_sht_iterate(struct sht_handler *h);
+
+/**
+ * @brief
+ *   Rewinds the Swiss Hash Table pointed by handler 'h'. The parameter 'to'
+ *   tells to where the rewind should be performed.
+ *
+ * @param h
+ *   An initialized Swiss Hash Table handler.
+ *
+ * @param to
+ *   If set to 0, the table is rewinded to array index zero and
+ *   pall_sht_iterate() will iterate the table from array index zero to
+ *   arr_size - 1.
+ *   \n\n
+ *   If set to 1, the table is rewinded to array index arr_size - 1 and
+ *   pall_sht_iterate() will iterate the table from array index arr_size - 1
+ *   to zero.
+ *
+ * @return
+ *   No value is returned and statistical counter 'rewind' is incremented.
+ *
+ * @see pall_sht_iterate()
+ * @see sht_stat
+ *
+ */
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_sht_rewind(struct sht_handler *h, int to);
+
+#endif
+
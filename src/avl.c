@@ -0,0 +1,343 @@
+/**
+ * @file avl.c
+ * @brief Portable Abstracted Linked Lists Library (libpall)
+ *        AVL Tree interface
+ *
+ * Date: 16-10-2026
+ *
+ * Copyright 2026 Pedro A. Hortas (pah@ucodev.org)
+ *
+ * This file is part of libpall.
+ *
+ * libpall is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libpall is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libpall.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdlib.h>
+
+#include "config.h"
+#include "avl.h"
+
+static int _avl_height(const struct avl_node *node) {
+	return node ? node->height : 0;
+}
+
+static ui32_t _avl_size(const struct avl_node *node) {
+	return node ? node->size : 0;
+}
+
+static void _avl_update(struct avl_node *node) {
+	int left = _avl_height(node->left), right = _avl_height(node->right);
+
+	node->height = 1 + (left > right ? left : right);
+	node->size = 1 + _avl_size(node->left) + _avl_size(node->right);
+}
+
+static void _avl_update_size(struct avl_node *node) {
+	for (; node; node = node->parent)
+		node->size = 1 + _avl_size(node->left) + _avl_size(node->right);
+}
+
+static void _avl_replace_child(
+		struct avl_node **root,
+		struct avl_node *parent,
+		struct avl_node *old,
+		struct avl_node *node)
+{
+	if (!parent) {
+		*root = node;
+	} else if (parent->left == old) {
+		parent->left = node;
+	} else {
+		parent->right = node;
+	}
+}
+
+static struct avl_node *_avl_rotate_left(struct avl_node **root, struct avl_node *node) {
+	struct avl_node *pivot = node->right;
+
+	if ((node->right = pivot->left))
+		pivot->left->parent = node;
+
+	pivot->parent = node->parent;
+	_avl_replace_child(root, node->parent, node, pivot);
+
+	pivot->left = node;
+	node->parent = pivot;
+
+	_avl_update(node);
+	_avl_update(pivot);
+
+	return pivot;
+}
+
+static struct avl_node *_avl_rotate_right(struct avl_node **root, struct avl_node *node) {
+	struct avl_node *pivot = node->left;
+
+	if ((node->left = pivot->right))
+		pivot->right->parent = node;
+
+	pivot->parent = node->parent;
+	_avl_replace_child(root, node->parent, node, pivot);
+
+	pivot->right = node;
+	node->parent = pivot;
+
+	_avl_update(node);
+	_avl_update(pivot);
+
+	return pivot;
+}
+
+/* Returns the parent of the node where rebalancing stopped, or NULL */
+static struct avl_node *_avl_rebalance(struct avl_node **root, struct avl_node *node) {
+	int balance = 0, height = 0;
+
+	/* Walk up until a subtree keeps its height, as no ancestor above it
+	 * can be affected by the change.
+	 */
+	for (; node; node = node->parent) {
+		height = node->height;
+
+		_avl_update(node);
+
+		balance = _avl_height(node->left) - _avl_height(node->right);
+
+		if (balance > 1) {
+			if (_avl_height(node->left->left) < _avl_height(node->left->right))
+				_avl_rotate_left(root, node->left);
+
+			node = _avl_rotate_right(root, node);
+		} else if (balance < -1) {
+			if (_avl_height(node->right->right) < _avl_height(node->right->left))
+				_avl_rotate_right(root, node->right);
+
+			node = _avl_rotate_left(root, node);
+		} else if (node->height == height) {
+			return node->parent;
+		}
+	}
+
+	return NULL;
+}
+
+void avl_insert(
+		struct avl_node **root,
+		struct avl_node *node,
+		const void *key,
+		avl_cmp_t cmp,
+		void *arg)
+{
+	struct avl_node *parent = NULL, **link = root;
+
+	/* Every node on the path gains the new node as a descendant */
+	while (*link) {
+		parent = *link;
+		parent->size ++;
+		link = (cmp(key, parent, arg) < 0) ? &parent->left : &parent->right;
+	}
+
+	node->left = NULL;
+	node->right = NULL;
+	node->parent = parent;
+	node->height = 1;
+	node->size = 1;
+
+	*link = node;
+
+	_avl_rebalance(root, parent);
+}
+
+void avl_remove(struct avl_node **root, struct avl_node *node) {
+	struct avl_node *child = NULL, *succ = NULL, *start = NULL;
+
+	if (node->left && node->right) {
+		/* Replace the node by its in-order successor, which has no left
+		 * child.
+		 */
+		for (succ = node->right; succ->left; succ = succ->left);
+
+		if (succ->parent == node) {
+			start = succ;
+		} else {
+			start = succ->parent;
+
+			if ((start->left = succ->right))
+				succ->right->parent = start;
+
+			succ->right = node->right;
+			node->right->parent = succ;
+		}
+
+		succ->left = node->left;
+		node->left->parent = succ;
+
+		succ->parent = node->parent;
+		succ->height = node->height;
+		_avl_replace_child(root, node->parent, node, succ);
+
+		start = _avl_rebalance(root, start);
+	} else {
+		if ((child = node->left ? node->left : node->right))
+			child->parent = node->parent;
+
+		_avl_replace_child(root, node->parent, node, child);
+
+		start = _avl_rebalance(root, node->parent);
+	}
+
+	/* Every ancestor above the rebalanced path still lost an element */
+	_avl_update_size(start);
+}
+
+struct avl_node *avl_find(struct avl_node *root, const void *key, avl_cmp_t cmp, void *arg) {
+	int ret = 0;
+
+	while (root) {
+		if (!(ret = cmp(key, root, arg)))
+			return root;
+
+		root = (ret < 0) ? root->left : root->right;
+	}
+
+	return NULL;
+}
+
+struct avl_node *avl_lower_bound(struct avl_node *root, const void *key, avl_cmp_t cmp, void *arg) {
+	struct avl_node *bound = NULL;
+
+	while (root) {
+		if (cmp(key, root, arg) <= 0) {
+			bound = root;
+			root = root->left;
+		} else {
+			root = root->right;
+		}
+	}
+
+	return bound;
+}
+
+struct avl_node *avl_upper_bound(struct avl_node *root, const void *key, avl_cmp_t cmp, void *arg) {
+	struct avl_node *bound = NULL;
+
+	while (root) {
+		if (cmp(key, root, arg) < 0) {
+			bound = root;
+			root = root->left;
+		} else {
+			root = root->right;
+		}
+	}
+
+	return bound;
+}
+
+struct avl_node *avl_select(struct avl_node *root, ui32_t k) {
+	ui32_t left = 0;
+
+	while (root) {
+		if (k == (left = _avl_size(root->left)))
+			return root;
+
+		if (k < left) {
+			root = root->left;
+		} else {
+			k -= left + 1;
+			root = root->right;
+		}
+	}
+
+	return NULL;
+}
+
+ui32_t avl_count_lower(struct avl_node *root, const void *key, avl_cmp_t cmp, void *arg) {
+	ui32_t count = 0;
+
+	while (root) {
+		if (cmp(key, root, arg) <= 0) {
+			root = root->left;
+		} else {
+			count += _avl_size(root->left) + 1;
+			root = root->right;
+		}
+	}
+
+	return count;
+}
+
+struct avl_node *avl_first(struct avl_node *root) {
+	if (root) {
+		while (root->left)
+			root = root->left;
+	}
+
+	return root;
+}
+
+struct avl_node *avl_last(struct avl_node *root) {
+	if (root) {
+		while (root->right)
+			root = root->right;
+	}
+
+	return root;
+}
+
+struct avl_node *avl_next(struct avl_node *node) {
+	if (node->right)
+		return avl_first(node->right);
+
+	while (node->parent && (node == node->parent->right))
+		node = node->parent;
+
+	return node->parent;
+}
+
+struct avl_node *avl_prev(struct avl_node *node) {
+	if (node->left)
+		return avl_last(node->left);
+
+	while (node->parent && (node == node->parent->left))
+		node = node->parent;
+
+	return node->parent;
+}
+
+void avl_destroy(struct avl_node **root, void (*release) (struct avl_node *node, void *arg), void *arg) {
+	struct avl_node *node = *root, *parent = NULL;
+
+	/* Post-order walk, detaching each leaf before releasing it */
+	while (node) {
+		if (node->left) {
+			node = node->left;
+		} else if (node->right) {
+			node = node->right;
+		} else {
+			if ((parent = node->parent)) {
+				if (parent->left == node) {
+					parent->left = NULL;
+				} else {
+					parent->right = NULL;
+				}
+			}
+
+			release(node, arg);
+
+			node = parent;
+		}
+	}
+
+	*root = NULL;
+}
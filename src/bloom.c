@@ -0,0 +1,135 @@
+/**
+ * @file bloom.c
+ * @brief Portable Abstracted Linked Lists Library (libpall)
+ *        Counting Bloom Filter interface
+ *
+ * Date: 16-10-2026
+ *
+ * Copyright 2026 Pedro A. Hortas (pah@ucodev.org)
+ *
+ * This file is part of libpall.
+ *
+ * libpall is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libpall is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libpall.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string.h>
+#include <errno.h>
+
+#include "config.h"
+#include "pall.h"
+#include "mm.h"
+#include "hash.h"
+#include "bloom.h"
+
+#define BLOOM_BLOCK_SIZE	(BLOOM_BLOCK_COUNTERS / 2)
+
+static unsigned char *_bloom_block(const struct bloom *bloom, ui32_t hash) {
+	/* Multiply-shift reduction, so that any number of blocks is evenly
+	 * addressed without a division.
+	 */
+	return &bloom->counters[(size_t) (((ui64_t) hash_fmix32(hash) * bloom->blocks) >> 32) * BLOOM_BLOCK_SIZE];
+}
+
+int bloom_init(struct bloom *bloom, const struct pall_mm *mm, ui32_t capacity, ui32_t bits) {
+	ui64_t blocks = ((ui64_t) capacity * bits + BLOOM_BLOCK_COUNTERS - 1) / BLOOM_BLOCK_COUNTERS;
+
+	if (!capacity || !bits) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if ((blocks > 0xffffffffULL) || ((size_t) blocks > ((size_t) -1) / BLOOM_BLOCK_SIZE)) {
+		errno = ERANGE;
+		return -1;
+	}
+
+	if (!(bloom->counters = (unsigned char *) mm_calloc_with(mm, (size_t) blocks, BLOOM_BLOCK_SIZE)))
+		return -1;
+
+	bloom->blocks = (ui32_t) blocks;
+
+	/* The optimal number of counters per element is bits * ln(2) */
+	bloom->k = (bits * 69 + 50) / 100;
+
+	if (!bloom->k)
+		bloom->k = 1;
+
+	if (bloom->k > BLOOM_K_MAX)
+		bloom->k = BLOOM_K_MAX;
+
+	return 0;
+}
+
+void bloom_release(struct bloom *bloom, const struct pall_mm *mm) {
+	if (bloom->counters)
+		mm_free_with(mm, bloom->counters);
+
+	memset(bloom, 0, sizeof(struct bloom));
+}
+
+void bloom_clear(struct bloom *bloom) {
+	if (bloom->counters)
+		memset(bloom->counters, 0, (size_t) bloom->blocks * BLOOM_BLOCK_SIZE);
+}
+
+void bloom_add(struct bloom *bloom, ui32_t hash) {
+	unsigned char *block = _bloom_block(bloom, hash);
+	ui64_t probes = hash_fmix64(hash);
+	ui32_t i = 0, slot = 0, shift = 0;
+
+	for (i = 0; i < bloom->k; i ++, probes >>= 7) {
+		slot = (ui32_t) probes & (BLOOM_BLOCK_COUNTERS - 1);
+		shift = (slot & 1) << 2;
+
+		if (((block[slot >> 1] >> shift) & 0xf) != 0xf)
+			block[slot >> 1] += 1 << shift;
+	}
+}
+
+void bloom_del(struct bloom *bloom, ui32_t hash) {
+	unsigned char *block = _bloom_block(bloom, hash);
+	ui64_t probes = hash_fmix64(hash);
+	ui32_t i = 0, slot = 0, shift = 0, counter = 0;
+
+	for (i = 0; i < bloom->k; i ++, probes >>= 7) {
+		slot = (ui32_t) probes & (BLOOM_BLOCK_COUNTERS - 1);
+		shift = (slot & 1) << 2;
+		counter = (block[slot >> 1] >> shift) & 0xf;
+
+		/* Saturated counters no longer know how many elements hit them */
+		if (counter && (counter != 0xf))
+			block[slot >> 1] -= 1 << shift;
+	}
+}
+
+int bloom_test(const struct bloom *bloom, ui32_t hash) {
+	const unsigned char *block = _bloom_block(bloom, hash);
+	ui64_t probes = hash_fmix64(hash);
+	ui32_t i = 0, slot = 0;
+
+	for (i = 0; i < bloom->k; i ++, probes >>= 7) {
+		slot = (ui32_t) probes & (BLOOM_BLOCK_COUNTERS - 1);
+
+		if (!((block[slot >> 1] >> ((slot & 1) << 2)) & 0xf))
+			return 0;
+	}
+
+	return 1;
+}
+
+void bloom_prefetch(const struct bloom *bloom, ui32_t hash) {
+	mm_prefetch(_bloom_block(bloom, hash));
+}
+
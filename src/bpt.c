@@ -0,0 +1,953 @@
+/**
+ * @file bpt.c
+ * @brief Portable Abstracted Linked Lists Library (libpall)
+ *        B+ Tree interface
+ *
+ * Date: 16-10-2026
+ *
+ * Copyright 2026 Pedro A. Hortas (pah@ucodev.org)
+ *
+ * This file is part of libpall.
+ *
+ * libpall is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libpall is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libpall.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#include "config.h"
+#include "mm.h"
+#include "pall.h"
+#include "bpt.h"
+
+#define BPT_INNER_MAX	(BPT_INNER_KEYS + 1)
+#define BPT_INNER_MIN	((BPT_INNER_MAX + 1) / 2)
+#define BPT_LEAF_MIN	((BPT_LEAF_ELEMS + 1) / 2)
+#define BPT_NODE_SIZE	((sizeof(struct bpt_inner) > sizeof(struct bpt_leaf)) ? sizeof(struct bpt_inner) : sizeof(struct bpt_leaf))
+
+/* The inner nodes traversed by a descent, from the root, and the index of the
+ * child taken on each of them.
+ */
+struct bpt_path {
+	struct bpt_inner *node[BPT_DEPTH_MAX];
+	ui32_t index[BPT_DEPTH_MAX];
+};
+
+static struct bpt_node *_bpt_node_alloc(struct bpt_handler *handler) {
+	/* The pool is only created on an empty tree, so that all the nodes of a
+	 * pooled tree are always owned by the pool.
+	 */
+	if (!handler->_pool.size && (handler->_config_flags & CONFIG_MM_POOL) && !handler->_nodes) {
+		mm_pool_init(&handler->_pool, &handler->_mm, BPT_NODE_SIZE, BPT_MM_POOL_NMEMB_MIN, BPT_MM_POOL_NMEMB_MAX);
+		mm_pool_align(&handler->_pool, BPT_NODE_ALIGN);
+	}
+
+	if (handler->_pool.size)
+		return (struct bpt_node *) mm_pool_alloc(&handler->_pool);
+
+	return (struct bpt_node *) mm_alloc_with(&handler->_mm, BPT_NODE_SIZE);
+}
+
+static void _bpt_node_free(struct bpt_handler *handler, struct bpt_node *node) {
+	if (handler->_pool.size) {
+		mm_pool_free(&handler->_pool, node);
+	} else {
+		mm_free_with(&handler->_mm, node);
+	}
+}
+
+static void _bpt_node_release(struct bpt_handler *handler, struct bpt_node *node, ui32_t level) {
+	ui32_t i = 0;
+
+	if ((level + 1) < handler->_height) {
+		for (i = 0; i < node->count; i ++)
+			_bpt_node_release(handler, ((struct bpt_inner *) node)->children[i], level + 1);
+	} else {
+		for (i = 0; i < node->count; i ++)
+			handler->destroy(((struct bpt_leaf *) node)->data[i]);
+	}
+
+	/* Pooled nodes are released all at once, along with the pool */
+	if (!handler->_pool.size)
+		mm_free_with(&handler->_mm, node);
+}
+
+/* Returns the position of the first of the 'n' sorted elements that is not
+ * lower than 'data', or greater than 'data' if 'upper' is set.
+ */
+static ui32_t _bpt_bound(struct bpt_handler *handler, void *const *elems, ui32_t n, const void *data, int upper) {
+	ui32_t lo = 0, hi = n, mid = 0;
+	int ret = 0;
+
+	while (lo < hi) {
+		mid = (lo + hi) >> 1;
+
+		ret = handler->compare(data, elems[mid]);
+
+		if ((ret < 0) || (!ret && !upper)) {
+			hi = mid;
+		} else {
+			lo = mid + 1;
+		}
+	}
+
+	return lo;
+}
+
+static struct bpt_leaf *_bpt_descend(struct bpt_handler *handler, const void *data, int upper, struct bpt_path *path) {
+	struct bpt_node *node = handler->root;
+	struct bpt_inner *inner = NULL;
+	ui32_t level = 0, i = 0;
+
+	for (level = 0; (level + 1) < handler->_height; level ++) {
+		inner = (struct bpt_inner *) node;
+
+		i = _bpt_bound(handler, inner->keys, inner->node.count - 1, data, upper);
+
+		if (path) {
+			path->node[level] = inner;
+			path->index[level] = i;
+		}
+
+		node = inner->children[i];
+	}
+
+	return (struct bpt_leaf *) node;
+}
+
+static struct bpt_leaf *_bpt_edge(struct bpt_handler *handler, int last) {
+	struct bpt_node *node = handler->root;
+	ui32_t level = 0;
+
+	for (level = 0; (level + 1) < handler->_height; level ++)
+		node = ((struct bpt_inner *) node)->children[last ? (node->count - 1) : 0];
+
+	return (struct bpt_leaf *) node;
+}
+
+/* Returns the first element of the subtree rooted at 'node', at 'level' */
+static void *_bpt_first(struct bpt_handler *handler, struct bpt_node *node, ui32_t level) {
+	for (; (level + 1) < handler->_height; level ++)
+		node = ((struct bpt_inner *) node)->children[0];
+
+	return ((struct bpt_leaf *) node)->data[0];
+}
+
+/* Moves the path to the leaf following the one it currently leads to */
+static void _bpt_path_next(struct bpt_handler *handler, struct bpt_path *path) {
+	ui32_t level = handler->_height - 1;
+
+	/* Climb to the lowest ancestor with a following child */
+	while ((path->index[level - 1] + 1) == path->node[level - 1]->node.count)
+		level --;
+
+	path->index[level - 1] ++;
+
+	for (; (level + 1) < handler->_height; level ++) {
+		path->node[level] = (struct bpt_inner *) path->node[level - 1]->children[path->index[level - 1]];
+		path->index[level] = 0;
+	}
+}
+
+/* Returns the leaf holding the first element not lower than 'data', setting
+ * its position at 'pos', or NULL if there's no such element.
+ */
+static struct bpt_leaf *_bpt_lower(struct bpt_handler *handler, const void *data, struct bpt_path *path, ui32_t *pos) {
+	struct bpt_leaf *leaf = NULL;
+
+	if (!handler->root)
+		return NULL;
+
+	leaf = _bpt_descend(handler, data, 0, path);
+
+	/* The separator followed by the descent may match the first element of
+	 * the next leaf.
+	 */
+	if ((*pos = _bpt_bound(handler, leaf->data, leaf->node.count, data, 0)) == leaf->node.count) {
+		if (!(leaf = leaf->next))
+			return NULL;
+
+		if (path)
+			_bpt_path_next(handler, path);
+
+		*pos = 0;
+	}
+
+	return leaf;
+}
+
+/* Places the iteration cursor at 'pos' of 'leaf', or past the end if NULL */
+static void _bpt_iterate_at(struct bpt_handler *handler, struct bpt_leaf *leaf, ui32_t pos) {
+	handler->_iterate_leaf = leaf;
+	handler->_iterate_pos = pos;
+	handler->_iterate_next = leaf ? leaf->data[pos] : NULL;
+}
+
+/* Moves the iteration cursor past the element it is placed at */
+static void _bpt_iterate_step(struct bpt_handler *handler) {
+	struct bpt_leaf *leaf = handler->_iterate_leaf;
+	ui32_t pos = handler->_iterate_pos;
+
+	if (!handler->_iterate_reverse) {
+		if (++ pos == leaf->node.count) {
+			leaf = leaf->next;
+			pos = 0;
+		}
+	} else if (!pos) {
+		if ((leaf = leaf->prev))
+			pos = leaf->node.count - 1;
+	} else {
+		pos --;
+	}
+
+	_bpt_iterate_at(handler, leaf, pos);
+}
+
+/* Places the iteration cursor back at the element 'data' after the tree was
+ * modified, telling it apart from equal elements by its pointer.
+ */
+static void _bpt_iterate_seek(struct bpt_handler *handler, void *data) {
+	struct bpt_leaf *leaf = NULL;
+	ui32_t pos = 0;
+
+	for (leaf = _bpt_lower(handler, data, NULL, &pos); leaf->data[pos] != data; ) {
+		if (++ pos == leaf->node.count) {
+			leaf = leaf->next;
+			pos = 0;
+		}
+	}
+
+	_bpt_iterate_at(handler, leaf, pos);
+}
+
+static void _bpt_inner_split(
+		struct bpt_inner *inner,
+		struct bpt_inner *right,
+		ui32_t index,
+		void **key,
+		struct bpt_node **child)
+{
+	void *keys[BPT_INNER_KEYS + 1];
+	struct bpt_node *children[BPT_INNER_MAX + 1];
+	ui32_t left_count = (BPT_INNER_MAX + 2) / 2;
+
+	memcpy(keys, inner->keys, index * sizeof(void *));
+	keys[index] = *key;
+	memcpy(&keys[index + 1], &inner->keys[index], (BPT_INNER_KEYS - index) * sizeof(void *));
+
+	memcpy(children, inner->children, (index + 1) * sizeof(struct bpt_node *));
+	children[index + 1] = *child;
+	memcpy(&children[index + 2], &inner->children[index + 1], (BPT_INNER_MAX - index - 1) * sizeof(struct bpt_node *));
+
+	/* The key between both halves moves up to the parent */
+	memcpy(inner->keys, keys, (left_count - 1) * sizeof(void *));
+	memcpy(inner->children, children, left_count * sizeof(struct bpt_node *));
+	inner->node.count = left_count;
+
+	memcpy(right->keys, &keys[left_count], (BPT_INNER_MAX - left_count) * sizeof(void *));
+	memcpy(right->children, &children[left_count], (BPT_INNER_MAX + 1 - left_count) * sizeof(struct bpt_node *));
+	right->node.count = BPT_INNER_MAX + 1 - left_count;
+
+	*key = keys[left_count - 1];
+	*child = (struct bpt_node *) right;
+}
+
+static void _bpt_leaf_split(struct bpt_leaf *leaf, struct bpt_leaf *right, ui32_t pos, void *data) {
+	void *elems[BPT_LEAF_ELEMS + 1];
+	ui32_t left_count = (BPT_LEAF_ELEMS + 1) / 2;
+
+	memcpy(elems, leaf->data, pos * sizeof(void *));
+	elems[pos] = data;
+	memcpy(&elems[pos + 1], &leaf->data[pos], (BPT_LEAF_ELEMS - pos) * sizeof(void *));
+
+	memcpy(leaf->data, elems, left_count * sizeof(void *));
+	leaf->node.count = left_count;
+
+	memcpy(right->data, &elems[left_count], (BPT_LEAF_ELEMS + 1 - left_count) * sizeof(void *));
+	right->node.count = BPT_LEAF_ELEMS + 1 - left_count;
+
+	if ((right->next = leaf->next))
+		right->next->prev = right;
+
+	right->prev = leaf;
+	leaf->next = right;
+}
+
+static int _bpt_insert(struct bpt_handler *handler, void *data) {
+	struct bpt_path path;
+	struct bpt_node *spare[BPT_DEPTH_MAX + 1];
+	struct bpt_node *child = NULL;
+	struct bpt_leaf *leaf = NULL;
+	struct bpt_inner *inner = NULL;
+	ui32_t nspare = 0, level = 0, pos = 0, i = 0;
+	void *key = NULL;
+
+	/* Elements may move between leaves, so an ongoing iteration looks up its
+	 * next element again.
+	 */
+	handler->_iterate_leaf = NULL;
+
+	if (!handler->root) {
+		if (!(leaf = (struct bpt_leaf *) _bpt_node_alloc(handler))) {
+			handler->_stat.insert_err ++;
+			return -1;
+		}
+
+		leaf->node.count = 0;
+		leaf->prev = NULL;
+		leaf->next = NULL;
+
+		handler->root = (struct bpt_node *) leaf;
+		handler->_height = 1;
+		handler->_nodes = 1;
+	}
+
+	leaf = _bpt_descend(handler, data, 1, &path);
+
+	/* A full leaf splits, and so does each full ancestor receiving the new
+	 * separator, plus a new root if the root splits. All the nodes are
+	 * allocated up front, so that a failure leaves the tree untouched.
+	 */
+	if (leaf->node.count == BPT_LEAF_ELEMS) {
+		for (nspare = 1, level = handler->_height - 1; level && (path.node[level - 1]->node.count == BPT_INNER_MAX); level --)
+			nspare ++;
+
+		if (!level)
+			nspare ++;
+
+		for (i = 0; i < nspare; i ++) {
+			if (!(spare[i] = _bpt_node_alloc(handler))) {
+				while (i --)
+					_bpt_node_free(handler, spare[i]);
+
+				handler->_stat.insert_err ++;
+
+				return -1;
+			}
+		}
+
+		handler->_nodes += nspare;
+	}
+
+	pos = _bpt_bound(handler, leaf->data, leaf->node.count, data, 1);
+
+	if (leaf->node.count < BPT_LEAF_ELEMS) {
+		memmove(&leaf->data[pos + 1], &leaf->data[pos], (leaf->node.count - pos) * sizeof(void *));
+		leaf->data[pos] = data;
+		leaf->node.count ++;
+	} else {
+		child = spare[-- nspare];
+
+		_bpt_leaf_split(leaf, (struct bpt_leaf *) child, pos, data);
+
+		key = ((struct bpt_leaf *) child)->data[0];
+
+		for (level = handler->_height - 1; level && child; level --) {
+			inner = path.node[level - 1];
+			i = path.index[level - 1];
+
+			if (inner->node.count < BPT_INNER_MAX) {
+				memmove(&inner->keys[i + 1], &inner->keys[i], (inner->node.count - 1 - i) * sizeof(void *));
+				memmove(&inner->children[i + 2], &inner->children[i + 1], (inner->node.count - 1 - i) * sizeof(struct bpt_node *));
+
+				inner->keys[i] = key;
+				inner->children[i + 1] = child;
+				inner->node.count ++;
+
+				child = NULL;
+			} else {
+				_bpt_inner_split(inner, (struct bpt_inner *) spare[-- nspare], i, &key, &child);
+			}
+		}
+
+		if (child) {
+			inner = (struct bpt_inner *) spare[-- nspare];
+
+			inner->keys[0] = key;
+			inner->children[0] = handler->root;
+			inner->children[1] = child;
+			inner->node.count = 2;
+
+			handler->root = (struct bpt_node *) inner;
+			handler->_height ++;
+		}
+	}
+
+	handler->_stat.insert ++;
+	handler->_count ++;
+
+	if (handler->_stat.elem_count_max < handler->_count)
+		handler->_stat.elem_count_max = handler->_count;
+
+	return 0;
+}
+
+/* Refills the node at 'level' of the path, which lost an entry, from one of
+ * its siblings, merging both if the sibling has no entries to spare. Merges
+ * remove an entry from the parent, so they carry on to the upper levels.
+ */
+static void _bpt_rebalance(struct bpt_handler *handler, struct bpt_path *path, struct bpt_node *node) {
+	ui32_t level = handler->_height - 1, min = BPT_LEAF_MIN, sep = 0, i = 0;
+	struct bpt_inner *parent = NULL, *left_in = NULL, *right_in = NULL;
+	struct bpt_leaf *left_lf = NULL, *right_lf = NULL;
+	struct bpt_node *left = NULL, *right = NULL;
+
+	for (; level && (node->count < min); level --, node = (struct bpt_node *) parent, min = BPT_INNER_MIN) {
+		parent = path->node[level - 1];
+		i = path->index[level - 1];
+
+		/* Prefer the left sibling, so that the separator is at 'i' - 1 */
+		sep = i ? (i - 1) : 0;
+		left = parent->children[sep];
+		right = parent->children[sep + 1];
+
+		if ((level + 1) == handler->_height) {
+			left_lf = (struct bpt_leaf *) left;
+			right_lf = (struct bpt_leaf *) right;
+
+			if ((left == node) && (right->count > min)) {
+				left_lf->data[left->count ++] = right_lf->data[0];
+				memmove(right_lf->data, &right_lf->data[1], (-- right->count) * sizeof(void *));
+				parent->keys[sep] = right_lf->data[0];
+				return;
+			}
+
+			if ((right == node) && (left->count > min)) {
+				memmove(&right_lf->data[1], right_lf->data, (right->count ++) * sizeof(void *));
+				right_lf->data[0] = left_lf->data[-- left->count];
+				parent->keys[sep] = right_lf->data[0];
+				return;
+			}
+
+			memcpy(&left_lf->data[left->count], right_lf->data, right->count * sizeof(void *));
+			left->count += right->count;
+
+			if ((left_lf->next = right_lf->next))
+				left_lf->next->prev = left_lf;
+		} else {
+			left_in = (struct bpt_inner *) left;
+			right_in = (struct bpt_inner *) right;
+
+			if ((left == node) && (right->count > min)) {
+				left_in->keys[left->count - 1] = parent->keys[sep];
+				left_in->children[left->count ++] = right_in->children[0];
+				parent->keys[sep] = right_in->keys[0];
+
+				memmove(right_in->keys, &right_in->keys[1], (right->count - 2) * sizeof(void *));
+				memmove(right_in->children, &right_in->children[1], (right->count - 1) * sizeof(struct bpt_node *));
+				right->count --;
+				return;
+			}
+
+			if ((right == node) && (left->count > min)) {
+				memmove(&right_in->keys[1], right_in->keys, (right->count - 1) * sizeof(void *));
+				memmove(&right_in->children[1], right_in->children, right->count * sizeof(struct bpt_node *));
+				right->count ++;
+
+				right_in->keys[0] = parent->keys[sep];
+				right_in->children[0] = left_in->children[-- left->count];
+				parent->keys[sep] = left_in->keys[left->count - 1];
+				return;
+			}
+
+			left_in->keys[left->count - 1] = parent->keys[sep];
+			memcpy(&left_in->keys[left->count], right_in->keys, (right->count - 1) * sizeof(void *));
+			memcpy(&left_in->children[left->count], right_in->children, right->count * sizeof(struct bpt_node *));
+			left->count += right->count;
+		}
+
+		_bpt_node_free(handler, right);
+		handler->_nodes --;
+
+		memmove(&parent->keys[sep], &parent->keys[sep + 1], (parent->node.count - 2 - sep) * sizeof(void *));
+		memmove(&parent->children[sep + 1], &parent->children[sep + 2], (parent->node.count - 2 - sep) * sizeof(struct bpt_node *));
+		parent->node.count --;
+	}
+
+	if (level)
+		return;
+
+	/* The root is the only node allowed to underflow, down to a single child
+	 * or an empty leaf, which are removed along with a tree level.
+	 */
+	node = handler->root;
+
+	if ((handler->_height > 1) && (node->count == 1)) {
+		handler->root = ((struct bpt_inner *) node)->children[0];
+		handler->_height --;
+	} else if ((handler->_height == 1) && !node->count) {
+		handler->root = NULL;
+		handler->_height = 0;
+	} else {
+		return;
+	}
+
+	_bpt_node_free(handler, node);
+	handler->_nodes --;
+}
+
+static int _bpt_delete(struct bpt_handler *handler, void *data) {
+	struct bpt_path path;
+	struct bpt_leaf *leaf = NULL;
+	ui32_t pos = 0, level = 0;
+	void *elem = NULL;
+
+	if (!(leaf = _bpt_lower(handler, data, &path, &pos)) || handler->compare(data, leaf->data[pos])) {
+		handler->_stat.del_nf ++;
+		return -1;
+	}
+
+	elem = leaf->data[pos];
+
+	/* An ongoing iteration skips the deleted element, and looks up its next
+	 * element again as elements may move between leaves.
+	 */
+	if (elem == handler->_iterate_next) {
+		_bpt_iterate_at(handler, leaf, pos);
+		_bpt_iterate_step(handler);
+	}
+
+	handler->_iterate_leaf = NULL;
+
+	memmove(&leaf->data[pos], &leaf->data[pos + 1], (leaf->node.count - pos - 1) * sizeof(void *));
+	leaf->node.count --;
+
+	/* Separators are element pointers, so an ancestor key referring to the
+	 * deleted element is replaced by the first element of the subtree that
+	 * follows it, which is an equally valid separator.
+	 */
+	for (level = 0; (level + 1) < handler->_height; level ++) {
+		if (path.index[level] && (path.node[level]->keys[path.index[level] - 1] == elem))
+			path.node[level]->keys[path.index[level] - 1] = _bpt_first(handler, path.node[level]->children[path.index[level]], level + 1);
+	}
+
+	_bpt_rebalance(handler, &path, (struct bpt_node *) leaf);
+
+	handler->destroy(elem);
+
+	handler->_stat.del ++;
+	handler->_count --;
+
+	return 0;
+}
+
+static void *_bpt_search(struct bpt_handler *handler, void *data) {
+	struct bpt_leaf *leaf = NULL;
+	ui32_t pos = 0;
+
+	if (!(leaf = _bpt_lower(handler, data, NULL, &pos)) || handler->compare(data, leaf->data[pos])) {
+		handler->_stat.search_nf ++;
+		return NULL;
+	}
+
+	handler->_stat.search ++;
+
+	return leaf->data[pos];
+}
+
+static void *_bpt_lower_bound(struct bpt_handler *handler, void *data) {
+	struct bpt_leaf *leaf = NULL;
+	ui32_t pos = 0;
+
+	if (!(leaf = _bpt_lower(handler, data, NULL, &pos))) {
+		handler->_stat.search_nf ++;
+		return NULL;
+	}
+
+	handler->_stat.search ++;
+
+	return leaf->data[pos];
+}
+
+static void *_bpt_upper_bound(struct bpt_handler *handler, void *data) {
+	struct bpt_leaf *leaf = NULL;
+	ui32_t pos = 0;
+
+	if (handler->root) {
+		leaf = _bpt_descend(handler, data, 1, NULL);
+
+		if ((pos = _bpt_bound(handler, leaf->data, leaf->node.count, data, 1)) == leaf->node.count) {
+			leaf = leaf->next;
+			pos = 0;
+		}
+	}
+
+	if (!leaf) {
+		handler->_stat.search_nf ++;
+		return NULL;
+	}
+
+	handler->_stat.search ++;
+
+	return leaf->data[pos];
+}
+
+static ui32_t _bpt_count(struct bpt_handler *handler) {
+	handler->_stat.count ++;
+
+	return handler->_count;
+}
+
+static int _bpt_serialize(struct bpt_handler *handler, pall_fd_t fd) {
+	ui32_t count_nbo = pall_htonl(handler->_count);
+	struct bpt_leaf *leaf = NULL;
+	ui32_t i = 0;
+	int ret = 0;
+
+	if (!handler->ser_data) {
+		handler->_stat.serialize_err ++;
+		errno = ENOSYS;
+		return -1;
+	}
+
+	if (pall_write(fd, &count_nbo, 4) != 4) {
+		handler->_stat.serialize_err ++;
+		return -1;
+	}
+
+	for (leaf = handler->root ? _bpt_edge(handler, 0) : NULL; leaf && !ret; leaf = leaf->next) {
+		for (i = 0; (i < leaf->node.count) && !ret; i ++)
+			ret = handler->ser_data(fd, leaf->data[i]);
+	}
+
+	if (ret)
+		handler->_stat.serialize_err ++;
+	else
+		handler->_stat.serialize ++;
+
+	return ret;
+}
+
+static int _bpt_unserialize(struct bpt_handler *handler, pall_fd_t fd) {
+	ui32_t count = 0;
+	void *data = NULL;
+
+	if (!handler->unser_data) {
+		handler->_stat.unserialize_err ++;
+		errno = ENOSYS;
+		return -1;
+	}
+
+	if (pall_read(fd, &count, 4) != 4) {
+		handler->_stat.unserialize_err ++;
+		return -1;
+	}
+
+	for (count = ntohl(count); count; count --) {
+		if (!(data = handler->unser_data(fd))) {
+			handler->_stat.unserialize_err ++;
+			return -1;
+		}
+
+		if (handler->insert(handler, data) < 0) {
+			handler->_stat.unserialize_err ++;
+			return -1;
+		}
+	}
+
+	handler->_stat.unserialize ++;
+
+	return 0;
+}
+
+static struct bpt_stat *_bpt_stat(struct bpt_handler *handler) {
+	handler->_stat.elem_count_cur = handler->_count;
+	handler->_stat.node_count = handler->_nodes;
+	handler->_stat.height = handler->_height;
+	handler->_stat.stat ++;
+
+	return &handler->_stat;
+}
+
+static void _bpt_stat_reset(struct bpt_handler *handler) {
+	memset(&handler->_stat, 0, sizeof(struct bpt_stat));
+}
+
+static void _bpt_collapse(struct bpt_handler *handler) {
+	if (handler->root)
+		_bpt_node_release(handler, handler->root, 0);
+
+	if (handler->_pool.size)
+		mm_pool_release(&handler->_pool);
+
+	handler->_stat.collapse ++;
+	handler->_count = 0;
+	handler->_height = 0;
+	handler->_nodes = 0;
+	handler->root = NULL;
+
+	_bpt_iterate_at(handler, NULL, 0);
+}
+
+static void *_bpt_iterate(struct bpt_handler *handler) {
+	void *data = handler->_iterate_next;
+
+	/* Ranges end at the first element not lower than their upper bound */
+	if (data && handler->_iterate_hi && (handler->compare(handler->_iterate_hi, data) <= 0))
+		data = NULL;
+
+	if (!data) {
+		_bpt_iterate_at(handler, NULL, 0);
+		handler->_stat.iterate ++;
+		return NULL;
+	}
+
+	/* The tree was modified since the last call */
+	if (!handler->_iterate_leaf)
+		_bpt_iterate_seek(handler, data);
+
+	_bpt_iterate_step(handler);
+
+	return data;
+}
+
+static void _bpt_rewind(struct bpt_handler *handler, int to) {
+	struct bpt_leaf *leaf = handler->root ? _bpt_edge(handler, to) : NULL;
+
+	handler->_iterate_reverse = to;
+	handler->_iterate_hi = NULL;
+
+	_bpt_iterate_at(handler, leaf, (to && leaf) ? (leaf->node.count - 1) : 0);
+
+	handler->_stat.rewind ++;
+}
+
+static void _bpt_range(struct bpt_handler *handler, void *lo, void *hi) {
+	struct bpt_leaf *leaf = NULL;
+	ui32_t pos = 0;
+
+	handler->_iterate_reverse = 0;
+	handler->_iterate_hi = hi;
+
+	if (lo) {
+		leaf = _bpt_lower(handler, lo, NULL, &pos);
+	} else if (handler->root) {
+		leaf = _bpt_edge(handler, 0);
+	}
+
+	_bpt_iterate_at(handler, leaf, pos);
+
+	handler->_stat.range ++;
+}
+
+static ui32_t _bpt_set_config(struct bpt_handler *handler, ui32_t flags) {
+	ui32_t old_flags = handler->_config_flags;
+
+	handler->_config_flags = flags;
+
+	handler->_stat.set_config ++;
+
+	return old_flags;
+}
+
+static ui32_t _bpt_get_config(struct bpt_handler *handler) {
+	handler->_stat.get_config ++;
+
+	return handler->_config_flags;
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct bpt_handler *pall_bpt_init_mm(
+		int (*compare) (const void *d1, const void *d2),
+		void (*destroy) (void *data),
+		int (*ser_data) (pall_fd_t fd, void *data),
+		void *(*unser_data) (pall_fd_t fd),
+		const struct pall_mm *mm)
+{
+	struct bpt_handler *handler = NULL;
+	struct pall_mm hmm;
+
+	if (!compare || !destroy || (mm && (!mm->alloc || !mm->free))) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	mm_copy(&hmm, mm);
+
+	if (!(handler = (struct bpt_handler *) mm_alloc_with(&hmm, sizeof(struct bpt_handler))))
+		return NULL;
+
+	memset(handler, 0, sizeof(struct bpt_handler));
+
+	memcpy(&handler->_mm, &hmm, sizeof(struct pall_mm));
+
+	handler->_config_flags = CONFIG_MM_POOL;
+
+	handler->compare = compare;
+	handler->destroy = destroy;
+	handler->ser_data = ser_data;
+	handler->unser_data = unser_data;
+
+	handler->insert = &_bpt_insert;
+	handler->del = &_bpt_delete;
+	handler->search = &_bpt_search;
+	handler->lower_bound = &_bpt_lower_bound;
+	handler->upper_bound = &_bpt_upper_bound;
+	handler->serialize = &_bpt_serialize;
+	handler->unserialize = &_bpt_unserialize;
+	handler->stat = &_bpt_stat;
+	handler->stat_reset = &_bpt_stat_reset;
+	handler->count = &_bpt_count;
+	handler->collapse = &_bpt_collapse;
+	handler->iterate = &_bpt_iterate;
+	handler->rewind = &_bpt_rewind;
+	handler->range = &_bpt_range;
+	handler->set_config = &_bpt_set_config;
+	handler->get_config = &_bpt_get_config;
+
+	return handler;
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct bpt_handler *pall_bpt_init(
+		int (*compare) (const void *d1, const void *d2),
+		void (*destroy) (void *data),
+		int (*ser_data) (pall_fd_t fd, void *data),
+		void *(*unser_data) (pall_fd_t fd))
+{
+	return pall_bpt_init_mm(compare, destroy, ser_data, unser_data, NULL);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_bpt_destroy(struct bpt_handler *h) {
+	struct pall_mm hmm;
+
+	h->collapse(h);
+
+	memcpy(&hmm, &h->_mm, sizeof(struct pall_mm));
+
+	mm_free_with(&hmm, h);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_bpt_insert(struct bpt_handler *h, void *data) {
+	return h->insert(h, data);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_bpt_delete(struct bpt_handler *h, void *data) {
+	return h->del(h, data);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_bpt_search(struct bpt_handler *h, void *data) {
+	return h->search(h, data);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_bpt_lower_bound(struct bpt_handler *h, void *data) {
+	return h->lower_bound(h, data);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_bpt_upper_bound(struct bpt_handler *h, void *data) {
+	return h->upper_bound(h, data);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_bpt_serialize(struct bpt_handler *h, pall_fd_t fd) {
+	return h->serialize(h, fd);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_bpt_unserialize(struct bpt_handler *h, pall_fd_t fd) {
+	return h->unserialize(h, fd);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct bpt_stat *pall_bpt_stat(struct bpt_handler *h) {
+	return h->stat(h);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_bpt_stat_reset(struct bpt_handler *h) {
+	h->stat_reset(h);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_bpt_count(struct bpt_handler *h) {
+	return h->count(h);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_bpt_collapse(struct bpt_handler *h) {
+	h->collapse(h);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_bpt_iterate(struct bpt_handler *h) {
+	return h->iterate(h);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_bpt_rewind(struct bpt_handler *h, int to) {
+	h->rewind(h, to);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_bpt_range(struct bpt_handler *h, void *lo, void *hi) {
+	h->range(h, lo, hi);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_bpt_set_config(struct bpt_handler *h, ui32_t flags) {
+	return h->set_config(h, flags);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_bpt_get_config(struct bpt_handler *h) {
+	return h->get_config(h);
+}
+
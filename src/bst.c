@@ -28,90 +28,60 @@
 #include <string.h>
 #include <stdlib.h>
 #include <errno.h>
-#include <search.h>
-#include <assert.h>
 
 #include "config.h"
 #include "mm.h"
 #include "pall.h"
+#include "avl.h"
 #include "bst.h"
-#include "fifo.h"
-#include "lifo.h"
 
-static void _bst_action_rewind_forward(
-		const void *nodep,
-		const VISIT which,
-		const int depth)
-{
-	const struct bst_node *n = *(const struct bst_node **) nodep;
+static struct bst_node *_bst_node_alloc(struct bst_handler *handler) {
+	/* The pool is only created on an empty tree, so that all the nodes of a
+	 * pooled tree are always owned by the pool.
+	 */
+	if (!handler->_pool.size && (handler->_config_flags & (CONFIG_MM_POOL | CONFIG_MM_ARENA)) && !handler->_count)
+		mm_pool_init(&handler->_pool, &handler->_mm, sizeof(struct bst_node), BST_MM_POOL_NMEMB_MIN, BST_MM_POOL_NMEMB_MAX);
 
-	switch (which) {
-		case preorder: break;
-		case endorder: break;
-		case postorder:
-		case leaf: assert(!n->h->_iterate_forward->push(n->h->_iterate_forward, n->data)); break;
-	}
-}
+	if (handler->_pool.size)
+		return (struct bst_node *) mm_pool_alloc(&handler->_pool);
 
-static void _bst_action_rewind_backward(
-		const void *nodep,
-		const VISIT which,
-		const int depth)
-{
-	const struct bst_node *n = *(const struct bst_node **) nodep;
+	return (struct bst_node *) mm_alloc_with(&handler->_mm, sizeof(struct bst_node));
+}
 
-	switch (which) {
-		case preorder: break;
-		case endorder: break;
-		case postorder:
-		case leaf: assert(!n->h->_iterate_backward->push(n->h->_iterate_backward, n->data)); break;
+static void _bst_node_free(struct bst_handler *handler, struct bst_node *node) {
+	if (handler->_pool.size) {
+		mm_pool_free(&handler->_pool, node);
+	} else {
+		mm_free_with(&handler->_mm, node);
 	}
 }
 
-static void _bst_action_serialize(
-		const void *nodep,
-		const VISIT which,
-		const int depth)
-{
-	const struct bst_node *n = *(const struct bst_node **) nodep;
+static void _bst_node_release(struct avl_node *node, void *arg) {
+	struct bst_handler *handler = (struct bst_handler *) arg;
 
-	if (n->h->_ser_ret)
-		return;
+	if (!(handler->_config_flags & CONFIG_MM_ARENA) || !handler->_pool.size)
+		handler->destroy(((struct bst_node *) node)->data);
 
-	switch (which) {
-		case preorder: break;
-		case endorder: break;
-		case postorder:
-		case leaf: n->h->_ser_ret = n->h->ser_data(n->h->_ser_cur_fd, n->data); break;
-	}
+	/* Pooled nodes are released all at once, along with the pool */
+	if (!handler->_pool.size)
+		mm_free_with(&handler->_mm, node);
 }
 
-static int _bst_compare(const void *d1, const void *d2) {
-	const struct bst_node *b1 = (const struct bst_node *) d1;
-	const struct bst_node *b2 = (const struct bst_node *) d2;
-
-	return b1->h->compare(b1->data, b2->data);
+static int _bst_compare(const void *key, const struct avl_node *node, void *arg) {
+	return ((struct bst_handler *) arg)->compare(key, ((const struct bst_node *) node)->data);
 }
 
 static int _bst_insert(struct bst_handler *handler, void *data) {
 	struct bst_node *n = NULL;
-	void *val = NULL;
 
-	if (!(n = (struct bst_node *) mm_alloc(sizeof(struct bst_node)))) {
+	if (!(n = _bst_node_alloc(handler))) {
 		handler->_stat.insert_err ++;
 		return -1;
 	}
 
 	n->data = data;
-	n->h = handler;
 
-	if (!(val = tsearch(n, &handler->root, &_bst_compare))) {
-		handler->_stat.insert_err ++;
-		mm_free(n);
-		return -1;
-	} else if (*(struct bst_node **) val != n) {
-		mm_free(n);
-	}
+	avl_insert(&handler->root, &n->node, data, &_bst_compare, handler);
 
 	handler->_stat.insert ++;
 	handler->_count ++;
@@ -123,50 +93,99 @@ static int _bst_insert(struct bst_handler *handler, void *data) {
 }
 
 static int _bst_delete(struct bst_handler *handler, void *data) {
-	struct bst_node n, *d = NULL;
-	void *val;
-
-	n.data = data;
-	n.h = handler;
+	struct avl_node *node = NULL;
 
-	if (!(val = tfind(&n, &handler->root, &_bst_compare))) {
+	if (!(node = avl_find(handler->root, data, &_bst_compare, handler))) {
 		handler->_stat.del_nf ++;
 		return -1;
 	}
 
-	d = *(struct bst_node **) val;
+	/* Keep any ongoing iteration consistent */
+	if (node == handler->_iterate_cur)
+		handler->_iterate_cur = handler->_iterate_reverse ? avl_prev(node) : avl_next(node);
 
-	if (!tdelete(&n, &handler->root, &_bst_compare)) {
-		handler->_stat.del_nf ++;
-		return -1;
-	}
+	avl_remove(&handler->root, node);
 
-	handler->destroy(d->data);
-	mm_free(d);
+	handler->destroy(((struct bst_node *) node)->data);
+	_bst_node_free(handler, (struct bst_node *) node);
 
 	handler->_stat.del ++;
-
-	if (!-- handler->_count)
-		handler->root = NULL;
+	handler->_count --;
 
 	return 0;
 }
 
 static void *_bst_search(struct bst_handler *handler, void *data) {
-	struct bst_node n;
-	void *val;
+	struct avl_node *node = NULL;
+
+	if (!(node = avl_find(handler->root, data, &_bst_compare, handler))) {
+		handler->_stat.search_nf ++;
+		return NULL;
+	}
+
+	handler->_stat.search ++;
+
+	return ((struct bst_node *) node)->data;
+}
+
+static void *_bst_lower_bound(struct bst_handler *handler, void *data) {
+	struct avl_node *node = NULL;
+
+	if (!(node = avl_lower_bound(handler->root, data, &_bst_compare, handler))) {
+		handler->_stat.search_nf ++;
+		return NULL;
+	}
+
+	handler->_stat.search ++;
+
+	return ((struct bst_node *) node)->data;
+}
+
+static void *_bst_upper_bound(struct bst_handler *handler, void *data) {
+	struct avl_node *node = NULL;
+
+	if (!(node = avl_upper_bound(handler->root, data, &_bst_compare, handler))) {
+		handler->_stat.search_nf ++;
+		return NULL;
+	}
 
-	n.data = data;
-	n.h = handler;
+	handler->_stat.search ++;
+
+	return ((struct bst_node *) node)->data;
+}
 
-	if (!(val = tfind(&n, &handler->root, &_bst_compare))) {
+static void *_bst_select(struct bst_handler *handler, ui32_t k) {
+	struct avl_node *node = NULL;
+
+	if (!(node = avl_select(handler->root, k))) {
 		handler->_stat.search_nf ++;
 		return NULL;
 	}
 
 	handler->_stat.search ++;
 
-	return (*(struct bst_node **) val)->data;
+	return ((struct bst_node *) node)->data;
+}
+
+static ui32_t _bst_rank(struct bst_handler *handler, void *data) {
+	handler->_stat.count ++;
+
+	return avl_count_lower(handler->root, data, &_bst_compare, handler);
+}
+
+static ui32_t _bst_count_range(struct bst_handler *handler, void *lo, void *hi) {
+	ui32_t below_lo = 0, below_hi = handler->_count;
+
+	handler->_stat.count ++;
+
+	if (lo)
+		below_lo = avl_count_lower(handler->root, lo, &_bst_compare, handler);
+
+	if (hi)
+		below_hi = avl_count_lower(handler->root, hi, &_bst_compare, handler);
+
+	/* Inverted bounds make an empty range */
+	return (below_hi > below_lo) ? (below_hi - below_lo) : 0;
 }
 
 static ui32_t _bst_count(struct bst_handler *handler) {
@@ -177,8 +196,8 @@ static ui32_t _bst_count(struct bst_handler *handler) {
 
 static int _bst_serialize(struct bst_handler *handler, pall_fd_t fd) {
 	ui32_t count_nbo = pall_htonl(handler->_count);
-	handler->_ser_cur_fd = fd;
-	handler->_ser_ret = 0;
+	struct avl_node *node = NULL;
+	int ret = 0;
 
 	if (!handler->ser_data) {
 		handler->_stat.serialize_err ++;
@@ -191,19 +210,15 @@ static int _bst_serialize(struct bst_handler *handler, pall_fd_t fd) {
 		return -1;
 	}
 
-	if (!handler->root) {
-		handler->_stat.serialize ++;
-		return 0;
-	}
-
-	twalk(handler->root, &_bst_action_serialize);
+	for (node = avl_first(handler->root); node && !ret; node = avl_next(node))
+		ret = handler->ser_data(fd, ((struct bst_node *) node)->data);
 
-	if (handler->_ser_ret)
+	if (ret)
 		handler->_stat.serialize_err ++;
 	else
 		handler->_stat.serialize ++;
 
-	return handler->_ser_ret;
+	return ret;
 }
 
 static int _bst_unserialize(struct bst_handler *handler, pall_fd_t fd) {
@@ -250,78 +265,112 @@ static void _bst_stat_reset(struct bst_handler *handler) {
 }
 
 static void _bst_collapse(struct bst_handler *handler) {
-#ifdef _GNU_SOURCE
-	tdestroy(handler->root, handler->destroy);
-#else
-	void *d = NULL;
-
-	for (handler->rewind(handler, 0); (d = handler->iterate(handler)); ) {
-		handler->del(handler, d);
-		handler->_stat.del --;
-	}
-#endif
+	/* Arenas own both the nodes and the elements, so there's nothing to be
+	 * released per node.
+	 */
+	if (!(handler->_config_flags & CONFIG_MM_ARENA) || !handler->_pool.size)
+		avl_destroy(&handler->root, &_bst_node_release, handler);
+
+	if (handler->_pool.size)
+		mm_pool_release(&handler->_pool);
 
 	handler->_stat.collapse ++;
 	handler->_count = 0;
 	handler->root = NULL;
+	handler->_iterate_cur = NULL;
 }
 
 static void *_bst_iterate(struct bst_handler *handler) {
-	void *data = handler->_iterate_reverse ? handler->_iterate_backward->pop(handler->_iterate_backward) : handler->_iterate_forward->pop(handler->_iterate_forward);
+	struct avl_node *node = handler->_iterate_cur;
 
-	if (!data)
+	/* Ranges end at the first element not lower than their upper bound */
+	if (node && handler->_iterate_hi && (handler->compare(handler->_iterate_hi, ((struct bst_node *) node)->data) <= 0))
+		node = handler->_iterate_cur = NULL;
+
+	if (!node) {
 		handler->_stat.iterate ++;
+		return NULL;
+	}
+
+	handler->_iterate_cur = handler->_iterate_reverse ? avl_prev(node) : avl_next(node);
 
-	return data;
+	return ((struct bst_node *) node)->data;
 }
 
 static void _bst_rewind(struct bst_handler *handler, int to) {
 	handler->_iterate_reverse = to;
+	handler->_iterate_hi = NULL;
+	handler->_iterate_cur = to ? avl_last(handler->root) : avl_first(handler->root);
 
-	while (handler->_iterate_forward->pop(handler->_iterate_forward)) ;
-	while (handler->_iterate_backward->pop(handler->_iterate_backward)) ;
+	handler->_stat.rewind ++;
+}
 
-	twalk(handler->root, to ? &_bst_action_rewind_backward : &_bst_action_rewind_forward);
+static void _bst_range(struct bst_handler *handler, void *lo, void *hi) {
+	handler->_iterate_reverse = 0;
+	handler->_iterate_hi = hi;
+	handler->_iterate_cur = lo ? avl_lower_bound(handler->root, lo, &_bst_compare, handler) : avl_first(handler->root);
 
-	handler->_stat.rewind ++;
+	handler->_stat.range ++;
+}
+
+static ui32_t _bst_set_config(struct bst_handler *handler, ui32_t flags) {
+	ui32_t old_flags = handler->_config_flags;
+
+	handler->_config_flags = flags;
+
+	handler->_stat.set_config ++;
+
+	return old_flags;
+}
+
+static ui32_t _bst_get_config(struct bst_handler *handler) {
+	handler->_stat.get_config ++;
+
+	return handler->_config_flags;
+}
+
+static void *_bst_arena_alloc(struct bst_handler *handler, size_t size) {
+	if (!handler->_pool.size) {
+		/* Nodes of non-empty trees may not be owned by a pool */
+		if (handler->_count) {
+			errno = EBUSY;
+			return NULL;
+		}
+
+		mm_pool_init(&handler->_pool, &handler->_mm, sizeof(struct bst_node), BST_MM_POOL_NMEMB_MIN, BST_MM_POOL_NMEMB_MAX);
+	}
+
+	return mm_pool_alloc_size(&handler->_pool, size);
 }
 
 #ifdef COMPILE_WIN32
 DLLIMPORT
 #endif
-struct bst_handler *pall_bst_init(
+struct bst_handler *pall_bst_init_mm(
 		int (*compare) (const void *d1, const void *d2),
 		void (*destroy) (void *data),
 		int (*ser_data) (pall_fd_t fd, void *data),
-		void *(*unser_data) (pall_fd_t fd))
+		void *(*unser_data) (pall_fd_t fd),
+		const struct pall_mm *mm)
 {
-	int errsv = 0;
 	struct bst_handler *handler = NULL;
+	struct pall_mm hmm;
 
-	if (!destroy) {
+	if (!destroy || (mm && (!mm->alloc || !mm->free))) {
 		errno = EINVAL;
 		return NULL;
 	}
 
-	if (!(handler = (struct bst_handler *) mm_alloc(sizeof(struct bst_handler))))
+	mm_copy(&hmm, mm);
+
+	if (!(handler = (struct bst_handler *) mm_alloc_with(&hmm, sizeof(struct bst_handler))))
 		return NULL;
 
 	memset(handler, 0, sizeof(struct bst_handler));
 
-	if (!(handler->_iterate_forward = pall_fifo_init(destroy, NULL, NULL))) {
-		errsv = errno;
-		mm_free(handler);
-		errno = errsv;
-		return NULL;
-	}
+	memcpy(&handler->_mm, &hmm, sizeof(struct pall_mm));
 
-	if (!(handler->_iterate_backward = pall_lifo_init(destroy, NULL, NULL))) {
-		errsv = errno;
-		pall_fifo_destroy(handler->_iterate_forward);
-		mm_free(handler);
-		errno = errsv;
-		return NULL;
-	}
+	handler->_config_flags = CONFIG_MM_POOL;
 
 	handler->compare = compare;
 	handler->destroy = destroy;
@@ -331,6 +380,11 @@ struct bst_handler *pall_bst_init(
 	handler->insert = &_bst_insert;
 	handler->del = &_bst_delete;
 	handler->search = &_bst_search;
+	handler->lower_bound = &_bst_lower_bound;
+	handler->upper_bound = &_bst_upper_bound;
+	handler->select = &_bst_select;
+	handler->rank = &_bst_rank;
+	handler->count_range = &_bst_count_range;
 	handler->serialize = &_bst_serialize;
 	handler->unserialize = &_bst_unserialize;
 	handler->stat = &_bst_stat;
@@ -339,22 +393,37 @@ struct bst_handler *pall_bst_init(
 	handler->collapse = &_bst_collapse;
 	handler->iterate = &_bst_iterate;
 	handler->rewind = &_bst_rewind;
+	handler->range = &_bst_range;
+	handler->set_config = &_bst_set_config;
+	handler->get_config = &_bst_get_config;
+	handler->arena_alloc = &_bst_arena_alloc;
 
 	return handler;
 }
 
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct bst_handler *pall_bst_init(
+		int (*compare) (const void *d1, const void *d2),
+		void (*destroy) (void *data),
+		int (*ser_data) (pall_fd_t fd, void *data),
+		void *(*unser_data) (pall_fd_t fd))
+{
+	return pall_bst_init_mm(compare, destroy, ser_data, unser_data, NULL);
+}
+
 #ifdef COMPILE_WIN32
 DLLIMPORT
 #endif
 void pall_bst_destroy(struct bst_handler *h) {
+	struct pall_mm hmm;
+
 	h->collapse(h);
 
-	while (h->_iterate_forward->pop(h->_iterate_forward)) ;
-	while (h->_iterate_backward->pop(h->_iterate_backward)) ;
-	pall_fifo_destroy(h->_iterate_forward);
-	pall_lifo_destroy(h->_iterate_backward);
+	memcpy(&hmm, &h->_mm, sizeof(struct pall_mm));
 
-	mm_free(h);
+	mm_free_with(&hmm, h);
 }
 
 #ifdef COMPILE_WIN32
@@ -378,6 +447,41 @@ void *pall_bst_search(struct bst_handler *h, void *data) {
 	return h->search(h, data);
 }
 
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_bst_lower_bound(struct bst_handler *h, void *data) {
+	return h->lower_bound(h, data);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_bst_upper_bound(struct bst_handler *h, void *data) {
+	return h->upper_bound(h, data);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_bst_select(struct bst_handler *h, ui32_t k) {
+	return h->select(h, k);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_bst_rank(struct bst_handler *h, void *data) {
+	return h->rank(h, data);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_bst_count_range(struct bst_handler *h, void *lo, void *hi) {
+	return h->count_range(h, lo, hi);
+}
+
 #ifdef COMPILE_WIN32
 DLLIMPORT
 #endif
@@ -434,3 +538,31 @@ void pall_bst_rewind(struct bst_handler *h, int to) {
 	h->rewind(h, to);
 }
 
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_bst_range(struct bst_handler *h, void *lo, void *hi) {
+	h->range(h, lo, hi);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_bst_set_config(struct bst_handler *h, ui32_t flags) {
+	return h->set_config(h, flags);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_bst_get_config(struct bst_handler *h) {
+	return h->get_config(h);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_bst_arena_alloc(struct bst_handler *h, size_t size) {
+	return h->arena_alloc(h, size);
+}
+
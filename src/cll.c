@@ -34,6 +34,101 @@
 #include "pall.h"
 #include "cll.h"
 
+static void _cll_pool_prepare(struct cll_handler *handler) {
+	/* The pool is only created on an empty list, so that all the elements
+	 * of a pooled list are always owned by the pool.
+	 */
+	if (!handler->_pool.size && (handler->_config_flags & (CONFIG_MM_POOL | CONFIG_MM_ARENA)) && !handler->_count)
+		mm_pool_init(&handler->_pool, &handler->_mm, sizeof(struct cll_elem), CLL_MM_POOL_NMEMB_MIN, CLL_MM_POOL_NMEMB_MAX);
+}
+
+static struct cll_elem *_cll_elem_alloc(struct cll_handler *handler, void *data) {
+	/* Intrusive lists use the link embedded in the element itself */
+	if (handler->_intrusive)
+		return (struct cll_elem *) (((char *) data) + handler->_link_offset);
+
+	_cll_pool_prepare(handler);
+
+	if (handler->_pool.size)
+		return (struct cll_elem *) mm_pool_alloc(&handler->_pool);
+
+	return (struct cll_elem *) mm_alloc_with(&handler->_mm, sizeof(struct cll_elem));
+}
+
+static void _cll_elem_free(struct cll_handler *handler, struct cll_elem *elem) {
+	if (handler->_intrusive)
+		return;
+
+	if (handler->_pool.size) {
+		mm_pool_free(&handler->_pool, elem);
+	} else {
+		mm_free_with(&handler->_mm, elem);
+	}
+}
+
+/* Builds a linear chain holding 'data', in reverse order if 'reverse' is set,
+ * returning its first node and storing its last node on 'last'. Either all
+ * the nodes are allocated, or none is.
+ */
+static struct cll_elem *_cll_chain_alloc(
+		struct cll_handler *handler,
+		void **data,
+		ui32_t count,
+		int reverse,
+		struct cll_elem **last)
+{
+	struct cll_elem *block = NULL, *first = NULL, *prev = NULL, *n = NULL;
+	void *d = NULL;
+	ui32_t i = 0;
+
+	if (!handler->_intrusive) {
+		_cll_pool_prepare(handler);
+
+		/* Pooled nodes are carved from a single contiguous run */
+		if (handler->_pool.size && !(block = (struct cll_elem *) mm_pool_alloc_block(&handler->_pool, count)))
+			return NULL;
+	}
+
+	for (i = 0; i < count; i ++) {
+		d = data[reverse ? (count - 1 - i) : i];
+
+		if (handler->_intrusive) {
+			n = (struct cll_elem *) (((char *) d) + handler->_link_offset);
+		} else if (block) {
+			n = (struct cll_elem *) (((char *) block) + (i * handler->_pool.size));
+		} else if (!(n = (struct cll_elem *) mm_alloc_with(&handler->_mm, sizeof(struct cll_elem)))) {
+			for (; first; first = n) {
+				n = (first == prev) ? NULL : first->next;
+				mm_free_with(&handler->_mm, first);
+			}
+
+			return NULL;
+		}
+
+		n->data = d;
+		n->prev = prev;
+
+		if (prev) {
+			prev->next = n;
+		} else {
+			first = n;
+		}
+
+		prev = n;
+	}
+
+	*last = prev;
+
+	return first;
+}
+
+static void _cll_splice_before(struct cll_elem *pos, struct cll_elem *first, struct cll_elem *last) {
+	first->prev = pos->prev;
+	last->next = pos;
+	pos->prev->next = first;
+	pos->prev = last;
+}
+
 static void _cll_move_to_head(
 		struct cll_handler *handler,
 		struct cll_elem *elem)
@@ -56,7 +151,7 @@ static void _cll_move_to_head(
 static int _cll_insert_head(struct cll_handler *handler, void *data) {
 	struct cll_elem *n = NULL;
 
-	if (!(n = (struct cll_elem *) mm_alloc(sizeof(struct cll_elem)))) {
+	if (!(n = _cll_elem_alloc(handler, data))) {
 		handler->_stat.insert_err ++;
 		return -1;
 	}
@@ -97,7 +192,7 @@ static int _cll_insert_tail(struct cll_handler *handler, void *data) {
 static int _cll_insert_sorted(struct cll_handler *handler, void *data) {
 	struct cll_elem *pool = handler->cll, *n = NULL;
 
-	if (!(n = (struct cll_elem *) mm_alloc(sizeof(struct cll_elem)))) {
+	if (!(n = _cll_elem_alloc(handler, data))) {
 		handler->_stat.insert_err ++;
 		return -1;
 	}
@@ -147,7 +242,7 @@ static int _cll_insert_sorted(struct cll_handler *handler, void *data) {
 static int _cll_insert(struct cll_handler *handler, void *data) {
 	struct cll_elem *pool = handler->cll, *n = NULL;
 
-	if (!(n = (struct cll_elem *) mm_alloc(sizeof(struct cll_elem)))) {
+	if (!(n = _cll_elem_alloc(handler, data))) {
 		handler->_stat.insert_err ++;
 		return -1;
 	}
@@ -185,9 +280,127 @@ static int _cll_insert(struct cll_handler *handler, void *data) {
 	return 0;
 }
 
-static void *_cll_unlink(struct cll_handler *handler, void *data) {
-	struct cll_elem *pool = handler->cll, *start = pool, *ptr = NULL;
-	void *elem_data = NULL;
+static int _cll_insert_batch(struct cll_handler *handler, void **data, ui32_t count) {
+	struct cll_elem *first = NULL, *last = NULL;
+	int head = (handler->insert == &_cll_insert_head);
+	int tail = (handler->insert == &_cll_insert_tail);
+	int next = !head && !tail && (handler->_config_flags & CONFIG_INSERT_NEXT);
+	ui32_t i = 0;
+
+	if (!count)
+		return 0;
+
+	/* Sorted insertions need a search per element */
+	if (handler->insert == &_cll_insert_sorted) {
+		for (i = 0; i < count; i ++) {
+			if (_cll_insert_sorted(handler, data[i]) < 0)
+				return -1;
+		}
+
+		return 0;
+	}
+
+	/* The chain is built in the order that 'count' single insertions would
+	 * leave the elements in, and then spliced at once.
+	 */
+	if (!(first = _cll_chain_alloc(handler, data, count, !tail && !next, &last))) {
+		handler->_stat.insert_err += count;
+		return -1;
+	}
+
+	if (!handler->cll) {
+		first->prev = last;
+		last->next = first;
+
+		handler->cll_head = (head || tail || next) ? first : last;
+		handler->cll = (head || next) ? last : first;
+	} else if (head || tail) {
+		_cll_splice_before(handler->cll_head, first, last);
+
+		if (head)
+			handler->cll_head = first;
+	} else if (next) {
+		_cll_splice_before(handler->cll->next, first, last);
+		handler->cll = last;
+	} else {
+		_cll_splice_before(handler->cll, first, last);
+		handler->cll = first;
+	}
+
+	handler->_stat.insert += count;
+	handler->_count += count;
+
+	if (handler->_stat.elem_count_max < handler->_count)
+		handler->_stat.elem_count_max = handler->_count;
+
+	return 0;
+}
+
+static void *_cll_key_self(void *data) {
+	return data;
+}
+
+/* Compares 'data' against the element 'elem'. If 'keyed' is set, 'data' is a
+ * key and it is compared against the key of 'elem' instead.
+ */
+static int _cll_match(struct cll_handler *handler, int keyed, void *data, void *elem) {
+	if (keyed)
+		return handler->key_compare(data, handler->key(elem));
+
+	return handler->compare(data, elem);
+}
+
+static int _cll_insert_handle(struct cll_handler *handler, void *data, struct cll_elem **handle) {
+	if (handler->insert(handler, data) < 0)
+		return -1;
+
+	/* Locate the node just linked by the configured insertion function */
+	if (handler->insert == &_cll_insert_head) {
+		*handle = handler->cll_head;
+	} else if (handler->insert == &_cll_insert_tail) {
+		*handle = handler->cll_head->prev;
+	} else {
+		*handle = handler->cll;
+	}
+
+	return 0;
+}
+
+/* Unlinks and releases the node 'elem', returning the element it held */
+static void *_cll_unlink_elem(struct cll_handler *handler, struct cll_elem *elem) {
+	void *data = elem->data;
+
+	if (elem == elem->next) {
+		handler->cll = NULL;
+		handler->cll_head = NULL;
+		handler->_iterate_cur = NULL;
+		handler->_iterate_start = NULL;
+	} else {
+		elem->prev->next = elem->next;
+		elem->next->prev = elem->prev;
+
+		if (handler->cll == elem)
+			handler->cll = elem->next;
+
+		if (handler->cll_head == elem)
+			handler->cll_head = elem->next;
+
+		if (elem == handler->_iterate_cur)
+			handler->_iterate_cur = elem->next;
+
+		if (elem == handler->_iterate_start)
+			handler->_iterate_start = elem->next;
+	}
+
+	_cll_elem_free(handler, elem);
+
+	handler->_count --;
+
+	return data;
+}
+
+static void *_cll_unlink(struct cll_handler *handler, void *data, int keyed) {
+	struct cll_elem *pool = handler->cll, *start = pool;
 
 	if (!pool)
 		return NULL;
@@ -195,7 +408,7 @@ static void *_cll_unlink(struct cll_handler *handler, void *data) {
 	if (handler->_config_flags & CONFIG_SEARCH_LRU) {
 		start = pool = handler->cll_head;
 	} else if (handler->_config_flags & CONFIG_SEARCH_AUTO) {
-		if (handler->compare(pool->data, data) > 0) {
+		if (_cll_match(handler, keyed, data, pool->data) < 0) {
 			handler->_config_flags |= CONFIG_SEARCH_BACKWARD;
 		} else {
 			handler->_config_flags &= ~CONFIG_SEARCH_BACKWARD;
@@ -203,40 +416,11 @@ static void *_cll_unlink(struct cll_handler *handler, void *data) {
 	}
 
 	for (;;) {
-		if (!handler->compare(data, pool->data)) {
-			if (pool == pool->next) {
-				elem_data = pool->data;
-				mm_free(pool);
-				handler->cll = NULL;
-				handler->cll_head = NULL;
-				handler->_iterate_cur = NULL;
-				handler->_iterate_start = NULL;
-
-				break;
-			}
-
-			if (handler->cll_head == pool)
-				handler->cll_head = pool->next;
-
-			ptr = pool;
-			pool->prev->next = pool->next;
-			pool->next->prev = pool->prev;
-			handler->cll = pool->next;
-
-			if (handler->cll_head == pool)
-				handler->cll_head = pool->next;
-
-			if (ptr == handler->_iterate_cur)
-				handler->_iterate_cur = ptr->next;
-
-			if (ptr == handler->_iterate_start)
-				handler->_iterate_start = ptr->next;
+		if (!_cll_match(handler, keyed, data, pool->data)) {
+			/* The current position moves past the removed element */
+			handler->cll = pool;
 
-			elem_data = ptr->data;
-
-			mm_free(ptr);
-
-			break;
+			return _cll_unlink_elem(handler, pool);
 		}
 
 		pool = (handler->_config_flags & CONFIG_SEARCH_BACKWARD) ? pool->prev : pool->next;
@@ -244,16 +428,12 @@ static void *_cll_unlink(struct cll_handler *handler, void *data) {
 		if (pool == start)
 			return NULL;
 	}
-
-	handler->_count --;
-
-	return elem_data;
 }
 
-static int _cll_delete(struct cll_handler *handler, void *data) {
+static int _cll_delete_match(struct cll_handler *handler, void *data, int keyed) {
 	void *d = NULL;
 
-	if ((d = _cll_unlink(handler, data))) {
+	if ((d = _cll_unlink(handler, data, keyed))) {
 		handler->destroy(d);
 		handler->_stat.del ++;
 		return 0;
@@ -264,11 +444,24 @@ static int _cll_delete(struct cll_handler *handler, void *data) {
 	return -1;
 }
 
+static int _cll_delete(struct cll_handler *handler, void *data) {
+	return _cll_delete_match(handler, data, 0);
+}
+
+static int _cll_delete_key(struct cll_handler *handler, void *key) {
+	return _cll_delete_match(handler, key, 1);
+}
+
+static void _cll_delete_handle(struct cll_handler *handler, struct cll_elem *handle) {
+	handler->destroy(_cll_unlink_elem(handler, handle));
+	handler->_stat.del ++;
+}
+
 static void *_cll_search_nop(struct cll_handler *handler, void *data) {
 	return NULL;
 }
 
-static void *_cll_search(struct cll_handler *handler, void *data) {
+static void *_cll_search_match(struct cll_handler *handler, void *data, int keyed) {
 	struct cll_elem *pool = handler->cll, *start = pool;
 
 	if (!pool) {
@@ -279,7 +472,7 @@ static void *_cll_search(struct cll_handler *handler, void *data) {
 	if (handler->_config_flags & CONFIG_SEARCH_LRU) {
 		start = pool = handler->cll_head;
 	} else if (handler->_config_flags & CONFIG_SEARCH_AUTO) {
-		if (handler->compare(pool->data, data) > 0) {
+		if (_cll_match(handler, keyed, data, pool->data) < 0) {
 			handler->_config_flags |= CONFIG_SEARCH_BACKWARD;
 		} else {
 			handler->_config_flags &= ~CONFIG_SEARCH_BACKWARD;
@@ -287,7 +480,7 @@ static void *_cll_search(struct cll_handler *handler, void *data) {
 	}
 
 	for (;;) {
-		if (!handler->compare(data, pool->data)) {
+		if (!_cll_match(handler, keyed, data, pool->data)) {
 			if (handler->_config_flags & CONFIG_SEARCH_LRU) {
 				_cll_move_to_head(handler, pool);
 			} else {
@@ -310,6 +503,14 @@ static void *_cll_search(struct cll_handler *handler, void *data) {
 	return NULL;
 }
 
+static void *_cll_search(struct cll_handler *handler, void *data) {
+	return _cll_search_match(handler, data, 0);
+}
+
+static void *_cll_search_key(struct cll_handler *handler, void *key) {
+	return _cll_search_match(handler, key, 1);
+}
+
 static ui32_t _cll_count(struct cll_handler *handler) {
 	handler->_stat.count ++;
 
@@ -396,10 +597,10 @@ static void _cll_stat_reset(struct cll_handler *handler) {
 	memset(&handler->_stat, 0, sizeof(struct cll_stat));
 }
 
-static void *_cll_pope(struct cll_handler *handler, void *data) {
+static void *_cll_pope_match(struct cll_handler *handler, void *data, int keyed) {
 	void *d = NULL;
 
-	if ((d = _cll_unlink(handler, data))) {
+	if ((d = _cll_unlink(handler, data, keyed))) {
 		handler->_stat.pope ++;
 		return d;
 	}
@@ -409,6 +610,24 @@ static void *_cll_pope(struct cll_handler *handler, void *data) {
 	return NULL;
 }
 
+static void *_cll_pope(struct cll_handler *handler, void *data) {
+	return _cll_pope_match(handler, data, 0);
+}
+
+static void *_cll_pope_key(struct cll_handler *handler, void *key) {
+	return _cll_pope_match(handler, key, 1);
+}
+
+static void *_cll_pope_handle(struct cll_handler *handler, struct cll_elem *handle) {
+	handler->_stat.pope ++;
+
+	return _cll_unlink_elem(handler, handle);
+}
+
+static void _cll_move_to_head_handle(struct cll_handler *handler, struct cll_elem *handle) {
+	_cll_move_to_head(handler, handle);
+}
+
 static void *_cll_poph(struct cll_handler *handler) {
 	struct cll_elem *ptr = NULL;
 	void *pop_data = NULL;
@@ -420,7 +639,7 @@ static void *_cll_poph(struct cll_handler *handler) {
 
 	if (handler->cll_head == handler->cll_head->next) {
 		pop_data = handler->cll_head->data;
-		mm_free(handler->cll_head);
+		_cll_elem_free(handler, handler->cll_head);
 		handler->cll = NULL;
 		handler->cll_head = NULL;
 		handler->_iterate_cur = NULL;
@@ -439,7 +658,7 @@ static void *_cll_poph(struct cll_handler *handler) {
 			handler->_iterate_start = ptr->next;
 
 		pop_data = ptr->data;
-		mm_free(ptr);
+		_cll_elem_free(handler, ptr);
 	}
 
 	handler->_stat.poph ++;
@@ -451,10 +670,36 @@ static void *_cll_poph(struct cll_handler *handler) {
 static void _cll_collapse(struct cll_handler *handler) {
 	struct cll_elem *pool = handler->cll, *ptr = NULL;
 
+	if (handler->_pool.size || handler->_intrusive) {
+		/* Pooled elements are released all at once, along with the pool,
+		 * and intrusive elements are released by destroy() itself. Arenas
+		 * skip destroy(), as the elements are expected to live in the pool.
+		 * Lists populated before a pool was created always take the slow
+		 * path below.
+		 */
+		if (pool && !(handler->_config_flags & CONFIG_MM_ARENA)) {
+			pool->prev->next = NULL;
+
+			for (; pool; pool = ptr) {
+				ptr = pool->next;
+				handler->destroy(pool->data);
+			}
+		}
+
+		if (handler->_pool.size)
+			mm_pool_release(&handler->_pool);
+
+		handler->cll = NULL;
+		handler->cll_head = NULL;
+		handler->_iterate_start = NULL;
+		handler->_iterate_cur = NULL;
+		pool = NULL;
+	}
+
 	while (pool) {
 		if (pool == pool->next) {
 			handler->destroy(pool->data);
-			mm_free(pool);
+			mm_free_with(&handler->_mm, pool);
 			handler->cll = NULL;
 			handler->cll_head = NULL;
 			handler->_iterate_start = NULL;
@@ -471,13 +716,27 @@ static void _cll_collapse(struct cll_handler *handler) {
 		pool = pool->next;
 
 		handler->destroy(ptr->data);
-		mm_free(ptr);
+		mm_free_with(&handler->_mm, ptr);
 	}
 
 	handler->_stat.collapse ++;
 	handler->_count = 0;
 }
 
+static void *_cll_arena_alloc(struct cll_handler *handler, size_t size) {
+	if (!handler->_pool.size) {
+		/* Elements of non-empty lists may not be owned by a pool */
+		if (handler->_count && !handler->_intrusive) {
+			errno = EBUSY;
+			return NULL;
+		}
+
+		mm_pool_init(&handler->_pool, &handler->_mm, sizeof(struct cll_elem), CLL_MM_POOL_NMEMB_MIN, CLL_MM_POOL_NMEMB_MAX);
+	}
+
+	return mm_pool_alloc_size(&handler->_pool, size);
+}
+
 static void *_cll_iterate(struct cll_handler *handler) {
 	struct cll_elem *ptr = NULL;
 
@@ -545,47 +804,82 @@ static ui32_t _cll_get_config(struct cll_handler *handler) {
 	return handler->_config_flags;
 }
 
+static int _cll_set_key(
+		struct cll_handler *handler,
+		void *(*key) (void *data),
+		int (*key_compare) (const void *k1, const void *k2))
+{
+	if (!key != !key_compare) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* Without a key extractor, elements are their own keys */
+	handler->key = key ? key : &_cll_key_self;
+	handler->key_compare = key ? key_compare : handler->compare;
+
+	handler->search_key = handler->key_compare ? &_cll_search_key : &_cll_search_nop;
+
+	return 0;
+}
+
 #ifdef COMPILE_WIN32
 DLLIMPORT
 #endif
-struct cll_handler *pall_cll_init(
+struct cll_handler *pall_cll_init_mm(
 		int (*compare) (const void *src, const void *dst),
 		void (*destroy) (void *data),
 		int (*ser_data) (pall_fd_t fd, void *data),
-		void *(*unser_data) (pall_fd_t fd))
+		void *(*unser_data) (pall_fd_t fd),
+		const struct pall_mm *mm)
 {
 	struct cll_handler *handler = NULL;
+	struct pall_mm hmm;
 
-	if (!destroy) {
+	if (!destroy || (mm && (!mm->alloc || !mm->free))) {
 		errno = EINVAL;
 		return NULL;
 	}
 
-	if (!(handler = (struct cll_handler *) mm_alloc(sizeof(struct cll_handler))))
+	mm_copy(&hmm, mm);
+
+	if (!(handler = (struct cll_handler *) mm_alloc_with(&hmm, sizeof(struct cll_handler))))
 		return NULL;
 
 	memset(handler, 0, sizeof(struct cll_handler));
 
+	memcpy(&handler->_mm, &hmm, sizeof(struct pall_mm));
+
 	handler->cll = NULL;
 	handler->cll_head = NULL;
 	handler->_iterate_start = NULL;
 	handler->_iterate_cur = NULL;
-	handler->_config_flags = CONFIG_SEARCH_LRU | CONFIG_INSERT_HEAD;
+	handler->_config_flags = CONFIG_SEARCH_LRU | CONFIG_INSERT_HEAD | CONFIG_MM_POOL;
 
 	handler->compare = compare;
 	handler->destroy = destroy;
 	handler->ser_data = ser_data;
 	handler->unser_data = unser_data;
+	handler->key = &_cll_key_self;
+	handler->key_compare = compare;
 
 	handler->insert = &_cll_insert;
+	handler->insert_batch = &_cll_insert_batch;
+	handler->insert_handle = &_cll_insert_handle;
 	handler->del = &_cll_delete;
 	handler->search = compare ? &_cll_search : &_cll_search_nop;
+	handler->search_key = compare ? &_cll_search_key : &_cll_search_nop;
+	handler->del_key = &_cll_delete_key;
+	handler->del_handle = &_cll_delete_handle;
 	handler->serialize = &_cll_serialize;
 	handler->unserialize = &_cll_unserialize;
 	handler->stat = &_cll_stat;
 	handler->stat_reset = &_cll_stat_reset;
 	handler->count = &_cll_count;
 	handler->pope = &_cll_pope;
+	handler->pope_key = &_cll_pope_key;
+	handler->pope_handle = &_cll_pope_handle;
+	handler->move_to_head_handle = &_cll_move_to_head_handle;
 	handler->poph = &_cll_poph;
 	handler->collapse = &_cll_collapse;
 	handler->iterate = &_cll_iterate;
@@ -593,6 +887,42 @@ struct cll_handler *pall_cll_init(
 	handler->count = &_cll_count;
 	handler->set_config = &_cll_set_config;
 	handler->get_config = &_cll_get_config;
+	handler->arena_alloc = &_cll_arena_alloc;
+	handler->set_key = &_cll_set_key;
+
+	return handler;
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct cll_handler *pall_cll_init(
+		int (*compare) (const void *src, const void *dst),
+		void (*destroy) (void *data),
+		int (*ser_data) (pall_fd_t fd, void *data),
+		void *(*unser_data) (pall_fd_t fd))
+{
+	return pall_cll_init_mm(compare, destroy, ser_data, unser_data, NULL);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct cll_handler *pall_cll_init_intrusive(
+		int (*compare) (const void *src, const void *dst),
+		void (*destroy) (void *data),
+		int (*ser_data) (pall_fd_t fd, void *data),
+		void *(*unser_data) (pall_fd_t fd),
+		size_t link_offset,
+		const struct pall_mm *mm)
+{
+	struct cll_handler *handler = NULL;
+
+	if (!(handler = pall_cll_init_mm(compare, destroy, ser_data, unser_data, mm)))
+		return NULL;
+
+	handler->_intrusive = 1;
+	handler->_link_offset = link_offset;
 
 	return handler;
 }
@@ -601,9 +931,13 @@ struct cll_handler *pall_cll_init(
 DLLIMPORT
 #endif
 void pall_cll_destroy(struct cll_handler *h) {
+	struct pall_mm hmm;
+
 	h->collapse(h);
 
-	mm_free(h);
+	memcpy(&hmm, &h->_mm, sizeof(struct pall_mm));
+
+	mm_free_with(&hmm, h);
 }
 
 #ifdef COMPILE_WIN32
@@ -613,6 +947,20 @@ int pall_cll_insert(struct cll_handler *h, void *data) {
 	return h->insert(h, data);
 }
 
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_cll_insert_batch(struct cll_handler *h, void **data, ui32_t count) {
+	return h->insert_batch(h, data, count);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_cll_insert_handle(struct cll_handler *h, void *data, struct cll_elem **handle) {
+	return h->insert_handle(h, data, handle);
+}
+
 #ifdef COMPILE_WIN32
 DLLIMPORT
 #endif
@@ -620,6 +968,20 @@ int pall_cll_delete(struct cll_handler *h, void *data) {
 	return h->del(h, data);
 }
 
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_cll_delete_key(struct cll_handler *h, void *key) {
+	return h->del_key(h, key);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_cll_delete_handle(struct cll_handler *h, struct cll_elem *handle) {
+	h->del_handle(h, handle);
+}
+
 #ifdef COMPILE_WIN32
 DLLIMPORT
 #endif
@@ -627,6 +989,13 @@ void *pall_cll_search(struct cll_handler *h, void *data) {
 	return h->search(h, data);
 }
 
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_cll_search_key(struct cll_handler *h, void *key) {
+	return h->search_key(h, key);
+}
+
 #ifdef COMPILE_WIN32
 DLLIMPORT
 #endif
@@ -669,6 +1038,27 @@ void *pall_cll_pope(struct cll_handler *h, void *data) {
 	return h->pope(h, data);
 }
 
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_cll_pope_key(struct cll_handler *h, void *key) {
+	return h->pope_key(h, key);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_cll_pope_handle(struct cll_handler *h, struct cll_elem *handle) {
+	return h->pope_handle(h, handle);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_cll_move_to_head_handle(struct cll_handler *h, struct cll_elem *handle) {
+	h->move_to_head_handle(h, handle);
+}
+
 #ifdef COMPILE_WIN32
 DLLIMPORT
 #endif
@@ -711,3 +1101,21 @@ ui32_t pall_cll_get_config(struct cll_handler *h) {
 	return h->get_config(h);
 }
 
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_cll_arena_alloc(struct cll_handler *h, size_t size) {
+	return h->arena_alloc(h, size);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_cll_set_key(
+		struct cll_handler *h,
+		void *(*key) (void *data),
+		int (*key_compare) (const void *k1, const void *k2))
+{
+	return h->set_key(h, key, key_compare);
+}
+
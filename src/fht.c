@@ -0,0 +1,593 @@
+/**
+ * @file fht.c
+ * @brief Portable Abstracted Linked Lists Library (libpall)
+ *        Flat Hash Table interface
+ *
+ * Date: 16-10-2026
+ *
+ * Copyright 2026 Pedro A. Hortas (pah@ucodev.org)
+ *
+ * This file is part of libpall.
+ *
+ * libpall is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libpall is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libpall.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#include "config.h"
+#include "mm.h"
+#include "pall.h"
+#include "fht.h"
+#include "hash.h"
+
+/* Marks slots deleted while iterating. The hash of the deleted element is kept
+ * in the slot, so that tombstones can be shifted like regular elements.
+ */
+static char _fht_tombstone;
+
+#define FHT_TOMBSTONE	((void *) &_fht_tombstone)
+
+static int _fht_is_elem(const struct fht_slot *slot) {
+	return slot->data && (slot->data != FHT_TOMBSTONE);
+}
+
+static ui32_t _fht_hash(struct fht_handler *handler, void *data) {
+	return hash_fmix32(handler->hash(data));
+}
+
+static ui32_t _fht_lookup(struct fht_handler *handler, void *data) {
+	ui32_t hash = 0, mask = handler->arr_size - 1, i = 0;
+	struct fht_slot *slot = NULL;
+
+	if (!handler->compare)
+		return handler->arr_size;
+
+	hash = _fht_hash(handler, data);
+
+	/* The load factor guarantees that every probe sequence ends on an empty
+	 * slot.
+	 */
+	for (i = hash & mask; (slot = &handler->array[i])->data; i = (i + 1) & mask) {
+		if ((slot->hash == hash) && (slot->data != FHT_TOMBSTONE) && !handler->compare(data, slot->data))
+			return i;
+	}
+
+	return handler->arr_size;
+}
+
+static void _fht_place(struct fht_slot *array, ui32_t mask, const struct fht_slot *slot) {
+	ui32_t i = 0;
+
+	for (i = slot->hash & mask; array[i].data; i = (i + 1) & mask)
+		;
+
+	array[i] = *slot;
+}
+
+static void _fht_erase(struct fht_handler *handler, ui32_t i) {
+	ui32_t mask = handler->arr_size - 1, j = i, home = 0;
+
+	handler->array[i].data = NULL;
+
+	/* Backward shift: pull every following element of the cluster that may
+	 * live in the hole closer to its home slot, so that no tombstone is left.
+	 */
+	for (j = (j + 1) & mask; handler->array[j].data; j = (j + 1) & mask) {
+		home = handler->array[j].hash & mask;
+
+		if ((j > i) ? ((home <= i) || (home > j)) : ((home <= i) && (home > j))) {
+			handler->array[i] = handler->array[j];
+			handler->array[j].data = NULL;
+			i = j;
+		}
+	}
+}
+
+static void _fht_purge(struct fht_handler *handler) {
+	ui32_t i = 0;
+
+	if (!handler->_tombstones)
+		return;
+
+	for (i = 0; i < handler->arr_size; i ++) {
+		while (handler->array[i].data == FHT_TOMBSTONE)
+			_fht_erase(handler, i);
+	}
+
+	handler->_tombstones = 0;
+}
+
+static void *_fht_remove(struct fht_handler *handler, ui32_t i) {
+	void *data = handler->array[i].data;
+
+	/* Shifting elements would break ongoing iterations */
+	if (handler->_iterating) {
+		handler->array[i].data = FHT_TOMBSTONE;
+		handler->_tombstones ++;
+	} else {
+		_fht_erase(handler, i);
+	}
+
+	handler->_count --;
+
+	return data;
+}
+
+static int _fht_rehash(struct fht_handler *handler, ui32_t size) {
+	ui32_t i = 0;
+	struct fht_slot *array = NULL;
+
+	if (!(array = (struct fht_slot *) mm_calloc_with(&handler->_mm, size, sizeof(struct fht_slot))))
+		return -1;
+
+	/* Cached hashes are reused, so hash() isn't invoked again */
+	for (i = 0; i < handler->arr_size; i ++) {
+		if (_fht_is_elem(&handler->array[i]))
+			_fht_place(array, size - 1, &handler->array[i]);
+	}
+
+	mm_free_with(&handler->_mm, handler->array);
+
+	if (size > handler->arr_size)
+		handler->_stat.grow ++;
+
+	handler->array = array;
+	handler->arr_size = size;
+	handler->_tombstones = 0;
+
+	return 0;
+}
+
+static int _fht_reserve(struct fht_handler *handler) {
+	ui32_t size = handler->arr_size;
+
+	if (((handler->_count + handler->_tombstones + 1) * (unsigned long) FHT_LOAD_FACTOR_DEN) <= (size * (unsigned long) FHT_LOAD_FACTOR_NUM))
+		return 0;
+
+	/* Tombstones are dropped on rehash, so the array may not need to grow */
+	while (((handler->_count + 1) * (unsigned long) FHT_LOAD_FACTOR_DEN) > (size * (unsigned long) FHT_LOAD_FACTOR_NUM)) {
+		if (!(size <<= 1)) {
+			errno = ERANGE;
+			return -1;
+		}
+	}
+
+	return _fht_rehash(handler, size);
+}
+
+static int _fht_insert(struct fht_handler *handler, void *data) {
+	ui32_t hash = 0, mask = 0, i = 0;
+
+	if (!data) {
+		handler->_stat.insert_err ++;
+		errno = EINVAL;
+		return -1;
+	}
+
+	hash = _fht_hash(handler, data);
+
+	if (_fht_reserve(handler) < 0) {
+		handler->_stat.insert_err ++;
+		return -1;
+	}
+
+	mask = handler->arr_size - 1;
+
+	for (i = hash & mask; _fht_is_elem(&handler->array[i]); i = (i + 1) & mask)
+		;
+
+	if (handler->array[i].data == FHT_TOMBSTONE)
+		handler->_tombstones --;
+
+	handler->array[i].data = data;
+	handler->array[i].hash = hash;
+
+	handler->_count ++;
+
+	handler->_stat.insert ++;
+
+	if (handler->_stat.elem_count_max < handler->_count)
+		handler->_stat.elem_count_max = handler->_count;
+
+	return 0;
+}
+
+static int _fht_delete(struct fht_handler *handler, void *data) {
+	ui32_t i = 0;
+
+	if ((i = _fht_lookup(handler, data)) == handler->arr_size) {
+		handler->_stat.del_nf ++;
+		return -1;
+	}
+
+	handler->destroy(_fht_remove(handler, i));
+
+	handler->_stat.del ++;
+
+	return 0;
+}
+
+static void *_fht_search(struct fht_handler *handler, void *data) {
+	ui32_t i = 0;
+
+	if ((i = _fht_lookup(handler, data)) == handler->arr_size) {
+		handler->_stat.search_nf ++;
+		return NULL;
+	}
+
+	handler->_stat.search ++;
+
+	return handler->array[i].data;
+}
+
+static ui32_t _fht_count(struct fht_handler *handler) {
+	handler->_stat.count ++;
+
+	return handler->_count;
+}
+
+static int _fht_serialize(struct fht_handler *handler, pall_fd_t fd) {
+	ui32_t i = 0;
+	ui32_t count_nbo = pall_htonl(handler->_count);
+
+	if (!handler->ser_data) {
+		handler->_stat.serialize_err ++;
+		errno = ENOSYS;
+		return -1;
+	}
+
+	if (pall_write(fd, &count_nbo, 4) != 4) {
+		handler->_stat.serialize_err ++;
+		return -1;
+	}
+
+	for (i = 0; i < handler->arr_size; i ++) {
+		if (!_fht_is_elem(&handler->array[i]))
+			continue;
+
+		if (handler->ser_data(fd, handler->array[i].data) < 0) {
+			handler->_stat.serialize_err ++;
+			return -1;
+		}
+	}
+
+	handler->_stat.serialize ++;
+
+	return 0;
+}
+
+static int _fht_unserialize(struct fht_handler *handler, pall_fd_t fd) {
+	ui32_t count = 0;
+	void *data = NULL;
+
+	if (!handler->unser_data) {
+		handler->_stat.unserialize_err ++;
+		errno = ENOSYS;
+		return -1;
+	}
+
+	if (pall_read(fd, &count, 4) != 4) {
+		handler->_stat.unserialize_err ++;
+		return -1;
+	}
+
+	for (count = ntohl(count); count; count --) {
+		if (!(data = handler->unser_data(fd))) {
+			handler->_stat.unserialize_err ++;
+			return -1;
+		}
+
+		if (handler->insert(handler, data) < 0) {
+			handler->_stat.unserialize_err ++;
+			return -1;
+		}
+	}
+
+	handler->_stat.unserialize ++;
+
+	return 0;
+}
+
+static struct fht_stat *_fht_stat(struct fht_handler *handler) {
+	ui32_t i = 0, mask = handler->arr_size - 1;
+	unsigned long len = 0, total = 0;
+
+	handler->_stat.elem_count_cur = handler->_count;
+	handler->_stat.probe_len_max = 0;
+
+	for (i = 0; i < handler->arr_size; i ++) {
+		if (!_fht_is_elem(&handler->array[i]))
+			continue;
+
+		len = (i - (handler->array[i].hash & mask)) & mask;
+
+		if (len > handler->_stat.probe_len_max)
+			handler->_stat.probe_len_max = len;
+
+		total += len;
+	}
+
+	handler->_stat.probe_len_avg = handler->_count ? (total / (float) handler->_count) : 0;
+
+	handler->_stat.stat ++;
+
+	return &handler->_stat;
+}
+
+static void _fht_stat_reset(struct fht_handler *handler) {
+	memset(&handler->_stat, 0, sizeof(struct fht_stat));
+}
+
+static void *_fht_pope(struct fht_handler *handler, void *data) {
+	ui32_t i = 0;
+
+	if ((i = _fht_lookup(handler, data)) == handler->arr_size) {
+		handler->_stat.pope_nf ++;
+		return NULL;
+	}
+
+	handler->_stat.pope ++;
+
+	return _fht_remove(handler, i);
+}
+
+static void _fht_collapse(struct fht_handler *handler) {
+	ui32_t i = 0;
+
+	for (i = 0; i < handler->arr_size; i ++) {
+		if (_fht_is_elem(&handler->array[i]))
+			handler->destroy(handler->array[i].data);
+	}
+
+	memset(handler->array, 0, handler->arr_size * sizeof(struct fht_slot));
+
+	handler->_count = 0;
+	handler->_tombstones = 0;
+	handler->_iterate_arr_pos = 0;
+	handler->_iterating = 0;
+
+	handler->_stat.collapse ++;
+}
+
+static void *_fht_iterate(struct fht_handler *handler) {
+	struct fht_slot *slot = NULL;
+
+	while (handler->_iterate_arr_pos < handler->arr_size) {
+		slot = &handler->array[handler->_iterate_arr_pos];
+
+		/* Reverse iterations end past the last slot as well */
+		if (handler->_iterate_reverse) {
+			handler->_iterate_arr_pos = handler->_iterate_arr_pos ? handler->_iterate_arr_pos - 1 : handler->arr_size;
+		} else {
+			handler->_iterate_arr_pos ++;
+		}
+
+		if (_fht_is_elem(slot)) {
+			handler->_iterating = 1;
+
+			return slot->data;
+		}
+	}
+
+	handler->_iterating = 0;
+
+	_fht_purge(handler);
+
+	handler->_stat.iterate ++;
+
+	return NULL;
+}
+
+static void _fht_rewind(struct fht_handler *handler, int to) {
+	handler->_iterate_reverse = to;
+	handler->_iterating = 0;
+
+	_fht_purge(handler);
+
+	if (to) {
+		handler->_iterate_arr_pos = handler->arr_size - 1;
+	} else {
+		handler->_iterate_arr_pos = 0;
+	}
+
+	handler->_stat.rewind ++;
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct fht_handler *pall_fht_init_mm(
+		int (*compare) (const void *d1, const void *d2),
+		void (*destroy) (void *data),
+		ui32_t (*hash) (void *data),
+		int (*ser_data) (pall_fd_t fd, void *data),
+		void *(*unser_data) (pall_fd_t fd),
+		unsigned int array_size,
+		const struct pall_mm *mm)
+{
+	int errsv = 0;
+	ui32_t size = 0;
+	struct fht_handler *handler = NULL;
+	struct pall_mm hmm;
+
+	if (!hash || !destroy || (mm && (!mm->alloc || !mm->free))) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	if (!array_size)
+		array_size = FHT_DEFAULT_ARR_SIZE;
+
+	if (!(size = hash_pow2_ceil(array_size < FHT_MIN_ARR_SIZE ? FHT_MIN_ARR_SIZE : array_size))) {
+		errno = ERANGE;
+		return NULL;
+	}
+
+	mm_copy(&hmm, mm);
+
+	if (!(handler = (struct fht_handler *) mm_alloc_with(&hmm, sizeof(struct fht_handler))))
+		return NULL;
+
+	memset(handler, 0, sizeof(struct fht_handler));
+
+	memcpy(&handler->_mm, &hmm, sizeof(struct pall_mm));
+
+	handler->arr_size = size;
+	handler->_iterate_arr_pos = 0;
+
+	handler->compare = compare;
+	handler->hash = hash;
+	handler->destroy = destroy;
+	handler->ser_data = ser_data;
+	handler->unser_data = unser_data;
+
+	handler->insert = &_fht_insert;
+	handler->del = &_fht_delete;
+	handler->search = &_fht_search;
+	handler->serialize = &_fht_serialize;
+	handler->unserialize = &_fht_unserialize;
+	handler->stat = &_fht_stat;
+	handler->stat_reset = &_fht_stat_reset;
+	handler->count = &_fht_count;
+	handler->pope = &_fht_pope;
+	handler->collapse = &_fht_collapse;
+	handler->iterate = &_fht_iterate;
+	handler->rewind = &_fht_rewind;
+
+	if (!(handler->array = (struct fht_slot *) mm_calloc_with(&hmm, handler->arr_size, sizeof(struct fht_slot)))) {
+		errsv = errno;
+		mm_free_with(&hmm, handler);
+		errno = errsv;
+		return NULL;
+	}
+
+	return handler;
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct fht_handler *pall_fht_init(
+		int (*compare) (const void *d1, const void *d2),
+		void (*destroy) (void *data),
+		ui32_t (*hash) (void *data),
+		int (*ser_data) (pall_fd_t fd, void *data),
+		void *(*unser_data) (pall_fd_t fd),
+		unsigned int array_size)
+{
+	return pall_fht_init_mm(compare, destroy, hash, ser_data, unser_data, array_size, NULL);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_fht_destroy(struct fht_handler *h) {
+	struct pall_mm hmm;
+
+	h->collapse(h);
+
+	memcpy(&hmm, &h->_mm, sizeof(struct pall_mm));
+
+	mm_free_with(&hmm, h->array);
+	mm_free_with(&hmm, h);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_fht_insert(struct fht_handler *h, void *data) {
+	return h->insert(h, data);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_fht_delete(struct fht_handler *h, void *data) {
+	return h->del(h, data);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_fht_search(struct fht_handler *h, void *data) {
+	return h->search(h, data);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_fht_serialize(struct fht_handler *h, pall_fd_t fd) {
+	return h->serialize(h, fd);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_fht_unserialize(struct fht_handler *h, pall_fd_t fd) {
+	return h->unserialize(h, fd);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct fht_stat *pall_fht_stat(struct fht_handler *h) {
+	return h->stat(h);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_fht_stat_reset(struct fht_handler *h) {
+	h->stat_reset(h);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_fht_count(struct fht_handler *h) {
+	return h->count(h);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_fht_pope(struct fht_handler *h, void *data) {
+	return h->pope(h, data);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_fht_collapse(struct fht_handler *h) {
+	h->collapse(h);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_fht_iterate(struct fht_handler *h) {
+	return h->iterate(h);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_fht_rewind(struct fht_handler *h, int to) {
+	h->rewind(h, to);
+}
+
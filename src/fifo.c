@@ -39,6 +39,10 @@ static int _fifo_push(struct fifo_handler *handler, void *data) {
 	return handler->fifo->insert(handler->fifo, data);
 }
 
+static int _fifo_push_batch(struct fifo_handler *handler, void **data, ui32_t count) {
+	return handler->fifo->insert_batch(handler->fifo, data, count);
+}
+
 static void *_fifo_pop(struct fifo_handler *handler) {
 	return handler->fifo->poph(handler->fifo);
 }
@@ -95,33 +99,45 @@ static void _fifo_rewind(struct fifo_handler *handler, int to) {
 #ifdef COMPILE_WIN32
 DLLIMPORT
 #endif
-struct fifo_handler *pall_fifo_init(
+struct fifo_handler *pall_fifo_init_mm(
 		void (*destroy) (void *data),
 		int (*ser_data) (pall_fd_t fd, void *data),
-		void *(*unser_data) (pall_fd_t fd))
+		void *(*unser_data) (pall_fd_t fd),
+		const struct pall_mm *mm)
 {
+	int errsv = 0;
 	struct fifo_handler *handler = NULL;
+	struct pall_mm hmm;
 
-	if (!destroy) {
+	if (!destroy || (mm && (!mm->alloc || !mm->free))) {
 		errno = EINVAL;
 		return NULL;
 	}
 
-	if (!(handler = (struct fifo_handler *) mm_alloc(sizeof(struct fifo_handler))))
+	mm_copy(&hmm, mm);
+
+	if (!(handler = (struct fifo_handler *) mm_alloc_with(&hmm, sizeof(struct fifo_handler))))
 		return NULL;
 
 	memset(handler, 0, sizeof(struct fifo_handler));
 
-	if (!(handler->fifo = pall_cll_init(NULL, destroy, ser_data, unser_data)))
+	memcpy(&handler->_mm, &hmm, sizeof(struct pall_mm));
+
+	if (!(handler->fifo = pall_cll_init_mm(NULL, destroy, ser_data, unser_data, &hmm))) {
+		errsv = errno;
+		mm_free_with(&hmm, handler);
+		errno = errsv;
 		return NULL;
+	}
 
-	handler->fifo->set_config(handler->fifo, CONFIG_INSERT_TAIL);
+	handler->fifo->set_config(handler->fifo, CONFIG_INSERT_TAIL | CONFIG_MM_POOL);
 
 	handler->destroy = destroy;
 	handler->ser_data = ser_data;
 	handler->unser_data = unser_data;
 
 	handler->push = &_fifo_push;
+	handler->push_batch = &_fifo_push_batch;
 	handler->pop = &_fifo_pop;
 	handler->serialize = &_fifo_serialize;
 	handler->unserialize = &_fifo_unserialize;
@@ -139,11 +155,26 @@ struct fifo_handler *pall_fifo_init(
 DLLIMPORT
 #endif
 void pall_fifo_destroy(struct fifo_handler *h) {
+	struct pall_mm hmm;
+
 	h->collapse(h);
 
 	pall_cll_destroy(h->fifo);
 
-	mm_free(h);
+	memcpy(&hmm, &h->_mm, sizeof(struct pall_mm));
+
+	mm_free_with(&hmm, h);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct fifo_handler *pall_fifo_init(
+		void (*destroy) (void *data),
+		int (*ser_data) (pall_fd_t fd, void *data),
+		void *(*unser_data) (pall_fd_t fd))
+{
+	return pall_fifo_init_mm(destroy, ser_data, unser_data, NULL);
 }
 
 #ifdef COMPILE_WIN32
@@ -153,6 +184,13 @@ int pall_fifo_push(struct fifo_handler *h, void *data) {
 	return h->push(h, data);
 }
 
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_fifo_push_batch(struct fifo_handler *h, void **data, ui32_t count) {
+	return h->push_batch(h, data, count);
+}
+
 #ifdef COMPILE_WIN32
 DLLIMPORT
 #endif
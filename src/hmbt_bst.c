@@ -34,51 +34,125 @@
 #include "pall.h"
 #include "hmbt_bst.h"
 #include "bst.h"
+#include "hash.h"
+#include "bitmap.h"
+#include "lenhist.h"
+
+static ui32_t _hmbt_bst_index(struct hmbt_bst_handler *handler, void *data) {
+	if (handler->_config_flags & CONFIG_HASH_MASK)
+		return hash_fmix32(handler->hash(data)) & (handler->arr_size - 1);
+
+	return handler->hash(data) % handler->arr_size;
+}
 
 static int _hmbt_bst_insert(struct hmbt_bst_handler *handler, void *data) {
-	struct bst_handler *pbst = NULL;
+	ui32_t index = _hmbt_bst_index(handler, data);
+	struct bst_handler *pbst = handler->array[index];
+
+	if (pbst->insert(pbst, data) < 0) {
+		handler->_stat.insert_err ++;
+		return -1;
+	}
+
+	bitmap_set(handler->_occupied, index);
+
+	lenhist_move(&handler->_lenhist, &handler->_mm, pbst->_count - 1, pbst->_count);
+
+	handler->_count ++;
+
+	handler->_stat.insert ++;
 
-	pbst = handler->array[handler->hash(data) % handler->arr_size];
+	if (handler->_stat.elem_count_max < handler->_count)
+		handler->_stat.elem_count_max = handler->_count;
 
-	return pbst->insert(pbst, data);
+	return 0;
 }
 
 static int _hmbt_bst_delete(struct hmbt_bst_handler *handler, void *data) {
-	struct bst_handler *pbst = NULL;
+	ui32_t index = _hmbt_bst_index(handler, data);
+	struct bst_handler *pbst = handler->array[index];
+
+	if (pbst->del(pbst, data) < 0) {
+		handler->_stat.del_nf ++;
+		return -1;
+	}
+
+	if (!pbst->_count)
+		bitmap_clear(handler->_occupied, index);
 
-	pbst = handler->array[handler->hash(data) % handler->arr_size];
+	lenhist_move(&handler->_lenhist, &handler->_mm, pbst->_count + 1, pbst->_count);
 
-	return pbst->del(pbst, data);
+	handler->_count --;
+
+	handler->_stat.del ++;
+
+	return 0;
 }
 
 static void *_hmbt_bst_search(struct hmbt_bst_handler *handler, void *data) {
-	struct bst_handler *pbst = NULL;
+	struct bst_handler *pbst = handler->array[_hmbt_bst_index(handler, data)];
+	void *d = NULL;
 
-	pbst = handler->array[handler->hash(data) % handler->arr_size];
+	if (!(d = pbst->search(pbst, data))) {
+		handler->_stat.search_nf ++;
+		return NULL;
+	}
+
+	handler->_stat.search ++;
 
-	return pbst->search(pbst, data);
+	return d;
 }
 
-static ui32_t _hmbt_bst_count(struct hmbt_bst_handler *handler) {
-	unsigned long i = 0;
-	ui32_t count = 0;
-	struct bst_handler *pbst = NULL;
+static ui32_t _hmbt_bst_search_batch(struct hmbt_bst_handler *handler, void **keys, void **results, ui32_t n) {
+	struct bst_handler *pbst[HMBT_BST_BATCH_SIZE];
+	ui32_t index[HMBT_BST_BATCH_SIZE];
+	ui32_t i = 0, j = 0, len = 0, found = 0;
 
-	for (i = 0; i < handler->arr_size; i ++) {
-		pbst = handler->array[i];
+	for (i = 0; i < n; i += len) {
+		len = ((n - i) < HMBT_BST_BATCH_SIZE) ? (n - i) : HMBT_BST_BATCH_SIZE;
 
-		count += pbst->count(pbst);
+		for (j = 0; j < len; j ++) {
+			index[j] = _hmbt_bst_index(handler, keys[i + j]);
+			mm_prefetch(&handler->array[index[j]]);
+		}
+
+		for (j = 0; j < len; j ++) {
+			pbst[j] = bitmap_test(handler->_occupied, index[j]) ? handler->array[index[j]] : NULL;
+			mm_prefetch(pbst[j]);
+		}
+
+		for (j = 0; j < len; j ++) {
+			if (pbst[j])
+				mm_prefetch(pbst[j]->root);
+		}
+
+		for (j = 0; j < len; j ++) {
+			if (!pbst[j] || !(results[i + j] = pbst[j]->search(pbst[j], keys[i + j]))) {
+				results[i + j] = NULL;
+				handler->_stat.search_nf ++;
+				continue;
+			}
+
+			handler->_stat.search ++;
+
+			found ++;
+		}
 	}
 
+	return found;
+}
+
+static ui32_t _hmbt_bst_count(struct hmbt_bst_handler *handler) {
 	handler->_stat.count ++;
 
-	return count;
+	return handler->_count;
 }
 
 static int _hmbt_bst_serialize(struct hmbt_bst_handler *handler, pall_fd_t fd) {
 	unsigned long i = 0;
 	struct bst_handler *pbst = NULL;
 	ui32_t arr_size_nbo = pall_htonl(handler->arr_size);
+	ui32_t empty_nbo = 0;
 
 	if (!handler->ser_data) {
 		handler->_stat.serialize_err ++;
@@ -92,6 +166,18 @@ static int _hmbt_bst_serialize(struct hmbt_bst_handler *handler, pall_fd_t fd) {
 	}
 
 	for (i = 0; i < handler->arr_size; i ++) {
+		/* An empty BST is serialized as a zero element count, which is
+		 * written without touching the BST handler.
+		 */
+		if (!bitmap_test(handler->_occupied, i)) {
+			if (pall_write(fd, &empty_nbo, 4) != 4) {
+				handler->_stat.serialize_err ++;
+				return -1;
+			}
+
+			continue;
+		}
+
 		pbst = handler->array[i];
 
 		if (pbst->serialize(pbst, fd) < 0) {
@@ -109,7 +195,9 @@ static int _hmbt_bst_unserialize(
 		struct hmbt_bst_handler *handler,
 		pall_fd_t fd)
 {
+	int ret = 0;
 	unsigned long i = 0;
+	ui32_t count = 0;
 	struct bst_handler *pbst = NULL;
 
 	if (!handler->unser_data) {
@@ -128,7 +216,22 @@ static int _hmbt_bst_unserialize(
 	for (i = 0; i < handler->arr_size; i ++) {
 		pbst = handler->array[i];
 
-		if (pbst->unserialize(pbst, fd) < 0) {
+		count = pbst->_count;
+		ret = pbst->unserialize(pbst, fd);
+
+		/* Elements are inserted straight into the bucket */
+		handler->_count += pbst->_count - count;
+		handler->_stat.insert += pbst->_count - count;
+
+		if (handler->_stat.elem_count_max < handler->_count)
+			handler->_stat.elem_count_max = handler->_count;
+
+		if (pbst->_count)
+			bitmap_set(handler->_occupied, i);
+
+		lenhist_move(&handler->_lenhist, &handler->_mm, count, pbst->_count);
+
+		if (ret < 0) {
 			handler->_stat.unserialize_err ++;
 			return -1;
 		}
@@ -141,40 +244,38 @@ static int _hmbt_bst_unserialize(
 
 static struct hmbt_bst_stat *_hmbt_bst_stat(struct hmbt_bst_handler *handler) {
 	unsigned long i = 0;
-	struct bst_handler *pbst = NULL;
+	unsigned long *node_elem_count = handler->_stat.node_elem_count;
+	int rebuild = handler->_lenhist.stale;
 
-	handler->_stat.insert = 0;
-	handler->_stat.insert_err = 0;
-	handler->_stat.del = 0;
-	handler->_stat.del_nf = 0;
-	handler->_stat.search = 0;
-	handler->_stat.search_nf = 0;
-	handler->_stat.elem_count_cur = 0;
-	handler->_stat.elem_count_max = 0;
-	handler->_stat.node_elem_count_min = ~0UL;
-	handler->_stat.node_elem_count_avg = 0;
-	handler->_stat.node_elem_count_max = 0;
-
-	memset(handler->_stat.node_elem_count, 0, handler->arr_size * sizeof(unsigned long));
-	
-	for (i = 0; i < handler->arr_size; i ++) {
-		pbst = handler->array[i];
+	handler->_stat.elem_count_cur = handler->_count;
+
+	/* Aggregate counters, including the smallest and largest BST sizes, are
+	 * kept on every operation. Only the per node distribution requires a
+	 * pass over the array, which also rebuilds a bucket length histogram that
+	 * failed to grow.
+	 */
+	if (!(handler->_config_flags & CONFIG_STAT_INCREMENTAL) || rebuild) {
+		handler->_stat.node_elem_count_min = ~0UL;
+		handler->_stat.node_elem_count_max = 0;
 
-		handler->_stat.insert += pbst->stat(pbst)->insert;
-		handler->_stat.insert_err += pbst->stat(pbst)->insert_err;
-		handler->_stat.del += pbst->stat(pbst)->del;
-		handler->_stat.del_nf += pbst->stat(pbst)->del_nf;
-		handler->_stat.search += pbst->stat(pbst)->search;
-		handler->_stat.search_nf += pbst->stat(pbst)->search_nf;
-		handler->_stat.elem_count_cur += pbst->stat(pbst)->elem_count_cur;
-		handler->_stat.elem_count_max += pbst->stat(pbst)->elem_count_max;
-		handler->_stat.node_elem_count[i] = pbst->count(pbst);
-
-		if (handler->_stat.node_elem_count[i] < handler->_stat.node_elem_count_min)
-			handler->_stat.node_elem_count_min = handler->_stat.node_elem_count[i];
-
-		if (handler->_stat.node_elem_count[i] > handler->_stat.node_elem_count_max)
-			handler->_stat.node_elem_count_max = handler->_stat.node_elem_count[i];
+		if (rebuild)
+			lenhist_clear(&handler->_lenhist, 0);
+
+		for (i = 0; i < handler->arr_size; i ++) {
+			node_elem_count[i] = handler->array[i]->_count;
+
+			if (node_elem_count[i] < handler->_stat.node_elem_count_min)
+				handler->_stat.node_elem_count_min = node_elem_count[i];
+
+			if (node_elem_count[i] > handler->_stat.node_elem_count_max)
+				handler->_stat.node_elem_count_max = node_elem_count[i];
+
+			if (rebuild)
+				lenhist_add(&handler->_lenhist, &handler->_mm, handler->array[i]->_count);
+		}
+	} else {
+		handler->_stat.node_elem_count_min = handler->_lenhist.min;
+		handler->_stat.node_elem_count_max = handler->_lenhist.max;
 	}
 
 	handler->_stat.node_elem_count_avg = handler->_stat.elem_count_cur / (float) handler->arr_size;
@@ -206,95 +307,199 @@ static void _hmbt_bst_collapse(struct hmbt_bst_handler *handler) {
 	ui32_t i = 0;
 	struct bst_handler *pbst = NULL;
 
-	for (i = 0; i < handler->arr_size; i ++) {
+	for (i = bitmap_next(handler->_occupied, handler->arr_size, 0); i < handler->arr_size; i = bitmap_next(handler->_occupied, handler->arr_size, i + 1)) {
 		pbst = handler->array[i];
 
 		pbst->collapse(pbst);
 	}
 
+	memset(handler->_occupied, 0, bitmap_words(handler->arr_size) * sizeof(unsigned long));
+
+	lenhist_clear(&handler->_lenhist, handler->arr_size);
+
+	handler->_count = 0;
+
 	handler->_stat.collapse ++;
 }
 
+static void _hmbt_bst_iterate_enter(struct hmbt_bst_handler *handler, ui32_t pos) {
+	handler->_iterate_arr_pos = pos;
+
+	/* Each BST is rewound once the iteration reaches it, so that empty BSTs
+	 * are never visited.
+	 */
+	if (pos < handler->arr_size)
+		handler->array[pos]->rewind(handler->array[pos], handler->_iterate_reverse);
+}
+
 static void *_hmbt_bst_iterate(struct hmbt_bst_handler *handler) {
 	void *data = NULL;
+	ui32_t pos = 0;
 	struct bst_handler *pbst = NULL;
 
-	for (;;) {
-		pbst = handler->array[handler->_iterate_arr_pos];
+	if (!handler->_iterate_started) {
+		_hmbt_bst_iterate_enter(handler, handler->_iterate_reverse ? bitmap_prev(handler->_occupied, handler->arr_size, handler->arr_size - 1) : bitmap_next(handler->_occupied, handler->arr_size, 0));
 
-		if ((data = pbst->iterate(pbst)))
-			break;
+		handler->_iterate_started = 1;
+	}
 
-		if (handler->_iterate_reverse) {
-			if (!handler->_iterate_arr_pos)
-				break;
+	while ((pos = handler->_iterate_arr_pos) < handler->arr_size) {
+		pbst = handler->array[pos];
 
-			handler->_iterate_arr_pos --;
-		} else {
-			handler->_iterate_arr_pos ++;
+		if ((data = pbst->iterate(pbst)))
+			return data;
 
-			if (handler->_iterate_arr_pos >= handler->arr_size)
-				break;
+		if (handler->_iterate_range) {
+			handler->_iterate_arr_pos = handler->arr_size;
+		} else if (handler->_iterate_reverse) {
+			_hmbt_bst_iterate_enter(handler, pos ? bitmap_prev(handler->_occupied, handler->arr_size, pos - 1) : handler->arr_size);
+		} else {
+			_hmbt_bst_iterate_enter(handler, bitmap_next(handler->_occupied, handler->arr_size, pos + 1));
 		}
 	}
 
-	if (!data)
-		handler->_stat.iterate ++;
+	handler->_stat.iterate ++;
 
-	return data;
+	return NULL;
 }
 
 static void _hmbt_bst_rewind(struct hmbt_bst_handler *handler, int to) {
-	unsigned long i = 0;
+	handler->_iterate_reverse = to;
+	handler->_iterate_started = 0;
+	handler->_iterate_range = 0;
+
+	handler->_stat.rewind ++;
+}
+
+static void _hmbt_bst_range(struct hmbt_bst_handler *handler, void *lo, void *hi) {
 	struct bst_handler *pbst = NULL;
 
-	handler->_iterate_reverse = to;
+	handler->_iterate_arr_pos = _hmbt_bst_index(handler, lo);
+	handler->_iterate_reverse = 0;
+	handler->_iterate_started = 1;
+	handler->_iterate_range = 1;
 
-	for (i = 0; i < handler->arr_size; i ++) {
-		pbst = handler->array[i];
-		pbst->rewind(pbst, to);
+	pbst = handler->array[handler->_iterate_arr_pos];
+
+	pbst->range(pbst, lo, hi);
+
+	handler->_stat.range ++;
+}
+
+static int _hmbt_bst_set_mask(struct hmbt_bst_handler *handler) {
+	int errsv = 0;
+	ui32_t i = 0, size = hash_pow2_ceil(handler->arr_size);
+	struct bst_handler **array = NULL;
+	unsigned long *node_elem_count = NULL, *occupied = NULL;
+
+	if (!size) {
+		errno = ERANGE;
+		return -1;
 	}
 
-	if (to) {
-		handler->_iterate_arr_pos = handler->arr_size - 1;
-	} else {
-		handler->_iterate_arr_pos = 0;
+	if (size == handler->arr_size)
+		return 0;
+
+	if (!(node_elem_count = (unsigned long *) mm_resize_with(&handler->_mm, handler->_stat.node_elem_count, handler->arr_size * sizeof(unsigned long), size * sizeof(unsigned long))))
+		return -1;
+
+	handler->_stat.node_elem_count = node_elem_count;
+
+	if (!(occupied = (unsigned long *) mm_resize_with(&handler->_mm, handler->_occupied, bitmap_words(handler->arr_size) * sizeof(unsigned long), bitmap_words(size) * sizeof(unsigned long))))
+		return -1;
+
+	/* Only empty handlers are resized */
+	memset(occupied, 0, bitmap_words(size) * sizeof(unsigned long));
+
+	handler->_occupied = occupied;
+
+	if (!(array = (struct bst_handler **) mm_resize_with(&handler->_mm, handler->array, handler->arr_size * sizeof(struct bst_handler *), size * sizeof(struct bst_handler *))))
+		return -1;
+
+	handler->array = array;
+
+	for (i = handler->arr_size; i < size; i ++) {
+		if (!(array[i] = pall_bst_init_mm(handler->compare, handler->destroy, handler->ser_data, handler->unser_data, &handler->_mm))) {
+			errsv = errno;
+			while (i -- > handler->arr_size)
+				pall_bst_destroy(array[i]);
+			errno = errsv;
+			return -1;
+		}
+
+		array[i]->set_config(array[i], handler->_config_flags & ~(CONFIG_HASH_MASK | CONFIG_STAT_INCREMENTAL));
 	}
 
-	handler->_stat.rewind ++;
+	handler->arr_size = size;
+
+	lenhist_clear(&handler->_lenhist, size);
+
+	return 0;
+}
+
+static ui32_t _hmbt_bst_set_config(struct hmbt_bst_handler *handler, ui32_t flags) {
+	ui32_t i = 0, old_flags = handler->_config_flags;
+
+	/* Switching the index selection mode requires an empty array */
+	if ((flags ^ old_flags) & CONFIG_HASH_MASK) {
+		if (handler->_count || ((flags & CONFIG_HASH_MASK) && (_hmbt_bst_set_mask(handler) < 0)))
+			flags ^= CONFIG_HASH_MASK;
+	}
+
+	for (i = 0; i < handler->arr_size; i ++)
+		handler->array[i]->set_config(handler->array[i], flags & ~(CONFIG_HASH_MASK | CONFIG_STAT_INCREMENTAL));
+
+	handler->_config_flags = flags;
+
+	handler->_stat.set_config ++;
+
+	return old_flags;
+}
+
+static ui32_t _hmbt_bst_get_config(struct hmbt_bst_handler *handler) {
+	handler->_stat.get_config ++;
+
+	return handler->_config_flags;
 }
 
 #ifdef COMPILE_WIN32
 DLLIMPORT
 #endif
-struct hmbt_bst_handler *pall_hmbt_bst_init(
+struct hmbt_bst_handler *pall_hmbt_bst_init_mm(
 		int (*compare) (const void *d1, const void *d2),
 		void (*destroy) (void *data),
 		ui32_t (*hash) (void *data),
 		int (*ser_data) (pall_fd_t fd, void *data),
 		void *(*unser_data) (pall_fd_t fd),
-		unsigned int array_size)
+		unsigned int array_size,
+		const struct pall_mm *mm)
 {
 	int errsv = 0;
 	long i = 0;
 	struct hmbt_bst_handler *handler = NULL;
+	struct pall_mm hmm;
 
-	if (!hash || !destroy) {
+	if (!hash || !destroy || (mm && (!mm->alloc || !mm->free))) {
 		errno = EINVAL;
 		return NULL;
 	}
 
-	if (!(handler = (struct hmbt_bst_handler *) mm_alloc(sizeof(struct hmbt_bst_handler))))
+	mm_copy(&hmm, mm);
+
+	if (!(handler = (struct hmbt_bst_handler *) mm_alloc_with(&hmm, sizeof(struct hmbt_bst_handler))))
 		return NULL;
 
 	memset(handler, 0, sizeof(struct hmbt_bst_handler));
 
+	memcpy(&handler->_mm, &hmm, sizeof(struct pall_mm));
+
 	handler->arr_size = array_size ? array_size : HMBT_BST_DEFAULT_ARR_SIZE;
+	handler->_config_flags = CONFIG_MM_POOL;
 	handler->_iterate_arr_pos = 0;
 
-	if (!(handler->_stat.node_elem_count = (unsigned long *) mm_alloc(handler->arr_size * sizeof(unsigned long)))) {
+	if (!(handler->_stat.node_elem_count = (unsigned long *) mm_alloc_with(&hmm, handler->arr_size * sizeof(unsigned long)))) {
 		errsv = errno;
-		mm_free(handler);
+		mm_free_with(&hmm, handler);
 		errno = errsv;
 		return NULL;
 	}
@@ -308,6 +513,7 @@ struct hmbt_bst_handler *pall_hmbt_bst_init(
 	handler->insert = &_hmbt_bst_insert;
 	handler->del = &_hmbt_bst_delete;
 	handler->search = &_hmbt_bst_search;
+	handler->search_batch = &_hmbt_bst_search_batch;
 	handler->serialize = &_hmbt_bst_serialize;
 	handler->unserialize = &_hmbt_bst_unserialize;
 	handler->stat = &_hmbt_bst_stat;
@@ -316,21 +522,47 @@ struct hmbt_bst_handler *pall_hmbt_bst_init(
 	handler->collapse = &_hmbt_bst_collapse;
 	handler->iterate = &_hmbt_bst_iterate;
 	handler->rewind = &_hmbt_bst_rewind;
+	handler->range = &_hmbt_bst_range;
+	handler->set_config = &_hmbt_bst_set_config;
+	handler->get_config = &_hmbt_bst_get_config;
+
+	if (!(handler->array = (struct bst_handler **) mm_alloc_with(&hmm, sizeof(struct bst_handler *) * handler->arr_size))) {
+		errsv = errno;
+		mm_free_with(&hmm, handler->_stat.node_elem_count);
+		mm_free_with(&hmm, handler);
+		errno = errsv;
+		return NULL;
+	}
 
-	if (!(handler->array = (struct bst_handler **) mm_alloc(sizeof(struct bst_handler *) * handler->arr_size))) {
+	if (!(handler->_occupied = (unsigned long *) mm_calloc_with(&hmm, bitmap_words(handler->arr_size), sizeof(unsigned long)))) {
 		errsv = errno;
-		mm_free(handler);
+		mm_free_with(&hmm, handler->array);
+		mm_free_with(&hmm, handler->_stat.node_elem_count);
+		mm_free_with(&hmm, handler);
+		errno = errsv;
+		return NULL;
+	}
+
+	if (lenhist_init(&handler->_lenhist, &hmm, handler->arr_size) < 0) {
+		errsv = errno;
+		mm_free_with(&hmm, handler->_occupied);
+		mm_free_with(&hmm, handler->array);
+		mm_free_with(&hmm, handler->_stat.node_elem_count);
+		mm_free_with(&hmm, handler);
 		errno = errsv;
 		return NULL;
 	}
 
 	for (i = 0; ((unsigned) i) < handler->arr_size; i ++) {
-		if (!(handler->array[i] = pall_bst_init(compare, destroy, ser_data, unser_data))) {
+		if (!(handler->array[i] = pall_bst_init_mm(compare, destroy, ser_data, unser_data, &hmm))) {
 			errsv = errno;
 			for (-- i; i >= 0; i --)
 				pall_bst_destroy(handler->array[i]);
-			mm_free(handler->array);
-			mm_free(handler);
+			lenhist_release(&handler->_lenhist, &hmm);
+			mm_free_with(&hmm, handler->_occupied);
+			mm_free_with(&hmm, handler->array);
+			mm_free_with(&hmm, handler->_stat.node_elem_count);
+			mm_free_with(&hmm, handler);
 			errno = errsv;
 			return NULL;
 		}
@@ -339,20 +571,40 @@ struct hmbt_bst_handler *pall_hmbt_bst_init(
 	return handler;
 }
 
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct hmbt_bst_handler *pall_hmbt_bst_init(
+		int (*compare) (const void *d1, const void *d2),
+		void (*destroy) (void *data),
+		ui32_t (*hash) (void *data),
+		int (*ser_data) (pall_fd_t fd, void *data),
+		void *(*unser_data) (pall_fd_t fd),
+		unsigned int array_size)
+{
+	return pall_hmbt_bst_init_mm(compare, destroy, hash, ser_data, unser_data, array_size, NULL);
+}
+
 #ifdef COMPILE_WIN32
 DLLIMPORT
 #endif
 void pall_hmbt_bst_destroy(struct hmbt_bst_handler *h) {
 	ui32_t i = 0;
+	struct pall_mm hmm;
 
 	h->collapse(h);
 
 	for (i = 0; i < h->arr_size; i ++)
 		pall_bst_destroy(h->array[i]);
 
-	mm_free(h->array);
-	mm_free(h->_stat.node_elem_count);
-	mm_free(h);
+	memcpy(&hmm, &h->_mm, sizeof(struct pall_mm));
+
+	lenhist_release(&h->_lenhist, &hmm);
+
+	mm_free_with(&hmm, h->array);
+	mm_free_with(&hmm, h->_occupied);
+	mm_free_with(&hmm, h->_stat.node_elem_count);
+	mm_free_with(&hmm, h);
 }
 
 #ifdef COMPILE_WIN32
@@ -376,6 +628,13 @@ void *pall_hmbt_bst_search(struct hmbt_bst_handler *h, void *data) {
 	return h->search(h, data);
 }
 
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_hmbt_bst_search_batch(struct hmbt_bst_handler *h, void **keys, void **results, ui32_t n) {
+	return h->search_batch(h, keys, results, n);
+}
+
 #ifdef COMPILE_WIN32
 DLLIMPORT
 #endif
@@ -432,3 +691,24 @@ void pall_hmbt_bst_rewind(struct hmbt_bst_handler *h, int to) {
 	h->rewind(h, to);
 }
 
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_hmbt_bst_range(struct hmbt_bst_handler *h, void *lo, void *hi) {
+	h->range(h, lo, hi);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_hmbt_bst_set_config(struct hmbt_bst_handler *h, ui32_t flags) {
+	return h->set_config(h, flags);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_hmbt_bst_get_config(struct hmbt_bst_handler *h) {
+	return h->get_config(h);
+}
+
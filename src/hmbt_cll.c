@@ -34,51 +34,793 @@
 #include "pall.h"
 #include "hmbt_cll.h"
 #include "cll.h"
+#include "hash.h"
+#include "bitmap.h"
+#include "avl.h"
+#include "bloom.h"
+#include "lenhist.h"
+
+struct hmbt_cll_tnode {
+	struct avl_node node;
+	struct hmbt_cll_elem *elem;
+};
+
+static void _hmbt_cll_pool_prepare(struct hmbt_cll_handler *handler) {
+	/* The pool is only created on an empty HMBT-CLL, so that all the nodes
+	 * of a pooled HMBT-CLL are always owned by the pool.
+	 */
+	if (!handler->_pool.size && (handler->_config_flags & CONFIG_MM_POOL) && !handler->_count)
+		mm_pool_init(&handler->_pool, &handler->_mm, sizeof(struct hmbt_cll_elem), HMBT_CLL_MM_POOL_NMEMB_MIN, HMBT_CLL_MM_POOL_NMEMB_MAX);
+}
+
+static struct hmbt_cll_elem *_hmbt_cll_elem_alloc(struct hmbt_cll_handler *handler) {
+	_hmbt_cll_pool_prepare(handler);
+
+	if (handler->_pool.size)
+		return (struct hmbt_cll_elem *) mm_pool_alloc(&handler->_pool);
+
+	return (struct hmbt_cll_elem *) mm_alloc_with(&handler->_mm, sizeof(struct hmbt_cll_elem));
+}
+
+static void _hmbt_cll_elem_free(struct hmbt_cll_handler *handler, struct hmbt_cll_elem *elem) {
+	if (handler->_pool.size) {
+		mm_pool_free(&handler->_pool, elem);
+	} else {
+		mm_free_with(&handler->_mm, elem);
+	}
+}
+
+/* Allocates 'count' nodes chained through their 'next' member. Either all the
+ * nodes are allocated, or none is.
+ */
+static struct hmbt_cll_elem *_hmbt_cll_chain_alloc(struct hmbt_cll_handler *handler, ui32_t count) {
+	struct hmbt_cll_elem *block = NULL, *first = NULL, *n = NULL;
+	ui32_t i = 0;
+
+	_hmbt_cll_pool_prepare(handler);
+
+	/* Pooled nodes are carved from a single contiguous run */
+	if (handler->_pool.size) {
+		if (!(block = (struct hmbt_cll_elem *) mm_pool_alloc_block(&handler->_pool, count)))
+			return NULL;
+
+		for (i = count; i --; first = n) {
+			n = (struct hmbt_cll_elem *) (((char *) block) + (i * handler->_pool.size));
+			n->next = first;
+		}
+
+		return first;
+	}
+
+	for (i = 0; i < count; i ++, first = n) {
+		if (!(n = (struct hmbt_cll_elem *) mm_alloc_with(&handler->_mm, sizeof(struct hmbt_cll_elem)))) {
+			for (; first; first = n) {
+				n = first->next;
+				mm_free_with(&handler->_mm, first);
+			}
+
+			return NULL;
+		}
+
+		n->next = first;
+	}
+
+	return first;
+}
+
+static ui32_t _hmbt_cll_hash(struct hmbt_cll_handler *handler, void *data) {
+	if (handler->_config_flags & CONFIG_HASH_MASK)
+		return hash_fmix32(handler->hash(data));
+
+	return handler->hash(data);
+}
+
+static ui32_t _hmbt_cll_key_hash(struct hmbt_cll_handler *handler, void *key) {
+	if (handler->_config_flags & CONFIG_HASH_MASK)
+		return hash_fmix32(handler->key_hash(key));
+
+	return handler->key_hash(key);
+}
+
+static void *_hmbt_cll_key_self(void *data) {
+	return data;
+}
+
+static ui32_t _hmbt_cll_reduce(struct hmbt_cll_handler *handler, ui32_t hash, ui32_t size) {
+	if (handler->_config_flags & CONFIG_HASH_MASK)
+		return hash & (size - 1);
+
+	return hash % size;
+}
+
+static ui32_t _hmbt_cll_index(struct hmbt_cll_handler *handler, ui32_t hash) {
+	ui32_t index = _hmbt_cll_reduce(handler, hash, handler->_level_size);
+
+	/* Buckets already split on this round are addressed by the next level */
+	if (index < handler->_split)
+		index = _hmbt_cll_reduce(handler, hash, handler->_level_size << 1);
+
+	return index;
+}
+
+static struct hmbt_cll_bucket *_hmbt_cll_bucket(struct hmbt_cll_handler *handler, ui32_t hash) {
+	return &handler->array[_hmbt_cll_index(handler, hash)];
+}
+
+static void _hmbt_cll_occupancy(struct hmbt_cll_handler *handler, struct hmbt_cll_bucket *bucket) {
+	ui32_t index = (ui32_t) (bucket - handler->array);
+
+	if (bucket->count) {
+		bitmap_set(handler->_occupied, index);
+	} else {
+		bitmap_clear(handler->_occupied, index);
+	}
+}
+
+static int _hmbt_cll_tree_cmp(const void *key, const struct avl_node *node, void *arg) {
+	const struct hmbt_cll_elem *elem = (const struct hmbt_cll_elem *) key;
+	const struct hmbt_cll_elem *pos = ((const struct hmbt_cll_tnode *) node)->elem;
+
+	/* Hashes are compared first, so that compare() is only invoked between
+	 * colliding elements.
+	 */
+	if (elem->hash != pos->hash)
+		return (elem->hash < pos->hash) ? -1 : 1;
+
+	return ((struct hmbt_cll_handler *) arg)->compare(elem->data, pos->data);
+}
+
+/* Same as _hmbt_cll_tree_cmp(), but the probe holds a key instead of an element */
+static int _hmbt_cll_tree_key_cmp(const void *key, const struct avl_node *node, void *arg) {
+	const struct hmbt_cll_elem *elem = (const struct hmbt_cll_elem *) key;
+	const struct hmbt_cll_elem *pos = ((const struct hmbt_cll_tnode *) node)->elem;
+	struct hmbt_cll_handler *handler = (struct hmbt_cll_handler *) arg;
+
+	if (elem->hash != pos->hash)
+		return (elem->hash < pos->hash) ? -1 : 1;
+
+	return handler->key_compare(elem->data, handler->key(pos->data));
+}
+
+/* Compares 'data' against the element 'elem'. If 'keyed' is set, 'data' is a
+ * key and it is compared against the key of 'elem' instead.
+ */
+static int _hmbt_cll_match(struct hmbt_cll_handler *handler, int keyed, void *data, void *elem) {
+	if (keyed)
+		return handler->key_compare(data, handler->key(elem));
+
+	return handler->compare(data, elem);
+}
+
+static void _hmbt_cll_tree_release(struct avl_node *node, void *arg) {
+	mm_free_with(&((struct hmbt_cll_handler *) arg)->_mm, node);
+}
+
+static int _hmbt_cll_tree_add(
+		struct hmbt_cll_handler *handler,
+		struct hmbt_cll_bucket *bucket,
+		struct hmbt_cll_elem *elem)
+{
+	struct hmbt_cll_tnode *tnode = NULL;
+
+	if (!(tnode = (struct hmbt_cll_tnode *) mm_alloc_with(&handler->_mm, sizeof(struct hmbt_cll_tnode))))
+		return -1;
+
+	tnode->elem = elem;
+
+	avl_insert(&bucket->tree, &tnode->node, elem, &_hmbt_cll_tree_cmp, handler);
+
+	return 0;
+}
+
+static void _hmbt_cll_tree_del(
+		struct hmbt_cll_handler *handler,
+		struct hmbt_cll_bucket *bucket,
+		struct hmbt_cll_elem *elem)
+{
+	struct avl_node *node = avl_lower_bound(bucket->tree, elem, &_hmbt_cll_tree_cmp, handler);
+
+	/* Matching elements are adjacent on the tree */
+	while (((struct hmbt_cll_tnode *) node)->elem != elem)
+		node = avl_next(node);
+
+	avl_remove(&bucket->tree, node);
+
+	mm_free_with(&handler->_mm, node);
+}
+
+static void _hmbt_cll_treeify(struct hmbt_cll_handler *handler, struct hmbt_cll_bucket *bucket) {
+	struct hmbt_cll_elem *pos = bucket->head;
+
+	do {
+		if (_hmbt_cll_tree_add(handler, bucket, pos) < 0) {
+			/* Lookups keep walking the bucket list */
+			avl_destroy(&bucket->tree, &_hmbt_cll_tree_release, handler);
+			return;
+		}
+	} while ((pos = pos->next) != bucket->head);
+
+	handler->_stat.treeify ++;
+}
+
+static void _hmbt_cll_untreeify(struct hmbt_cll_handler *handler, struct hmbt_cll_bucket *bucket) {
+	if (!bucket->tree)
+		return;
+
+	avl_destroy(&bucket->tree, &_hmbt_cll_tree_release, handler);
+
+	handler->_stat.untreeify ++;
+}
+
+static void _hmbt_cll_tree_adjust(struct hmbt_cll_handler *handler, struct hmbt_cll_bucket *bucket) {
+	if (bucket->tree) {
+		if (!handler->_treeify_max || (bucket->count < handler->_treeify_min))
+			_hmbt_cll_untreeify(handler, bucket);
+	} else if (handler->_treeify_max && (bucket->count > handler->_treeify_max) && handler->compare) {
+		_hmbt_cll_treeify(handler, bucket);
+	}
+}
+
+static void _hmbt_cll_link_before(struct hmbt_cll_elem *pos, struct hmbt_cll_elem *elem) {
+	elem->next = pos;
+	elem->prev = pos->prev;
+	pos->prev->next = elem;
+	pos->prev = elem;
+}
+
+static void _hmbt_cll_append(struct hmbt_cll_bucket *bucket, struct hmbt_cll_elem *elem) {
+	if (!bucket->head) {
+		elem->next = elem;
+		elem->prev = elem;
+		bucket->head = elem;
+	} else {
+		_hmbt_cll_link_before(bucket->head, elem);
+	}
+
+	bucket->count ++;
+}
+
+static int _hmbt_cll_grow(struct hmbt_cll_handler *handler, ui32_t cap) {
+	struct hmbt_cll_bucket *array = NULL;
+	unsigned long *node_elem_count = NULL, *occupied = NULL;
+	size_t words = bitmap_words(handler->_arr_cap);
+
+	if (cap <= handler->_arr_cap) {
+		errno = ENOMEM;
+		return -1;
+	}
+
+	if (!(node_elem_count = (unsigned long *) mm_resize_with(&handler->_mm, handler->_stat.node_elem_count, handler->_arr_cap * sizeof(unsigned long), cap * sizeof(unsigned long))))
+		return -1;
+
+	handler->_stat.node_elem_count = node_elem_count;
+
+	if (!(occupied = (unsigned long *) mm_resize_with(&handler->_mm, handler->_occupied, words * sizeof(unsigned long), bitmap_words(cap) * sizeof(unsigned long))))
+		return -1;
+
+	memset(&occupied[words], 0, (bitmap_words(cap) - words) * sizeof(unsigned long));
+
+	handler->_occupied = occupied;
+
+	if (!(array = (struct hmbt_cll_bucket *) mm_resize_with(&handler->_mm, handler->array, handler->_arr_cap * sizeof(struct hmbt_cll_bucket), cap * sizeof(struct hmbt_cll_bucket))))
+		return -1;
+
+	memset(&array[handler->_arr_cap], 0, (cap - handler->_arr_cap) * sizeof(struct hmbt_cll_bucket));
+	memset(&node_elem_count[handler->_arr_cap], 0, (cap - handler->_arr_cap) * sizeof(unsigned long));
+
+	handler->array = array;
+	handler->_arr_cap = cap;
+
+	return 0;
+}
+
+/* Ends an ongoing iteration if elements of the bucket at 'index' were moved
+ * to or from a bucket on the other side of the iteration position. Buckets
+ * are only moved to and from higher indexes, so this is the case if 'index'
+ * isn't higher than the position, in either direction.
+ */
+static void _hmbt_cll_iterate_moved(struct hmbt_cll_handler *handler, ui32_t index) {
+	if (!handler->_iterating || (index > handler->_iterate_arr_pos))
+		return;
+
+	handler->_iterating = 0;
+	handler->_iterate_cancelled = 1;
+	handler->_iterate_arr_pos = ~0U;
+	handler->_iterate_cur = NULL;
+	handler->_iterate_end = NULL;
+}
+
+static int _hmbt_cll_split(struct hmbt_cll_handler *handler) {
+	struct hmbt_cll_bucket *src = NULL, *dst = NULL;
+	struct hmbt_cll_elem *pos = NULL, *next = NULL;
+	ui32_t level_size = handler->_level_size << 1, count = 0;
+
+	if ((handler->arr_size == handler->_arr_cap) && (_hmbt_cll_grow(handler, handler->_arr_cap << 1) < 0))
+		return -1;
+
+	src = &handler->array[handler->_split];
+	dst = &handler->array[handler->arr_size];
+
+	/* Redistribute the elements of the split bucket between itself and the
+	 * new bucket, preserving their relative order.
+	 */
+	lenhist_add(&handler->_lenhist, &handler->_mm, 0);
+
+	if ((pos = src->head)) {
+		count = src->count;
+
+		_hmbt_cll_untreeify(handler, src);
+
+		pos->prev->next = NULL;
+
+		src->head = NULL;
+		src->count = 0;
+
+		for (; pos; pos = next) {
+			next = pos->next;
+
+			_hmbt_cll_append(_hmbt_cll_reduce(handler, pos->hash, level_size) == handler->_split ? src : dst, pos);
+		}
+
+		_hmbt_cll_occupancy(handler, src);
+		_hmbt_cll_occupancy(handler, dst);
+
+		if (dst->count)
+			_hmbt_cll_iterate_moved(handler, handler->_split);
+
+		lenhist_move(&handler->_lenhist, &handler->_mm, count, src->count);
+		lenhist_move(&handler->_lenhist, &handler->_mm, 0, dst->count);
+
+		_hmbt_cll_tree_adjust(handler, src);
+		_hmbt_cll_tree_adjust(handler, dst);
+	}
+
+	if (++ handler->_split == handler->_level_size) {
+		handler->_level_size = level_size;
+		handler->_split = 0;
+	}
+
+	handler->arr_size ++;
+
+	handler->_stat.split ++;
+
+	return 0;
+}
+
+static void _hmbt_cll_merge(struct hmbt_cll_handler *handler) {
+	struct hmbt_cll_bucket *src = NULL, *dst = NULL;
+	struct hmbt_cll_elem *tail = NULL;
+
+	if (!handler->_split) {
+		handler->_level_size >>= 1;
+		handler->_split = handler->_level_size;
+	}
+
+	handler->_split --;
+	handler->arr_size --;
+
+	src = &handler->array[handler->arr_size];
+	dst = &handler->array[handler->_split];
+
+	/* The last bucket goes away, with its elements joining its split image */
+	lenhist_move(&handler->_lenhist, &handler->_mm, dst->count, dst->count + src->count);
+	lenhist_del(&handler->_lenhist, src->count);
+
+	/* Splice the last bucket at the tail of its split image */
+	if (src->head) {
+		_hmbt_cll_iterate_moved(handler, handler->_split);
+
+		_hmbt_cll_untreeify(handler, src);
+		_hmbt_cll_untreeify(handler, dst);
+
+		if (!dst->head) {
+			dst->head = src->head;
+		} else {
+			tail = src->head->prev;
+			dst->head->prev->next = src->head;
+			src->head->prev = dst->head->prev;
+			tail->next = dst->head;
+			dst->head->prev = tail;
+		}
+
+		dst->count += src->count;
+
+		src->head = NULL;
+		src->count = 0;
+
+		_hmbt_cll_occupancy(handler, src);
+		_hmbt_cll_occupancy(handler, dst);
+
+		_hmbt_cll_tree_adjust(handler, dst);
+	}
+
+	handler->_stat.merge ++;
+}
+
+static void _hmbt_cll_reset(struct hmbt_cll_handler *handler) {
+	/* Only empty handlers can be reset to their initial size */
+	handler->arr_size = handler->_arr_size_min;
+	handler->_level_size = handler->_arr_size_min;
+	handler->_split = 0;
+
+	lenhist_clear(&handler->_lenhist, handler->arr_size);
+
+	handler->_iterate_arr_pos = 0;
+	handler->_iterate_cur = NULL;
+	handler->_iterate_end = NULL;
+	handler->_iterate_started = 0;
+	handler->_iterating = 0;
+	handler->_iterate_cancelled = 0;
+}
+
+static int _hmbt_cll_set_mask(struct hmbt_cll_handler *handler) {
+	ui32_t size = hash_pow2_ceil(handler->_arr_size_min);
+
+	if (!size) {
+		errno = ERANGE;
+		return -1;
+	}
+
+	if ((size > handler->_arr_cap) && (_hmbt_cll_grow(handler, size) < 0))
+		return -1;
+
+	handler->_arr_size_min = size;
+
+	return 0;
+}
+
+static void _hmbt_cll_resize(struct hmbt_cll_handler *handler) {
+	int i = 0;
+
+	for (i = 0; i < HMBT_CLL_RESIZE_STEPS; i ++) {
+		if (handler->_load_max && (handler->_count > (handler->_load_max * handler->arr_size))) {
+			if (_hmbt_cll_split(handler) < 0)
+				break;
+		} else if (handler->_load_min && (handler->arr_size > handler->_arr_size_min) && (handler->_count < (handler->_load_min * handler->arr_size))) {
+			_hmbt_cll_merge(handler);
+		} else {
+			break;
+		}
+	}
+}
+
+static void _hmbt_cll_move_to_head(
+		struct hmbt_cll_bucket *bucket,
+		struct hmbt_cll_elem *elem)
+{
+	if (elem == bucket->head)
+		return;
+
+	elem->prev->next = elem->next;
+	elem->next->prev = elem->prev;
+
+	_hmbt_cll_link_before(bucket->head, elem);
+
+	bucket->head = elem;
+}
+
+static struct hmbt_cll_elem *_hmbt_cll_lookup_bucket(
+		struct hmbt_cll_handler *handler,
+		struct hmbt_cll_bucket *bucket,
+		void *data,
+		ui32_t hash,
+		int keyed)
+{
+	struct hmbt_cll_elem *start = NULL, *pos = NULL, probe;
+	struct avl_node *node = NULL;
+	int backward = 0;
+
+	if (!bucket->head)
+		return NULL;
+
+	if (bucket->tree) {
+		probe.data = data;
+		probe.hash = hash;
+
+		if (!(node = avl_find(bucket->tree, &probe, keyed ? &_hmbt_cll_tree_key_cmp : &_hmbt_cll_tree_cmp, handler)))
+			return NULL;
+
+		return ((struct hmbt_cll_tnode *) node)->elem;
+	}
+
+	/* Buckets keep no current position, so searches always start at one of
+	 * the bucket ends.
+	 */
+	backward = !(handler->_config_flags & CONFIG_SEARCH_LRU) && (handler->_config_flags & CONFIG_SEARCH_BACKWARD);
+
+	for (start = pos = backward ? bucket->head->prev : bucket->head; ; ) {
+		if ((pos->hash == hash) && !_hmbt_cll_match(handler, keyed, data, pos->data))
+			return pos;
+
+		pos = backward ? pos->prev : pos->next;
+
+		if (pos == start)
+			break;
+	}
+
+	return NULL;
+}
+
+static struct hmbt_cll_elem *_hmbt_cll_lookup(
+		struct hmbt_cll_handler *handler,
+		struct hmbt_cll_bucket *bucket,
+		void *data,
+		ui32_t hash,
+		int keyed)
+{
+	struct hmbt_cll_elem *elem = NULL;
+
+	if (!(keyed ? handler->key_compare : handler->compare))
+		return NULL;
+
+	if (handler->_bloom.counters && !bloom_test(&handler->_bloom, hash)) {
+		handler->_stat.bloom_neg ++;
+		return NULL;
+	}
+
+	if (!(elem = _hmbt_cll_lookup_bucket(handler, bucket, data, hash, keyed)) && handler->_bloom.counters)
+		handler->_stat.bloom_fp ++;
+
+	return elem;
+}
+
+static void *_hmbt_cll_unlink(
+		struct hmbt_cll_handler *handler,
+		struct hmbt_cll_bucket *bucket,
+		struct hmbt_cll_elem *elem)
+{
+	void *data = elem->data;
+
+	/* Keep any ongoing iteration consistent */
+	if (elem == handler->_iterate_cur)
+		handler->_iterate_cur = (elem == handler->_iterate_end) ? NULL : (handler->_iterate_reverse ? elem->prev : elem->next);
+
+	if (elem == handler->_iterate_end)
+		handler->_iterate_end = (elem == elem->next) ? NULL : (handler->_iterate_reverse ? elem->next : elem->prev);
+
+	if (bucket->tree)
+		_hmbt_cll_tree_del(handler, bucket, elem);
+
+	if (handler->_bloom.counters)
+		bloom_del(&handler->_bloom, elem->hash);
+
+	if (elem == elem->next) {
+		bucket->head = NULL;
+	} else {
+		elem->prev->next = elem->next;
+		elem->next->prev = elem->prev;
+
+		if (bucket->head == elem)
+			bucket->head = elem->next;
+	}
+
+	_hmbt_cll_elem_free(handler, elem);
+
+	bucket->count --;
+	handler->_count --;
+
+	lenhist_move(&handler->_lenhist, &handler->_mm, bucket->count + 1, bucket->count);
+
+	_hmbt_cll_occupancy(handler, bucket);
+	_hmbt_cll_tree_adjust(handler, bucket);
+
+	return data;
+}
+
+/* Links the node 'n' into its bucket, as configured by the insertion flags */
+static void _hmbt_cll_link(struct hmbt_cll_handler *handler, struct hmbt_cll_elem *n) {
+	struct hmbt_cll_bucket *bucket = _hmbt_cll_bucket(handler, n->hash);
+	struct hmbt_cll_elem *pos = NULL;
+
+	if (!bucket->head) {
+		n->next = n;
+		n->prev = n;
+		bucket->head = n;
+	} else if (handler->_config_flags & CONFIG_INSERT_SORTED) {
+		pos = bucket->head;
+
+		if (handler->compare(pos->data, n->data) > 0) {
+			_hmbt_cll_link_before(pos, n);
+			bucket->head = n;
+		} else {
+			do {
+				pos = pos->next;
+			} while ((pos != bucket->head) && (handler->compare(pos->data, n->data) <= 0));
+
+			_hmbt_cll_link_before(pos, n);
+		}
+	} else if (handler->_config_flags & (CONFIG_INSERT_TAIL | CONFIG_INSERT_PREV)) {
+		_hmbt_cll_link_before(bucket->head, n);
+	} else if (handler->_config_flags & CONFIG_INSERT_NEXT) {
+		_hmbt_cll_link_before(bucket->head->next, n);
+	} else {
+		_hmbt_cll_link_before(bucket->head, n);
+		bucket->head = n;
+	}
+
+	bucket->count ++;
+	handler->_count ++;
+
+	lenhist_move(&handler->_lenhist, &handler->_mm, bucket->count - 1, bucket->count);
+
+	_hmbt_cll_occupancy(handler, bucket);
+
+	if (handler->_bloom.counters)
+		bloom_add(&handler->_bloom, n->hash);
+
+	/* A bucket whose tree can't index the new element falls back to its
+	 * list until it is treeified again.
+	 */
+	if (bucket->tree && (_hmbt_cll_tree_add(handler, bucket, n) < 0))
+		_hmbt_cll_untreeify(handler, bucket);
+
+	_hmbt_cll_tree_adjust(handler, bucket);
+}
+
+static int _hmbt_cll_insert(struct hmbt_cll_handler *handler, void *data) {
+	struct hmbt_cll_elem *n = NULL;
+
+	if (!(n = _hmbt_cll_elem_alloc(handler))) {
+		handler->_stat.insert_err ++;
+		return -1;
+	}
+
+	n->data = data;
+	n->hash = _hmbt_cll_hash(handler, data);
+
+	_hmbt_cll_link(handler, n);
+
+	handler->_stat.insert ++;
+
+	if (handler->_stat.elem_count_max < handler->_count)
+		handler->_stat.elem_count_max = handler->_count;
+
+	_hmbt_cll_resize(handler);
+
+	return 0;
+}
 
-static int _hmbt_cll_insert(struct hmbt_cll_handler *handler, void *data) {
-	struct cll_handler *pool = NULL;
+static int _hmbt_cll_insert_batch(struct hmbt_cll_handler *handler, void **data, ui32_t count) {
+	struct hmbt_cll_elem *n = NULL, *next = NULL;
+	ui32_t i = 0;
+
+	if (!count)
+		return 0;
+
+	if (!(n = _hmbt_cll_chain_alloc(handler, count))) {
+		handler->_stat.insert_err += count;
+		return -1;
+	}
+
+	/* Split ahead to the final table size, so that each element is linked
+	 * straight into its final bucket instead of being redistributed later.
+	 */
+	while (handler->_load_max && ((handler->_count + count) > (handler->_load_max * handler->arr_size))) {
+		if (_hmbt_cll_split(handler) < 0)
+			break;
+	}
+
+	for (i = 0; i < count; i ++, n = next) {
+		next = n->next;
+
+		n->data = data[i];
+		n->hash = _hmbt_cll_hash(handler, data[i]);
+
+		_hmbt_cll_link(handler, n);
+	}
+
+	handler->_stat.insert += count;
 
-	pool = handler->array[handler->hash(data) % handler->arr_size];
+	if (handler->_stat.elem_count_max < handler->_count)
+		handler->_stat.elem_count_max = handler->_count;
 
-	return pool->insert(pool, data);
+	_hmbt_cll_resize(handler);
+
+	return 0;
+}
+
+static int _hmbt_cll_delete_match(struct hmbt_cll_handler *handler, void *data, ui32_t hash, int keyed) {
+	struct hmbt_cll_bucket *bucket = _hmbt_cll_bucket(handler, hash);
+	struct hmbt_cll_elem *elem = NULL;
+
+	if (!(elem = _hmbt_cll_lookup(handler, bucket, data, hash, keyed))) {
+		handler->_stat.del_nf ++;
+		return -1;
+	}
+
+	handler->destroy(_hmbt_cll_unlink(handler, bucket, elem));
+
+	handler->_stat.del ++;
+
+	_hmbt_cll_resize(handler);
+
+	return 0;
 }
 
 static int _hmbt_cll_delete(struct hmbt_cll_handler *handler, void *data) {
-	struct cll_handler *pool = NULL;
+	return _hmbt_cll_delete_match(handler, data, _hmbt_cll_hash(handler, data), 0);
+}
+
+static int _hmbt_cll_delete_key(struct hmbt_cll_handler *handler, void *key) {
+	return _hmbt_cll_delete_match(handler, key, _hmbt_cll_key_hash(handler, key), 1);
+}
+
+static void *_hmbt_cll_search_bucket(
+		struct hmbt_cll_handler *handler,
+		struct hmbt_cll_bucket *bucket,
+		void *data,
+		ui32_t hash,
+		int keyed)
+{
+	struct hmbt_cll_elem *elem = NULL;
+
+	if (!(elem = _hmbt_cll_lookup(handler, bucket, data, hash, keyed))) {
+		handler->_stat.search_nf ++;
+		return NULL;
+	}
+
+	if (handler->_config_flags & CONFIG_SEARCH_LRU)
+		_hmbt_cll_move_to_head(bucket, elem);
 
-	pool = handler->array[handler->hash(data) % handler->arr_size];
+	handler->_stat.search ++;
 
-	return pool->del(pool, data);
+	return elem->data;
 }
 
 static void *_hmbt_cll_search(struct hmbt_cll_handler *handler, void *data) {
-	struct cll_handler *pool = NULL;
+	ui32_t hash = _hmbt_cll_hash(handler, data);
+
+	return _hmbt_cll_search_bucket(handler, _hmbt_cll_bucket(handler, hash), data, hash, 0);
+}
 
-	pool = handler->array[handler->hash(data) % handler->arr_size];
+static void *_hmbt_cll_search_key(struct hmbt_cll_handler *handler, void *key) {
+	ui32_t hash = _hmbt_cll_key_hash(handler, key);
 
-	return pool->search(pool, data);
+	return _hmbt_cll_search_bucket(handler, _hmbt_cll_bucket(handler, hash), key, hash, 1);
 }
 
-static ui32_t _hmbt_cll_count(struct hmbt_cll_handler *handler) {
-	unsigned long i = 0;
-	ui32_t count = 0;
-	struct cll_handler *pool = NULL;
+static ui32_t _hmbt_cll_search_batch(struct hmbt_cll_handler *handler, void **keys, void **results, ui32_t n) {
+	struct hmbt_cll_bucket *buckets[HMBT_CLL_BATCH_SIZE];
+	ui32_t hashes[HMBT_CLL_BATCH_SIZE];
+	ui32_t i = 0, j = 0, len = 0, found = 0;
 
-	for (i = 0; i < handler->arr_size; i ++) {
-		pool = handler->array[i];
+	for (i = 0; i < n; i += len) {
+		len = ((n - i) < HMBT_CLL_BATCH_SIZE) ? (n - i) : HMBT_CLL_BATCH_SIZE;
+
+		for (j = 0; j < len; j ++) {
+			hashes[j] = _hmbt_cll_hash(handler, keys[i + j]);
+			buckets[j] = _hmbt_cll_bucket(handler, hashes[j]);
+
+			mm_prefetch(buckets[j]);
+
+			if (handler->_bloom.counters)
+				bloom_prefetch(&handler->_bloom, hashes[j]);
+		}
+
+		/* By now the first buckets of the group should be cached */
+		for (j = 0; j < len; j ++)
+			mm_prefetch(buckets[j]->head);
 
-		count += pool->count(pool);
+		for (j = 0; j < len; j ++) {
+			if ((results[i + j] = _hmbt_cll_search_bucket(handler, buckets[j], keys[i + j], hashes[j], 0)))
+				found ++;
+		}
 	}
 
+	return found;
+}
+
+static ui32_t _hmbt_cll_count(struct hmbt_cll_handler *handler) {
 	handler->_stat.count ++;
 
-	return count;
+	return handler->_count;
 }
 
 static int _hmbt_cll_serialize(struct hmbt_cll_handler *handler, pall_fd_t fd) {
 	unsigned long i = 0;
-	struct cll_handler *pool = NULL;
+	struct hmbt_cll_elem *pos = NULL;
 	ui32_t arr_size_nbo = pall_htonl(handler->arr_size);
+	ui32_t count_nbo = 0;
 
 	if (!handler->ser_data) {
 		handler->_stat.serialize_err ++;
@@ -91,13 +833,26 @@ static int _hmbt_cll_serialize(struct hmbt_cll_handler *handler, pall_fd_t fd) {
 		return -1;
 	}
 
+	/* Each bucket is written as a serialized Circular Linked List: the
+	 * element count followed by the elements, starting at the bucket head.
+	 */
 	for (i = 0; i < handler->arr_size; i ++) {
-		pool = handler->array[i];
+		count_nbo = pall_htonl(handler->array[i].count);
 
-		if (pool->serialize(pool, fd) < 0) {
+		if (pall_write(fd, &count_nbo, 4) != 4) {
 			handler->_stat.serialize_err ++;
 			return -1;
 		}
+
+		if (!(pos = handler->array[i].head))
+			continue;
+
+		do {
+			if (handler->ser_data(fd, pos->data) < 0) {
+				handler->_stat.serialize_err ++;
+				return -1;
+			}
+		} while ((pos = pos->next) != handler->array[i].head);
 	}
 
 	handler->_stat.serialize ++;
@@ -109,8 +864,8 @@ static int _hmbt_cll_unserialize(
 		struct hmbt_cll_handler *handler,
 		pall_fd_t fd)
 {
-	unsigned long i = 0;
-	struct cll_handler *pool = NULL;
+	ui32_t arr_size = 0, count = 0;
+	void *data = NULL;
 
 	if (!handler->unser_data) {
 		handler->_stat.unserialize_err ++;
@@ -118,20 +873,31 @@ static int _hmbt_cll_unserialize(
 		return -1;
 	}
 
-	if (pall_read(fd, &handler->arr_size, 4) != 4) {
+	if (pall_read(fd, &arr_size, 4) != 4) {
 		handler->_stat.unserialize_err ++;
 		return -1;
 	}
 
-	handler->arr_size = ntohl(handler->arr_size);
-
-	for (i = 0; i < handler->arr_size; i ++) {
-		pool = handler->array[i];
-
-		if (pool->unserialize(pool, fd) < 0) {
+	/* Elements are rehashed on insertion, so the serialized array size
+	 * doesn't need to match the size of this handler.
+	 */
+	for (arr_size = ntohl(arr_size); arr_size; arr_size --) {
+		if (pall_read(fd, &count, 4) != 4) {
 			handler->_stat.unserialize_err ++;
 			return -1;
 		}
+
+		for (count = ntohl(count); count; count --) {
+			if (!(data = handler->unser_data(fd))) {
+				handler->_stat.unserialize_err ++;
+				return -1;
+			}
+
+			if (handler->insert(handler, data) < 0) {
+				handler->_stat.unserialize_err ++;
+				return -1;
+			}
+		}
 	}
 
 	handler->_stat.unserialize ++;
@@ -141,180 +907,254 @@ static int _hmbt_cll_unserialize(
 
 static struct hmbt_cll_stat *_hmbt_cll_stat(struct hmbt_cll_handler *handler) {
 	unsigned long i = 0;
-	struct cll_handler *pool = NULL;
-
-	handler->_stat.insert = 0;
-	handler->_stat.insert_err = 0;
-	handler->_stat.del = 0;
-	handler->_stat.del_nf = 0;
-	handler->_stat.search = 0;
-	handler->_stat.search_nf = 0;
-	handler->_stat.pope = 0;
-	handler->_stat.pope_nf = 0;
-	handler->_stat.elem_count_cur = 0;
-	handler->_stat.elem_count_max = 0;
-	handler->_stat.node_elem_count_min = ~0UL;
-	handler->_stat.node_elem_count_avg = 0;
-	handler->_stat.node_elem_count_max = 0;
-
-	memset(handler->_stat.node_elem_count, 0, handler->arr_size * sizeof(unsigned long));
-	
-	for (i = 0; i < handler->arr_size; i ++) {
-		pool = handler->array[i];
+	unsigned long *node_elem_count = handler->_stat.node_elem_count;
+	int rebuild = handler->_lenhist.stale;
+
+	handler->_stat.elem_count_cur = handler->_count;
 
-		handler->_stat.insert += pool->stat(pool)->insert;
-		handler->_stat.insert_err += pool->stat(pool)->insert_err;
-		handler->_stat.del += pool->stat(pool)->del;
-		handler->_stat.del_nf += pool->stat(pool)->del_nf;
-		handler->_stat.search += pool->stat(pool)->search;
-		handler->_stat.search_nf += pool->stat(pool)->search_nf;
-		handler->_stat.pope += pool->stat(pool)->pope;
-		handler->_stat.pope_nf += pool->stat(pool)->pope_nf;
-		handler->_stat.elem_count_cur += pool->stat(pool)->elem_count_cur;
-		handler->_stat.elem_count_max += pool->stat(pool)->elem_count_max;
-		handler->_stat.node_elem_count[i] = pool->count(pool);
+	/* Aggregate counters, including the shortest and longest bucket lengths,
+	 * are kept on every operation. Only the per node distribution requires a
+	 * pass over the array, which also rebuilds a bucket length histogram that
+	 * failed to grow.
+	 */
+	if (!(handler->_config_flags & CONFIG_STAT_INCREMENTAL) || rebuild) {
+		handler->_stat.node_elem_count_min = ~0UL;
+		handler->_stat.node_elem_count_max = 0;
 
-		if (handler->_stat.node_elem_count[i] < handler->_stat.node_elem_count_min)
-			handler->_stat.node_elem_count_min = handler->_stat.node_elem_count[i];
+		if (rebuild)
+			lenhist_clear(&handler->_lenhist, 0);
 
-		if (handler->_stat.node_elem_count[i] > handler->_stat.node_elem_count_max)
-			handler->_stat.node_elem_count_max = handler->_stat.node_elem_count[i];
+		for (i = 0; i < handler->arr_size; i ++) {
+			node_elem_count[i] = handler->array[i].count;
+
+			if (node_elem_count[i] < handler->_stat.node_elem_count_min)
+				handler->_stat.node_elem_count_min = node_elem_count[i];
+
+			if (node_elem_count[i] > handler->_stat.node_elem_count_max)
+				handler->_stat.node_elem_count_max = node_elem_count[i];
+
+			if (rebuild)
+				lenhist_add(&handler->_lenhist, &handler->_mm, handler->array[i].count);
+		}
+	} else {
+		handler->_stat.node_elem_count_min = handler->_lenhist.min;
+		handler->_stat.node_elem_count_max = handler->_lenhist.max;
 	}
 
 	handler->_stat.node_elem_count_avg = handler->_stat.elem_count_cur / (float) handler->arr_size;
 
+	if (handler->_stat.bloom_fp || handler->_stat.bloom_neg)
+		handler->_stat.bloom_fp_rate = handler->_stat.bloom_fp / (float) (handler->_stat.bloom_fp + handler->_stat.bloom_neg);
+
 	handler->_stat.stat ++;
 
 	return &handler->_stat;
 }
 
 static void _hmbt_cll_stat_reset(struct hmbt_cll_handler *handler) {
-	unsigned int i = 0;
 	unsigned long *ptr = handler->_stat.node_elem_count;
-	struct cll_handler *pool = NULL;
 
 	memset(&handler->_stat, 0, sizeof(struct hmbt_cll_stat));
 
 	memset(ptr, 0, handler->arr_size * sizeof(unsigned long));
 
-	for (i = 0; i < handler->arr_size; i ++) {
-		pool = handler->array[i];
+	handler->_stat.node_elem_count = ptr;
+}
+
+static void *_hmbt_cll_pope_match(struct hmbt_cll_handler *handler, void *data, ui32_t hash, int keyed) {
+	struct hmbt_cll_bucket *bucket = _hmbt_cll_bucket(handler, hash);
+	struct hmbt_cll_elem *elem = NULL;
+	void *d = NULL;
 
-		pool->stat_reset(pool);
+	if (!(elem = _hmbt_cll_lookup(handler, bucket, data, hash, keyed))) {
+		handler->_stat.pope_nf ++;
+		return NULL;
 	}
 
-	handler->_stat.node_elem_count = ptr;
+	handler->_stat.pope ++;
+
+	d = _hmbt_cll_unlink(handler, bucket, elem);
+
+	_hmbt_cll_resize(handler);
+
+	return d;
 }
 
 static void *_hmbt_cll_pope(struct hmbt_cll_handler *handler, void *data) {
-	struct cll_handler *pool = NULL;
-
-	pool = handler->array[handler->hash(data) % handler->arr_size];
+	return _hmbt_cll_pope_match(handler, data, _hmbt_cll_hash(handler, data), 0);
+}
 
-	return pool->pope(pool, data);
+static void *_hmbt_cll_pope_key(struct hmbt_cll_handler *handler, void *key) {
+	return _hmbt_cll_pope_match(handler, key, _hmbt_cll_key_hash(handler, key), 1);
 }
 
 static void *_hmbt_cll_poph_elem(struct hmbt_cll_handler *handler, void *data) {
-	struct cll_handler *pool = NULL;
+	struct hmbt_cll_bucket *bucket = NULL;
 	void *d = NULL;
 
-	pool = handler->array[handler->hash(data) % handler->arr_size];
+	bucket = _hmbt_cll_bucket(handler, _hmbt_cll_hash(handler, data));
 
-	if (!(d = pool->poph(pool)))
+	if (!bucket->head) {
 		handler->_stat.poph_elem_nf ++;
-	else
-		handler->_stat.poph_elem ++;
+		return NULL;
+	}
+
+	handler->_stat.poph_elem ++;
+
+	d = _hmbt_cll_unlink(handler, bucket, bucket->head);
+
+	_hmbt_cll_resize(handler);
 
 	return d;
 }
 
 static void *_hmbt_cll_poph_index(struct hmbt_cll_handler *handler, ui32_t index) {
-	struct cll_handler *pool = NULL;
+	struct hmbt_cll_bucket *bucket = NULL;
 	void *d = NULL;
 
-	pool = handler->array[index];
-
-	if (!(d = pool->poph(pool)))
+	if ((index >= handler->arr_size) || !(bucket = &handler->array[index])->head) {
 		handler->_stat.poph_index_nf ++;
-	else
-		handler->_stat.poph_index ++;
+		return NULL;
+	}
+
+	handler->_stat.poph_index ++;
+
+	d = _hmbt_cll_unlink(handler, bucket, bucket->head);
+
+	_hmbt_cll_resize(handler);
 
 	return d;
 }
 
-
 static void _hmbt_cll_collapse(struct hmbt_cll_handler *handler) {
 	ui32_t i = 0;
-	struct cll_handler *pool = NULL;
+	struct hmbt_cll_elem *pos = NULL, *ptr = NULL;
 
-	for (i = 0; i < handler->arr_size; i ++) {
-		pool = handler->array[i];
+	for (i = bitmap_next(handler->_occupied, handler->arr_size, 0); i < handler->arr_size; i = bitmap_next(handler->_occupied, handler->arr_size, i + 1)) {
+		avl_destroy(&handler->array[i].tree, &_hmbt_cll_tree_release, handler);
 
-		pool->collapse(pool);
+		pos = handler->array[i].head;
+		pos->prev->next = NULL;
+
+		for (; pos; pos = ptr) {
+			ptr = pos->next;
+			handler->destroy(pos->data);
+
+			/* Pooled nodes are released all at once, along with the pool */
+			if (!handler->_pool.size)
+				mm_free_with(&handler->_mm, pos);
+		}
+
+		handler->array[i].head = NULL;
+		handler->array[i].count = 0;
 	}
 
+	memset(handler->_occupied, 0, bitmap_words(handler->_arr_cap) * sizeof(unsigned long));
+
+	bloom_clear(&handler->_bloom);
+
+	if (handler->_pool.size)
+		mm_pool_release(&handler->_pool);
+
+	/* An empty HMBT-CLL goes back to its initial size */
+	_hmbt_cll_reset(handler);
+
 	handler->_stat.collapse ++;
+	handler->_count = 0;
 }
 
 static void *_hmbt_cll_iterate(struct hmbt_cll_handler *handler) {
-	void *data = NULL;
-	struct cll_handler *pool = NULL;
+	struct hmbt_cll_bucket *bucket = NULL;
+	struct hmbt_cll_elem *ptr = NULL;
 
-	for (;;) {
-		pool = handler->array[handler->_iterate_arr_pos];
+	/* A split or merge across the iteration position ended it */
+	if (handler->_iterate_cancelled) {
+		handler->_iterate_cancelled = 0;
+		handler->_stat.iterate ++;
+		errno = ECANCELED;
+		return NULL;
+	}
 
-		if ((data = pool->iterate(pool)))
-			break;
+	/* The first position is only taken now, as the array may have been
+	 * resized since the rewind.
+	 */
+	if (!handler->_iterate_started) {
+		handler->_iterate_arr_pos = handler->_iterate_reverse ? (handler->arr_size - 1) : 0;
+		handler->_iterate_started = 1;
+	}
 
-		if (handler->_iterate_reverse) {
-			if (!handler->_iterate_arr_pos)
-				break;
+	while (handler->_iterate_arr_pos < handler->arr_size) {
+		bucket = &handler->array[handler->_iterate_arr_pos];
+
+		/* Start iterating the current bucket */
+		if (!handler->_iterate_end && bucket->head) {
+			if (handler->_iterate_reverse) {
+				handler->_iterate_cur = bucket->head->prev;
+				handler->_iterate_end = bucket->head;
+			} else {
+				handler->_iterate_cur = bucket->head;
+				handler->_iterate_end = bucket->head->prev;
+			}
+		}
 
-			handler->_iterate_arr_pos --;
-		} else {
-			handler->_iterate_arr_pos ++;
+		if ((ptr = handler->_iterate_cur)) {
+			if (ptr == handler->_iterate_end) {
+				handler->_iterate_cur = NULL;
+			} else {
+				handler->_iterate_cur = handler->_iterate_reverse ? ptr->prev : ptr->next;
+			}
 
-			if (handler->_iterate_arr_pos >= handler->arr_size)
-				break;
+			handler->_iterating = 1;
+
+			return ptr->data;
+		}
+
+		/* Move on to the next non-empty bucket. Reverse iterations end
+		 * past the last bucket as well.
+		 */
+		handler->_iterate_end = NULL;
+
+		if (handler->_iterate_reverse) {
+			handler->_iterate_arr_pos = handler->_iterate_arr_pos ? bitmap_prev(handler->_occupied, handler->arr_size, handler->_iterate_arr_pos - 1) : handler->arr_size;
+		} else {
+			handler->_iterate_arr_pos = bitmap_next(handler->_occupied, handler->arr_size, handler->_iterate_arr_pos + 1);
 		}
 	}
 
-	if (!data)
-		handler->_stat.iterate ++;
+	/* Ended iterations stay past the end as the array grows */
+	handler->_iterate_arr_pos = ~0U;
+	handler->_iterating = 0;
 
-	return data;
+	handler->_stat.iterate ++;
+
+	return NULL;
 }
 
 static void _hmbt_cll_rewind(struct hmbt_cll_handler *handler, int to) {
-	unsigned long i = 0;
-	struct cll_handler *pool = NULL;
-
 	handler->_iterate_reverse = to;
-
-	for (i = 0; i < handler->arr_size; i ++) {
-		pool = handler->array[i];
-		pool->rewind(pool, to);
-	}
-
-	if (to) {
-		handler->_iterate_arr_pos = handler->arr_size - 1;
-	} else {
-		handler->_iterate_arr_pos = 0;
-	}
+	handler->_iterate_cur = NULL;
+	handler->_iterate_end = NULL;
+	handler->_iterate_started = 0;
+	handler->_iterating = 0;
+	handler->_iterate_cancelled = 0;
 
 	handler->_stat.rewind ++;
 }
 
 static ui32_t _hmbt_cll_set_config(struct hmbt_cll_handler *handler, ui32_t flags) {
-	ui32_t old_flags = flags;
-	unsigned long i = 0;
-	struct cll_handler *pool = NULL;
+	ui32_t old_flags = handler->_config_flags;
 
-	for (i = 0; i < handler->arr_size; i ++) {
-		pool = handler->array[i];
-		pool->set_config(pool, flags);
+	/* Switching the index selection mode requires an empty array */
+	if ((flags ^ old_flags) & CONFIG_HASH_MASK) {
+		if (handler->_count || ((flags & CONFIG_HASH_MASK) && (_hmbt_cll_set_mask(handler) < 0))) {
+			flags ^= CONFIG_HASH_MASK;
+		} else {
+			_hmbt_cll_reset(handler);
+		}
 	}
 
+	handler->_config_flags = flags;
+
 	handler->_stat.set_config ++;
 
 	return old_flags;
@@ -323,40 +1163,130 @@ static ui32_t _hmbt_cll_set_config(struct hmbt_cll_handler *handler, ui32_t flag
 static ui32_t _hmbt_cll_get_config(struct hmbt_cll_handler *handler) {
 	handler->_stat.get_config ++;
 
-	return handler->array[0]->get_config(handler->array[0]);
+	return handler->_config_flags;
+}
+
+static int _hmbt_cll_set_load_factor(struct hmbt_cll_handler *handler, float max, float min) {
+	if ((max < 0) || (min < 0) || (max && (min >= (max / 2)))) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	handler->_load_max = max;
+	handler->_load_min = min;
+
+	_hmbt_cll_resize(handler);
+
+	return 0;
+}
+
+static int _hmbt_cll_set_treeify(struct hmbt_cll_handler *handler, ui32_t max, ui32_t min) {
+	ui32_t i = 0;
+
+	if (max && (min >= max)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	handler->_treeify_max = max;
+	handler->_treeify_min = min;
+
+	for (i = bitmap_next(handler->_occupied, handler->arr_size, 0); i < handler->arr_size; i = bitmap_next(handler->_occupied, handler->arr_size, i + 1))
+		_hmbt_cll_tree_adjust(handler, &handler->array[i]);
+
+	return 0;
+}
+
+static int _hmbt_cll_set_key(
+		struct hmbt_cll_handler *handler,
+		void *(*key) (void *data),
+		int (*key_compare) (const void *k1, const void *k2),
+		ui32_t (*key_hash) (void *key))
+{
+	if ((!key != !key_compare) || (!key != !key_hash)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* Without a key extractor, elements are their own keys */
+	handler->key = key ? key : &_hmbt_cll_key_self;
+	handler->key_compare = key ? key_compare : handler->compare;
+	handler->key_hash = key ? key_hash : handler->hash;
+
+	return 0;
+}
+
+static int _hmbt_cll_set_bloom(struct hmbt_cll_handler *handler, ui32_t capacity, ui32_t bits) {
+	ui32_t i = 0;
+	struct bloom bloom;
+	struct hmbt_cll_elem *pos = NULL;
+
+	if (!capacity) {
+		bloom_release(&handler->_bloom, &handler->_mm);
+		return 0;
+	}
+
+	if (bloom_init(&bloom, &handler->_mm, capacity, bits ? bits : HMBT_CLL_BLOOM_BITS) < 0)
+		return -1;
+
+	for (i = bitmap_next(handler->_occupied, handler->arr_size, 0); i < handler->arr_size; i = bitmap_next(handler->_occupied, handler->arr_size, i + 1)) {
+		pos = handler->array[i].head;
+
+		do {
+			bloom_add(&bloom, pos->hash);
+		} while ((pos = pos->next) != handler->array[i].head);
+	}
+
+	bloom_release(&handler->_bloom, &handler->_mm);
+
+	memcpy(&handler->_bloom, &bloom, sizeof(struct bloom));
+
+	return 0;
 }
 
 #ifdef COMPILE_WIN32
 DLLIMPORT
 #endif
-struct hmbt_cll_handler *pall_hmbt_cll_init(
+struct hmbt_cll_handler *pall_hmbt_cll_init_mm(
 		int (*compare) (const void *d1, const void *d2),
 		void (*destroy) (void *data),
 		ui32_t (*hash) (void *data),
 		int (*ser_data) (pall_fd_t fd, void *data),
 		void *(*unser_data) (pall_fd_t fd),
-		unsigned int array_size)
+		unsigned int array_size,
+		const struct pall_mm *mm)
 {
 	int errsv = 0;
-	long i = 0;
 	struct hmbt_cll_handler *handler = NULL;
+	struct pall_mm hmm;
 
-	if (!hash || !destroy) {
+	if (!hash || !destroy || (mm && (!mm->alloc || !mm->free))) {
 		errno = EINVAL;
 		return NULL;
 	}
 
-	if (!(handler = (struct hmbt_cll_handler *) mm_alloc(sizeof(struct hmbt_cll_handler))))
+	mm_copy(&hmm, mm);
+
+	if (!(handler = (struct hmbt_cll_handler *) mm_alloc_with(&hmm, sizeof(struct hmbt_cll_handler))))
 		return NULL;
 
 	memset(handler, 0, sizeof(struct hmbt_cll_handler));
 
+	memcpy(&handler->_mm, &hmm, sizeof(struct pall_mm));
+
 	handler->arr_size = array_size ? array_size : HMBT_CLL_DEFAULT_ARR_SIZE;
+	handler->_arr_size_min = handler->arr_size;
+	handler->_arr_cap = handler->arr_size;
+	handler->_level_size = handler->arr_size;
+	handler->_split = 0;
+	handler->_treeify_max = HMBT_CLL_TREEIFY_MAX;
+	handler->_treeify_min = HMBT_CLL_TREEIFY_MIN;
 	handler->_iterate_arr_pos = 0;
+	handler->_config_flags = CONFIG_SEARCH_LRU | CONFIG_INSERT_HEAD | CONFIG_MM_POOL;
 
-	if (!(handler->_stat.node_elem_count = (unsigned long *) mm_alloc(handler->arr_size * sizeof(unsigned long)))) {
+	if (!(handler->_stat.node_elem_count = (unsigned long *) mm_calloc_with(&hmm, handler->arr_size, sizeof(unsigned long)))) {
 		errsv = errno;
-		mm_free(handler);
+		mm_free_with(&hmm, handler);
 		errno = errsv;
 		return NULL;
 	}
@@ -366,16 +1296,24 @@ struct hmbt_cll_handler *pall_hmbt_cll_init(
 	handler->destroy = destroy;
 	handler->ser_data = ser_data;
 	handler->unser_data = unser_data;
+	handler->key = &_hmbt_cll_key_self;
+	handler->key_compare = compare;
+	handler->key_hash = hash;
 
 	handler->insert = &_hmbt_cll_insert;
+	handler->insert_batch = &_hmbt_cll_insert_batch;
 	handler->del = &_hmbt_cll_delete;
+	handler->del_key = &_hmbt_cll_delete_key;
 	handler->search = &_hmbt_cll_search;
+	handler->search_key = &_hmbt_cll_search_key;
+	handler->search_batch = &_hmbt_cll_search_batch;
 	handler->serialize = &_hmbt_cll_serialize;
 	handler->unserialize = &_hmbt_cll_unserialize;
 	handler->stat = &_hmbt_cll_stat;
 	handler->stat_reset = &_hmbt_cll_stat_reset;
 	handler->count = &_hmbt_cll_count;
 	handler->pope = &_hmbt_cll_pope;
+	handler->pope_key = &_hmbt_cll_pope_key;
 	handler->poph_elem = &_hmbt_cll_poph_elem;
 	handler->poph_index = &_hmbt_cll_poph_index;
 	handler->collapse = &_hmbt_cll_collapse;
@@ -383,43 +1321,72 @@ struct hmbt_cll_handler *pall_hmbt_cll_init(
 	handler->rewind = &_hmbt_cll_rewind;
 	handler->set_config = &_hmbt_cll_set_config;
 	handler->get_config = &_hmbt_cll_get_config;
+	handler->set_load_factor = &_hmbt_cll_set_load_factor;
+	handler->set_treeify = &_hmbt_cll_set_treeify;
+	handler->set_bloom = &_hmbt_cll_set_bloom;
+	handler->set_key = &_hmbt_cll_set_key;
 
-	if (!(handler->array = (struct cll_handler **) mm_alloc(sizeof(struct cll_handler *) * handler->arr_size))) {
+	if (!(handler->array = (struct hmbt_cll_bucket *) mm_calloc_with(&hmm, handler->arr_size, sizeof(struct hmbt_cll_bucket)))) {
 		errsv = errno;
-		mm_free(handler);
+		mm_free_with(&hmm, handler->_stat.node_elem_count);
+		mm_free_with(&hmm, handler);
 		errno = errsv;
 		return NULL;
 	}
 
-	for (i = 0; ((unsigned) i) < handler->arr_size; i ++) {
-		if (!(handler->array[i] = pall_cll_init(compare, destroy, ser_data, unser_data))) {
-			errsv = errno;
-			for (-- i; i >= 0; i --)
-				pall_cll_destroy(handler->array[i]);
-			mm_free(handler->array);
-			mm_free(handler);
-			errno = errsv;
-			return NULL;
-		}
+	if (!(handler->_occupied = (unsigned long *) mm_calloc_with(&hmm, bitmap_words(handler->arr_size), sizeof(unsigned long)))) {
+		errsv = errno;
+		mm_free_with(&hmm, handler->array);
+		mm_free_with(&hmm, handler->_stat.node_elem_count);
+		mm_free_with(&hmm, handler);
+		errno = errsv;
+		return NULL;
+	}
+
+	if (lenhist_init(&handler->_lenhist, &hmm, handler->arr_size) < 0) {
+		errsv = errno;
+		mm_free_with(&hmm, handler->_occupied);
+		mm_free_with(&hmm, handler->array);
+		mm_free_with(&hmm, handler->_stat.node_elem_count);
+		mm_free_with(&hmm, handler);
+		errno = errsv;
+		return NULL;
 	}
 
 	return handler;
 }
 
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct hmbt_cll_handler *pall_hmbt_cll_init(
+		int (*compare) (const void *d1, const void *d2),
+		void (*destroy) (void *data),
+		ui32_t (*hash) (void *data),
+		int (*ser_data) (pall_fd_t fd, void *data),
+		void *(*unser_data) (pall_fd_t fd),
+		unsigned int array_size)
+{
+	return pall_hmbt_cll_init_mm(compare, destroy, hash, ser_data, unser_data, array_size, NULL);
+}
+
 #ifdef COMPILE_WIN32
 DLLIMPORT
 #endif
 void pall_hmbt_cll_destroy(struct hmbt_cll_handler *h) {
-	ui32_t i = 0;
+	struct pall_mm hmm;
 
 	h->collapse(h);
 
-	for (i = 0; i < h->arr_size; i ++)
-		pall_cll_destroy(h->array[i]);
+	memcpy(&hmm, &h->_mm, sizeof(struct pall_mm));
+
+	bloom_release(&h->_bloom, &hmm);
+	lenhist_release(&h->_lenhist, &hmm);
 
-	mm_free(h->array);
-	mm_free(h->_stat.node_elem_count);
-	mm_free(h);
+	mm_free_with(&hmm, h->array);
+	mm_free_with(&hmm, h->_occupied);
+	mm_free_with(&hmm, h->_stat.node_elem_count);
+	mm_free_with(&hmm, h);
 }
 
 #ifdef COMPILE_WIN32
@@ -429,6 +1396,13 @@ int pall_hmbt_cll_insert(struct hmbt_cll_handler *h, void *data) {
 	return h->insert(h, data);
 }
 
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_hmbt_cll_insert_batch(struct hmbt_cll_handler *h, void **data, ui32_t count) {
+	return h->insert_batch(h, data, count);
+}
+
 #ifdef COMPILE_WIN32
 DLLIMPORT
 #endif
@@ -436,6 +1410,13 @@ int pall_hmbt_cll_delete(struct hmbt_cll_handler *h, void *data) {
 	return h->del(h, data);
 }
 
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_hmbt_cll_delete_key(struct hmbt_cll_handler *h, void *key) {
+	return h->del_key(h, key);
+}
+
 #ifdef COMPILE_WIN32
 DLLIMPORT
 #endif
@@ -443,6 +1424,20 @@ void *pall_hmbt_cll_search(struct hmbt_cll_handler *h, void *data) {
 	return h->search(h, data);
 }
 
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_hmbt_cll_search_key(struct hmbt_cll_handler *h, void *key) {
+	return h->search_key(h, key);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_hmbt_cll_search_batch(struct hmbt_cll_handler *h, void **keys, void **results, ui32_t n) {
+	return h->search_batch(h, keys, results, n);
+}
+
 #ifdef COMPILE_WIN32
 DLLIMPORT
 #endif
@@ -485,6 +1480,13 @@ void *pall_hmbt_cll_pope(struct hmbt_cll_handler *h, void *data) {
 	return h->pope(h, data);
 }
 
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_hmbt_cll_pope_key(struct hmbt_cll_handler *h, void *key) {
+	return h->pope_key(h, key);
+}
+
 #ifdef COMPILE_WIN32
 DLLIMPORT
 #endif
@@ -534,3 +1536,36 @@ ui32_t pall_hmbt_cll_get_config(struct hmbt_cll_handler *h) {
 	return h->get_config(h);
 }
 
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_hmbt_cll_set_load_factor(struct hmbt_cll_handler *h, float max, float min) {
+	return h->set_load_factor(h, max, min);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_hmbt_cll_set_treeify(struct hmbt_cll_handler *h, ui32_t max, ui32_t min) {
+	return h->set_treeify(h, max, min);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_hmbt_cll_set_bloom(struct hmbt_cll_handler *h, ui32_t capacity, ui32_t bits) {
+	return h->set_bloom(h, capacity, bits);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_hmbt_cll_set_key(
+		struct hmbt_cll_handler *h,
+		void *(*key) (void *data),
+		int (*key_compare) (const void *k1, const void *k2),
+		ui32_t (*key_hash) (void *key))
+{
+	return h->set_key(h, key, key_compare, key_hash);
+}
+
@@ -39,6 +39,10 @@ static int _lifo_push(struct lifo_handler *handler, void *data) {
 	return handler->lifo->insert(handler->lifo, data);
 }
 
+static int _lifo_push_batch(struct lifo_handler *handler, void **data, ui32_t count) {
+	return handler->lifo->insert_batch(handler->lifo, data, count);
+}
+
 static void *_lifo_pop(struct lifo_handler *handler) {
 	return handler->lifo->poph(handler->lifo);
 }
@@ -95,33 +99,45 @@ static void _lifo_rewind(struct lifo_handler *handler, int to) {
 #ifdef COMPILE_WIN32
 DLLIMPORT
 #endif
-struct lifo_handler *pall_lifo_init(
+struct lifo_handler *pall_lifo_init_mm(
 		void (*destroy) (void *data),
 		int (*ser_data) (pall_fd_t fd, void *data),
-		void *(*unser_data) (pall_fd_t fd))
+		void *(*unser_data) (pall_fd_t fd),
+		const struct pall_mm *mm)
 {
+	int errsv = 0;
 	struct lifo_handler *handler = NULL;
+	struct pall_mm hmm;
 
-	if (!destroy) {
+	if (!destroy || (mm && (!mm->alloc || !mm->free))) {
 		errno = EINVAL;
 		return NULL;
 	}
 
-	if (!(handler = (struct lifo_handler *) mm_alloc(sizeof(struct lifo_handler))))
+	mm_copy(&hmm, mm);
+
+	if (!(handler = (struct lifo_handler *) mm_alloc_with(&hmm, sizeof(struct lifo_handler))))
 		return NULL;
 
 	memset(handler, 0, sizeof(struct lifo_handler));
 
-	if (!(handler->lifo = pall_cll_init(NULL, destroy, ser_data, unser_data)))
+	memcpy(&handler->_mm, &hmm, sizeof(struct pall_mm));
+
+	if (!(handler->lifo = pall_cll_init_mm(NULL, destroy, ser_data, unser_data, &hmm))) {
+		errsv = errno;
+		mm_free_with(&hmm, handler);
+		errno = errsv;
 		return NULL;
+	}
 
-	handler->lifo->set_config(handler->lifo, CONFIG_INSERT_HEAD);
+	handler->lifo->set_config(handler->lifo, CONFIG_INSERT_HEAD | CONFIG_MM_POOL);
 
 	handler->destroy = destroy;
 	handler->ser_data = ser_data;
 	handler->unser_data = unser_data;
 
 	handler->push = &_lifo_push;
+	handler->push_batch = &_lifo_push_batch;
 	handler->pop = &_lifo_pop;
 	handler->serialize = &_lifo_serialize;
 	handler->unserialize = &_lifo_unserialize;
@@ -139,11 +155,26 @@ struct lifo_handler *pall_lifo_init(
 DLLIMPORT
 #endif
 void pall_lifo_destroy(struct lifo_handler *handler) {
+	struct pall_mm hmm;
+
 	handler->collapse(handler);
 
 	pall_cll_destroy(handler->lifo);
 
-	mm_free(handler);
+	memcpy(&hmm, &handler->_mm, sizeof(struct pall_mm));
+
+	mm_free_with(&hmm, handler);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct lifo_handler *pall_lifo_init(
+		void (*destroy) (void *data),
+		int (*ser_data) (pall_fd_t fd, void *data),
+		void *(*unser_data) (pall_fd_t fd))
+{
+	return pall_lifo_init_mm(destroy, ser_data, unser_data, NULL);
 }
 
 #ifdef COMPILE_WIN32
@@ -153,6 +184,13 @@ int pall_lifo_push(struct lifo_handler *h, void *data) {
 	return h->push(h, data);
 }
 
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_lifo_push_batch(struct lifo_handler *h, void **data, ui32_t count) {
+	return h->push_batch(h, data, count);
+}
+
 #ifdef COMPILE_WIN32
 DLLIMPORT
 #endif
@@ -25,14 +25,27 @@
  */
 
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
 
 #include "config.h"
+#include "mm.h"
 
 #ifdef USE_LIBFSMA
  #include <fsma/fsma.h>
 #endif
 
-void *mm_alloc(size_t size) {
+union mm_pool_chunk {
+	union mm_pool_chunk *next;
+
+	/* Ensure that objects following the chunk header are properly aligned */
+	long double _align_ld;
+	long _align_l;
+	void *_align_p;
+};
+
+static void *_mm_lib_alloc(void *ctx, size_t size) {
 	return
 #ifdef USE_LIBFSMA
 	fsma_malloc(size);
@@ -41,7 +54,7 @@ void *mm_alloc(size_t size) {
 #endif
 }
 
-void mm_free(void *ptr) {
+static void _mm_lib_free(void *ctx, void *ptr) {
 #ifdef USE_LIBFSMA
 	fsma_free(ptr);
 #else
@@ -49,7 +62,7 @@ void mm_free(void *ptr) {
 #endif
 }
 
-void *mm_realloc(void *ptr, size_t size) {
+static void *_mm_lib_realloc(void *ctx, void *ptr, size_t size) {
 	return
 #ifdef USE_LIBFSMA
 	fsma_realloc(ptr, size);
@@ -58,7 +71,7 @@ void *mm_realloc(void *ptr, size_t size) {
 #endif
 }
 
-void *mm_calloc(size_t nmemb, size_t size) {
+static void *_mm_lib_calloc(void *ctx, size_t nmemb, size_t size) {
 	return
 #ifdef USE_LIBFSMA
 	fsma_calloc(nmemb, size);
@@ -67,3 +80,265 @@ void *mm_calloc(size_t nmemb, size_t size) {
 #endif
 }
 
+static struct pall_mm _mm_default = {
+	&_mm_lib_alloc,
+	&_mm_lib_free,
+	&_mm_lib_realloc,
+	&_mm_lib_calloc,
+	NULL
+};
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_mm_set_allocator(const struct pall_mm *mm) {
+	if (!mm) {
+		_mm_default.alloc = &_mm_lib_alloc;
+		_mm_default.free = &_mm_lib_free;
+		_mm_default.realloc = &_mm_lib_realloc;
+		_mm_default.calloc = &_mm_lib_calloc;
+		_mm_default.ctx = NULL;
+
+		return 0;
+	}
+
+	if (!mm->alloc || !mm->free) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	memcpy(&_mm_default, mm, sizeof(struct pall_mm));
+
+	return 0;
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+const struct pall_mm *pall_mm_get_allocator(void) {
+	return &_mm_default;
+}
+
+void mm_copy(struct pall_mm *dst, const struct pall_mm *src) {
+	memcpy(dst, src ? src : &_mm_default, sizeof(struct pall_mm));
+}
+
+void *mm_alloc_with(const struct pall_mm *mm, size_t size) {
+	return mm->alloc(mm->ctx, size);
+}
+
+void mm_free_with(const struct pall_mm *mm, void *ptr) {
+	mm->free(mm->ctx, ptr);
+}
+
+void *mm_realloc_with(const struct pall_mm *mm, void *ptr, size_t size) {
+	if (!mm->realloc) {
+		errno = ENOSYS;
+		return NULL;
+	}
+
+	return mm->realloc(mm->ctx, ptr, size);
+}
+
+void *mm_resize_with(const struct pall_mm *mm, void *ptr, size_t old_size, size_t size) {
+	void *p = NULL;
+
+	if (mm->realloc)
+		return mm->realloc(mm->ctx, ptr, size);
+
+	/* Allocators without realloc() are resized by copy */
+	if (!(p = mm->alloc(mm->ctx, size)))
+		return NULL;
+
+	memcpy(p, ptr, old_size < size ? old_size : size);
+
+	mm->free(mm->ctx, ptr);
+
+	return p;
+}
+
+void *mm_calloc_with(const struct pall_mm *mm, size_t nmemb, size_t size) {
+	void *ptr = NULL;
+
+	if (mm->calloc)
+		return mm->calloc(mm->ctx, nmemb, size);
+
+	if (size && (nmemb > ((size_t) ~0) / size)) {
+		errno = ENOMEM;
+		return NULL;
+	}
+
+	if ((ptr = mm->alloc(mm->ctx, nmemb * size)))
+		memset(ptr, 0, nmemb * size);
+
+	return ptr;
+}
+
+void *mm_alloc(size_t size) {
+	return mm_alloc_with(&_mm_default, size);
+}
+
+void mm_free(void *ptr) {
+	mm_free_with(&_mm_default, ptr);
+}
+
+void *mm_realloc(void *ptr, size_t size) {
+	return mm_realloc_with(&_mm_default, ptr, size);
+}
+
+void *mm_calloc(size_t nmemb, size_t size) {
+	return mm_calloc_with(&_mm_default, nmemb, size);
+}
+
+void mm_pool_init(
+		struct mm_pool *pool,
+		const struct pall_mm *mm,
+		size_t size,
+		size_t nmemb,
+		size_t nmemb_max)
+{
+	memset(pool, 0, sizeof(struct mm_pool));
+
+	pool->mm = mm;
+
+	/* Objects must be able to hold a free list pointer and keep alignment */
+	if (size < sizeof(void *))
+		size = sizeof(void *);
+
+	pool->size = (size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+	pool->nmemb = nmemb ? nmemb : 1;
+	pool->nmemb_max = nmemb_max > pool->nmemb ? nmemb_max : pool->nmemb;
+}
+
+void mm_pool_align(struct mm_pool *pool, size_t align) {
+	pool->align = align;
+}
+
+static void *_mm_pool_chunk_new(struct mm_pool *pool, size_t size) {
+	union mm_pool_chunk *chunk = NULL;
+	char *ptr = NULL;
+
+	/* Aligned pools over-allocate, so that objects can start at the next
+	 * boundary past the chunk header.
+	 */
+	if (!(chunk = (union mm_pool_chunk *) mm_alloc_with(pool->mm, sizeof(union mm_pool_chunk) + size + pool->align)))
+		return NULL;
+
+	chunk->next = (union mm_pool_chunk *) pool->chunks;
+	pool->chunks = chunk;
+
+	ptr = (char *) (chunk + 1);
+
+	if (pool->align)
+		ptr += (pool->align - (((uintptr_t) ptr) & (pool->align - 1))) & (pool->align - 1);
+
+	return ptr;
+}
+
+static int _mm_pool_grow(struct mm_pool *pool) {
+	char *ptr = NULL;
+
+	if (!(ptr = (char *) _mm_pool_chunk_new(pool, pool->size * pool->nmemb)))
+		return -1;
+
+	pool->cur = ptr;
+	pool->end = ptr + (pool->size * pool->nmemb);
+
+	/* Grow geometrically so that large lists need only a few chunks */
+	if ((pool->nmemb << 1) <= pool->nmemb_max)
+		pool->nmemb <<= 1;
+
+	return 0;
+}
+
+void *mm_pool_alloc(struct mm_pool *pool) {
+	void *ptr = NULL;
+
+	if (pool->free_list) {
+		ptr = pool->free_list;
+		pool->free_list = *(void **) ptr;
+
+		return ptr;
+	}
+
+	if (((size_t) (pool->end - pool->cur)) < pool->size) {
+		if (_mm_pool_grow(pool) < 0)
+			return NULL;
+	}
+
+	ptr = pool->cur;
+	pool->cur += pool->size;
+
+	return ptr;
+}
+
+void *mm_pool_alloc_block(struct mm_pool *pool, size_t nmemb) {
+	void *ptr = NULL;
+	size_t size = pool->size * nmemb;
+
+	if (nmemb > (((size_t) -1) / pool->size)) {
+		errno = ENOMEM;
+		return NULL;
+	}
+
+	/* A contiguous run of objects, each of which can later be released
+	 * through mm_pool_free(). Runs larger than the next chunk get a chunk of
+	 * their own.
+	 */
+	if (((size_t) (pool->end - pool->cur)) < size) {
+		if (nmemb > pool->nmemb)
+			return _mm_pool_chunk_new(pool, size);
+
+		if (_mm_pool_grow(pool) < 0)
+			return NULL;
+	}
+
+	ptr = pool->cur;
+	pool->cur += size;
+
+	return ptr;
+}
+
+void *mm_pool_alloc_size(struct mm_pool *pool, size_t size) {
+	size_t align = sizeof(union mm_pool_chunk);
+	size_t pad = 0;
+	void *ptr = NULL;
+
+	size = size ? (((size + align - 1) / align) * align) : align;
+
+	/* Objects larger than the next chunk get a chunk of their own */
+	if (size > (pool->size * pool->nmemb))
+		return _mm_pool_chunk_new(pool, size);
+
+	if (pool->cur != pool->end)
+		pad = (align - (((uintptr_t) pool->cur) % align)) % align;
+
+	if (((size_t) (pool->end - pool->cur)) < (pad + size)) {
+		if (_mm_pool_grow(pool) < 0)
+			return NULL;
+
+		pad = 0;
+	}
+
+	ptr = pool->cur + pad;
+	pool->cur += pad + size;
+
+	return ptr;
+}
+
+void mm_pool_free(struct mm_pool *pool, void *ptr) {
+	*(void **) ptr = pool->free_list;
+	pool->free_list = ptr;
+}
+
+void mm_pool_release(struct mm_pool *pool) {
+	union mm_pool_chunk *chunk = (union mm_pool_chunk *) pool->chunks, *next = NULL;
+
+	for (; chunk; chunk = next) {
+		next = chunk->next;
+		mm_free_with(pool->mm, chunk);
+	}
+
+	memset(pool, 0, sizeof(struct mm_pool));
+}
+
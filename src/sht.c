@@ -0,0 +1,680 @@
+/**
+ * @file sht.c
+ * @brief Portable Abstracted Linked Lists Library (libpall)
+ *        Swiss Hash Table interface
+ *
+ * Date: 16-10-2026
+ *
+ * Copyright 2026 Pedro A. Hortas (pah@ucodev.org)
+ *
+ * This file is part of libpall.
+ *
+ * libpall is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libpall is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libpall.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#include "config.h"
+#include "mm.h"
+#include "pall.h"
+#include "sht.h"
+#include "hash.h"
+
+#if !defined(COMPILE_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+ #define SHT_GROUP_SSE2 1
+ #include <emmintrin.h>
+#endif
+
+/* Group operations. Each returns a mask with bit 'i' set if the control byte
+ * 'i' of the group pointed by 'ctrl' matches.
+ */
+#ifdef SHT_GROUP_SSE2
+static ui32_t _sht_group_match(const unsigned char *ctrl, unsigned char tag) {
+	__m128i group = _mm_loadu_si128((const __m128i *) ctrl);
+
+	return (ui32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char) tag)));
+}
+
+static ui32_t _sht_group_free(const unsigned char *ctrl) {
+	/* Empty and deleted slots are the only ones with the high bit set */
+	return (ui32_t) _mm_movemask_epi8(_mm_loadu_si128((const __m128i *) ctrl));
+}
+#elif defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define SHT_SWAR_LSB	0x0101010101010101ULL
+#define SHT_SWAR_MSB	0x8080808080808080ULL
+
+/* Gathers the high bit of each byte of 'mask' into the low 8 bits */
+static ui32_t _sht_swar_pack(unsigned long long mask) {
+	return (ui32_t) (((mask >> 7) * 0x0102040810204080ULL) >> 56);
+}
+
+static ui32_t _sht_group_match(const unsigned char *ctrl, unsigned char tag) {
+	unsigned long long word[2], x = 0;
+	ui32_t mask = 0;
+	int i = 0;
+
+	memcpy(word, ctrl, sizeof(word));
+
+	/* Matches may be over-reported for a byte following a matching one,
+	 * which is harmless since every match is confirmed by compare().
+	 */
+	for (i = 0; i < 2; i ++) {
+		x = word[i] ^ (SHT_SWAR_LSB * tag);
+		mask |= _sht_swar_pack((x - SHT_SWAR_LSB) & ~x & SHT_SWAR_MSB) << (i * 8);
+	}
+
+	return mask;
+}
+
+static ui32_t _sht_group_free(const unsigned char *ctrl) {
+	unsigned long long word[2];
+
+	memcpy(word, ctrl, sizeof(word));
+
+	return _sht_swar_pack(word[0] & SHT_SWAR_MSB) | (_sht_swar_pack(word[1] & SHT_SWAR_MSB) << 8);
+}
+#else
+static ui32_t _sht_group_match(const unsigned char *ctrl, unsigned char tag) {
+	int i = 0;
+	ui32_t mask = 0;
+
+	for (i = 0; i < SHT_GROUP_SIZE; i ++) {
+		if (ctrl[i] == tag)
+			mask |= 1U << i;
+	}
+
+	return mask;
+}
+
+static ui32_t _sht_group_free(const unsigned char *ctrl) {
+	int i = 0;
+	ui32_t mask = 0;
+
+	for (i = 0; i < SHT_GROUP_SIZE; i ++) {
+		if (ctrl[i] & 0x80)
+			mask |= 1U << i;
+	}
+
+	return mask;
+}
+#endif
+
+static ui32_t _sht_group_empty(const unsigned char *ctrl) {
+	return _sht_group_match(ctrl, SHT_CTRL_EMPTY);
+}
+
+static ui32_t _sht_ctz(ui32_t mask) {
+#if defined(__GNUC__)
+	return (ui32_t) __builtin_ctz(mask);
+#else
+	ui32_t n = 0;
+
+	for (n = 0; !(mask & 1); n ++)
+		mask >>= 1;
+
+	return n;
+#endif
+}
+
+static ui32_t _sht_hash(struct sht_handler *handler, void *data) {
+	return hash_fmix32(handler->hash(data));
+}
+
+static unsigned char _sht_tag(ui32_t hash) {
+	return (unsigned char) (hash & 0x7f);
+}
+
+static ui32_t _sht_lookup(struct sht_handler *handler, void *data) {
+	ui32_t hash = 0, gmask = (handler->arr_size / SHT_GROUP_SIZE) - 1, g = 0, i = 0, mask = 0, pos = 0;
+	unsigned char tag = 0;
+
+	if (!handler->compare)
+		return handler->arr_size;
+
+	hash = _sht_hash(handler, data);
+	tag = _sht_tag(hash);
+
+	/* Triangular probing over a power of two number of groups visits every
+	 * group, and the load factor guarantees that some group has an empty slot.
+	 */
+	for (g = (hash >> 7) & gmask; ; g = (g + ++ i) & gmask) {
+		for (mask = _sht_group_match(&handler->ctrl[g * SHT_GROUP_SIZE], tag); mask; mask &= mask - 1) {
+			pos = (g * SHT_GROUP_SIZE) + _sht_ctz(mask);
+
+			if (!handler->compare(data, handler->array[pos]))
+				return pos;
+		}
+
+		if (_sht_group_empty(&handler->ctrl[g * SHT_GROUP_SIZE]))
+			break;
+	}
+
+	return handler->arr_size;
+}
+
+static ui32_t _sht_find_free(const unsigned char *ctrl, ui32_t size, ui32_t hash) {
+	ui32_t gmask = (size / SHT_GROUP_SIZE) - 1, g = 0, i = 0, mask = 0;
+
+	for (g = (hash >> 7) & gmask; !(mask = _sht_group_free(&ctrl[g * SHT_GROUP_SIZE])); g = (g + ++ i) & gmask)
+		;
+
+	return (g * SHT_GROUP_SIZE) + _sht_ctz(mask);
+}
+
+static void *_sht_remove(struct sht_handler *handler, ui32_t pos) {
+	void *data = handler->array[pos];
+
+	/* A group that still has an empty slot never caused a probe to move on to
+	 * the next group, so the slot can be emptied. Otherwise some element may
+	 * be reachable only by probing past this group.
+	 */
+	if (_sht_group_empty(&handler->ctrl[pos & ~(ui32_t) (SHT_GROUP_SIZE - 1)])) {
+		handler->ctrl[pos] = SHT_CTRL_EMPTY;
+	} else {
+		handler->ctrl[pos] = SHT_CTRL_DELETED;
+		handler->_deleted ++;
+	}
+
+	handler->array[pos] = NULL;
+	handler->_count --;
+
+	return data;
+}
+
+static int _sht_rehash(struct sht_handler *handler, ui32_t size) {
+	ui32_t i = 0, pos = 0, hash = 0;
+	void **array = NULL;
+	unsigned char *ctrl = NULL;
+
+	if (!(array = (void **) mm_calloc_with(&handler->_mm, size, sizeof(void *))))
+		return -1;
+
+	if (!(ctrl = (unsigned char *) mm_alloc_with(&handler->_mm, size))) {
+		mm_free_with(&handler->_mm, array);
+		return -1;
+	}
+
+	memset(ctrl, SHT_CTRL_EMPTY, size);
+
+	for (i = 0; i < handler->arr_size; i ++) {
+		if (handler->ctrl[i] & 0x80)
+			continue;
+
+		hash = _sht_hash(handler, handler->array[i]);
+		pos = _sht_find_free(ctrl, size, hash);
+
+		ctrl[pos] = _sht_tag(hash);
+		array[pos] = handler->array[i];
+	}
+
+	mm_free_with(&handler->_mm, handler->array);
+	mm_free_with(&handler->_mm, handler->ctrl);
+
+	if (size > handler->arr_size)
+		handler->_stat.grow ++;
+
+	handler->_stat.rehash ++;
+
+	handler->array = array;
+	handler->ctrl = ctrl;
+	handler->arr_size = size;
+	handler->_deleted = 0;
+
+	return 0;
+}
+
+static int _sht_reserve(struct sht_handler *handler) {
+	ui32_t size = handler->arr_size;
+
+	if (((handler->_count + handler->_deleted + 1) * (unsigned long) SHT_LOAD_FACTOR_DEN) <= (size * (unsigned long) SHT_LOAD_FACTOR_NUM))
+		return 0;
+
+	/* Deleted slots are reclaimed in place only if they make up at least
+	 * half of the load, so that rebuilds don't repeat on every insertion.
+	 */
+	if (((handler->_count + 1) * (unsigned long) SHT_LOAD_FACTOR_DEN * 2) > (size * (unsigned long) SHT_LOAD_FACTOR_NUM)) {
+		if (!(size <<= 1)) {
+			errno = ERANGE;
+			return -1;
+		}
+	}
+
+	return _sht_rehash(handler, size);
+}
+
+static int _sht_insert(struct sht_handler *handler, void *data) {
+	ui32_t hash = 0, pos = 0;
+
+	if (!data) {
+		handler->_stat.insert_err ++;
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (_sht_reserve(handler) < 0) {
+		handler->_stat.insert_err ++;
+		return -1;
+	}
+
+	hash = _sht_hash(handler, data);
+	pos = _sht_find_free(handler->ctrl, handler->arr_size, hash);
+
+	if (handler->ctrl[pos] == SHT_CTRL_DELETED)
+		handler->_deleted --;
+
+	handler->ctrl[pos] = _sht_tag(hash);
+	handler->array[pos] = data;
+
+	handler->_count ++;
+
+	handler->_stat.insert ++;
+
+	if (handler->_stat.elem_count_max < handler->_count)
+		handler->_stat.elem_count_max = handler->_count;
+
+	return 0;
+}
+
+static int _sht_delete(struct sht_handler *handler, void *data) {
+	ui32_t pos = 0;
+
+	if ((pos = _sht_lookup(handler, data)) == handler->arr_size) {
+		handler->_stat.del_nf ++;
+		return -1;
+	}
+
+	handler->destroy(_sht_remove(handler, pos));
+
+	handler->_stat.del ++;
+
+	return 0;
+}
+
+static void *_sht_search(struct sht_handler *handler, void *data) {
+	ui32_t pos = 0;
+
+	if ((pos = _sht_lookup(handler, data)) == handler->arr_size) {
+		handler->_stat.search_nf ++;
+		return NULL;
+	}
+
+	handler->_stat.search ++;
+
+	return handler->array[pos];
+}
+
+static ui32_t _sht_count(struct sht_handler *handler) {
+	handler->_stat.count ++;
+
+	return handler->_count;
+}
+
+static int _sht_serialize(struct sht_handler *handler, pall_fd_t fd) {
+	ui32_t i = 0;
+	ui32_t count_nbo = pall_htonl(handler->_count);
+
+	if (!handler->ser_data) {
+		handler->_stat.serialize_err ++;
+		errno = ENOSYS;
+		return -1;
+	}
+
+	if (pall_write(fd, &count_nbo, 4) != 4) {
+		handler->_stat.serialize_err ++;
+		return -1;
+	}
+
+	for (i = 0; i < handler->arr_size; i ++) {
+		if (handler->ctrl[i] & 0x80)
+			continue;
+
+		if (handler->ser_data(fd, handler->array[i]) < 0) {
+			handler->_stat.serialize_err ++;
+			return -1;
+		}
+	}
+
+	handler->_stat.serialize ++;
+
+	return 0;
+}
+
+static int _sht_unserialize(struct sht_handler *handler, pall_fd_t fd) {
+	ui32_t count = 0;
+	void *data = NULL;
+
+	if (!handler->unser_data) {
+		handler->_stat.unserialize_err ++;
+		errno = ENOSYS;
+		return -1;
+	}
+
+	if (pall_read(fd, &count, 4) != 4) {
+		handler->_stat.unserialize_err ++;
+		return -1;
+	}
+
+	for (count = ntohl(count); count; count --) {
+		if (!(data = handler->unser_data(fd))) {
+			handler->_stat.unserialize_err ++;
+			return -1;
+		}
+
+		if (handler->insert(handler, data) < 0) {
+			handler->_stat.unserialize_err ++;
+			return -1;
+		}
+	}
+
+	handler->_stat.unserialize ++;
+
+	return 0;
+}
+
+static struct sht_stat *_sht_stat(struct sht_handler *handler) {
+	ui32_t i = 0, gmask = (handler->arr_size / SHT_GROUP_SIZE) - 1, g = 0;
+	unsigned long len = 0, total = 0;
+
+	handler->_stat.elem_count_cur = handler->_count;
+	handler->_stat.elem_deleted = handler->_deleted;
+	handler->_stat.probe_len_max = 0;
+
+	for (i = 0; i < handler->arr_size; i ++) {
+		if (handler->ctrl[i] & 0x80)
+			continue;
+
+		/* Walk the probe sequence from the home group of the element */
+		for (g = (_sht_hash(handler, handler->array[i]) >> 7) & gmask, len = 0; g != (i / SHT_GROUP_SIZE); g = (g + ++ len) & gmask)
+			;
+
+		if (len > handler->_stat.probe_len_max)
+			handler->_stat.probe_len_max = len;
+
+		total += len;
+	}
+
+	handler->_stat.probe_len_avg = handler->_count ? (total / (float) handler->_count) : 0;
+
+	handler->_stat.stat ++;
+
+	return &handler->_stat;
+}
+
+static void _sht_stat_reset(struct sht_handler *handler) {
+	memset(&handler->_stat, 0, sizeof(struct sht_stat));
+}
+
+static void *_sht_pope(struct sht_handler *handler, void *data) {
+	ui32_t pos = 0;
+
+	if ((pos = _sht_lookup(handler, data)) == handler->arr_size) {
+		handler->_stat.pope_nf ++;
+		return NULL;
+	}
+
+	handler->_stat.pope ++;
+
+	return _sht_remove(handler, pos);
+}
+
+static void _sht_collapse(struct sht_handler *handler) {
+	ui32_t i = 0;
+
+	for (i = 0; i < handler->arr_size; i ++) {
+		if (!(handler->ctrl[i] & 0x80))
+			handler->destroy(handler->array[i]);
+	}
+
+	memset(handler->array, 0, handler->arr_size * sizeof(void *));
+	memset(handler->ctrl, SHT_CTRL_EMPTY, handler->arr_size);
+
+	handler->_count = 0;
+	handler->_deleted = 0;
+	handler->_iterate_arr_pos = 0;
+
+	handler->_stat.collapse ++;
+}
+
+static void *_sht_iterate(struct sht_handler *handler) {
+	ui32_t pos = 0;
+
+	while (handler->_iterate_arr_pos < handler->arr_size) {
+		pos = handler->_iterate_arr_pos;
+
+		/* Reverse iterations end past the last slot as well */
+		if (handler->_iterate_reverse) {
+			handler->_iterate_arr_pos = handler->_iterate_arr_pos ? handler->_iterate_arr_pos - 1 : handler->arr_size;
+		} else {
+			handler->_iterate_arr_pos ++;
+		}
+
+		if (!(handler->ctrl[pos] & 0x80))
+			return handler->array[pos];
+	}
+
+	handler->_stat.iterate ++;
+
+	return NULL;
+}
+
+static void _sht_rewind(struct sht_handler *handler, int to) {
+	handler->_iterate_reverse = to;
+
+	if (to) {
+		handler->_iterate_arr_pos = handler->arr_size - 1;
+	} else {
+		handler->_iterate_arr_pos = 0;
+	}
+
+	handler->_stat.rewind ++;
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct sht_handler *pall_sht_init_mm(
+		int (*compare) (const void *d1, const void *d2),
+		void (*destroy) (void *data),
+		ui32_t (*hash) (void *data),
+		int (*ser_data) (pall_fd_t fd, void *data),
+		void *(*unser_data) (pall_fd_t fd),
+		unsigned int array_size,
+		const struct pall_mm *mm)
+{
+	int errsv = 0;
+	ui32_t size = 0;
+	struct sht_handler *handler = NULL;
+	struct pall_mm hmm;
+
+	if (!hash || !destroy || (mm && (!mm->alloc || !mm->free))) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	if (!array_size)
+		array_size = SHT_DEFAULT_ARR_SIZE;
+
+	if (!(size = hash_pow2_ceil(array_size < SHT_MIN_ARR_SIZE ? SHT_MIN_ARR_SIZE : array_size))) {
+		errno = ERANGE;
+		return NULL;
+	}
+
+	mm_copy(&hmm, mm);
+
+	if (!(handler = (struct sht_handler *) mm_alloc_with(&hmm, sizeof(struct sht_handler))))
+		return NULL;
+
+	memset(handler, 0, sizeof(struct sht_handler));
+
+	memcpy(&handler->_mm, &hmm, sizeof(struct pall_mm));
+
+	handler->arr_size = size;
+	handler->_iterate_arr_pos = 0;
+
+	handler->compare = compare;
+	handler->hash = hash;
+	handler->destroy = destroy;
+	handler->ser_data = ser_data;
+	handler->unser_data = unser_data;
+
+	handler->insert = &_sht_insert;
+	handler->del = &_sht_delete;
+	handler->search = &_sht_search;
+	handler->serialize = &_sht_serialize;
+	handler->unserialize = &_sht_unserialize;
+	handler->stat = &_sht_stat;
+	handler->stat_reset = &_sht_stat_reset;
+	handler->count = &_sht_count;
+	handler->pope = &_sht_pope;
+	handler->collapse = &_sht_collapse;
+	handler->iterate = &_sht_iterate;
+	handler->rewind = &_sht_rewind;
+
+	if (!(handler->array = (void **) mm_calloc_with(&hmm, handler->arr_size, sizeof(void *)))) {
+		errsv = errno;
+		mm_free_with(&hmm, handler);
+		errno = errsv;
+		return NULL;
+	}
+
+	if (!(handler->ctrl = (unsigned char *) mm_alloc_with(&hmm, handler->arr_size))) {
+		errsv = errno;
+		mm_free_with(&hmm, handler->array);
+		mm_free_with(&hmm, handler);
+		errno = errsv;
+		return NULL;
+	}
+
+	memset(handler->ctrl, SHT_CTRL_EMPTY, handler->arr_size);
+
+	return handler;
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct sht_handler *pall_sht_init(
+		int (*compare) (const void *d1, const void *d2),
+		void (*destroy) (void *data),
+		ui32_t (*hash) (void *data),
+		int (*ser_data) (pall_fd_t fd, void *data),
+		void *(*unser_data) (pall_fd_t fd),
+		unsigned int array_size)
+{
+	return pall_sht_init_mm(compare, destroy, hash, ser_data, unser_data, array_size, NULL);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_sht_destroy(struct sht_handler *h) {
+	struct pall_mm hmm;
+
+	h->collapse(h);
+
+	memcpy(&hmm, &h->_mm, sizeof(struct pall_mm));
+
+	mm_free_with(&hmm, h->array);
+	mm_free_with(&hmm, h->ctrl);
+	mm_free_with(&hmm, h);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_sht_insert(struct sht_handler *h, void *data) {
+	return h->insert(h, data);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_sht_delete(struct sht_handler *h, void *data) {
+	return h->del(h, data);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_sht_search(struct sht_handler *h, void *data) {
+	return h->search(h, data);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_sht_serialize(struct sht_handler *h, pall_fd_t fd) {
+	return h->serialize(h, fd);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+int pall_sht_unserialize(struct sht_handler *h, pall_fd_t fd) {
+	return h->unserialize(h, fd);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+struct sht_stat *pall_sht_stat(struct sht_handler *h) {
+	return h->stat(h);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_sht_stat_reset(struct sht_handler *h) {
+	h->stat_reset(h);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+ui32_t pall_sht_count(struct sht_handler *h) {
+	return h->count(h);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_sht_pope(struct sht_handler *h, void *data) {
+	return h->pope(h, data);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_sht_collapse(struct sht_handler *h) {
+	h->collapse(h);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void *pall_sht_iterate(struct sht_handler *h) {
+	return h->iterate(h);
+}
+
+#ifdef COMPILE_WIN32
+DLLIMPORT
+#endif
+void pall_sht_rewind(struct sht_handler *h, int to) {
+	h->rewind(h, to);
+}
+